@@ -7,7 +7,7 @@ LGFX::LGFX(void)
 {
   {
     auto cfg = _bus_instance.config();
-    cfg.freq_write = 10000000;  // Reduced to 10MHz for stability
+    cfg.freq_write = 10000000;  // Standaard; write_frequency in YAML overschrijft dit
     cfg.pin_wr = 47;
     cfg.pin_rd = -1;
     cfg.pin_rs = 0;
@@ -71,6 +71,7 @@ LGFX::LGFX(void)
     cfg.y_max = 479;
     cfg.pin_int = 7;
     cfg.bus_shared = true;
+    // Ruwe coordinaten in portrait; getTouch draait ze mee met setRotation van het paneel
     cfg.offset_rotation = 0;
 
     cfg.i2c_port = 1;
@@ -85,5 +86,24 @@ LGFX::LGFX(void)
   setPanel(&_panel_instance);
 }
 
+void LGFX::set_write_frequency(uint32_t freq)
+{
+  auto cfg = _bus_instance.config();
+  cfg.freq_write = freq;
+  _bus_instance.config(cfg);
+}
+
+uint32_t LGFX::get_write_frequency() const
+{
+  return _bus_instance.config().freq_write;
+}
+
+void LGFX::set_read_pin(int8_t pin)
+{
+  auto cfg = _bus_instance.config();
+  cfg.pin_rd = pin;
+  _bus_instance.config(cfg);
+}
+
 }  // namespace hd_device
 }  // namespace esphome
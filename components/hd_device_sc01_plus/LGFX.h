@@ -18,6 +18,12 @@ class LGFX : public lgfx::LGFX_Device
 
 public:
   LGFX(void);
+
+  // Alleen voor begin() of tussen releaseBus() en initBus(): kloksnelheid van de 8080 bus
+  void set_write_frequency(uint32_t freq);
+  uint32_t get_write_frequency() const;
+  // RD pin van de bus, nodig om het paneel terug te lezen; -1 als die niet aangesloten is
+  void set_read_pin(int8_t pin);
 };
 
 }  // namespace hd_device
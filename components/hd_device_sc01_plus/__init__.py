@@ -4,14 +4,46 @@ import esphome.codegen as cg
 import esphome.config_validation as cv
 import esphome.core as core
 import esphome.core.config as cfg
+from esphome import pins
+from esphome.components import sensor
 from esphome.core import CORE, coroutine_with_priority
 from esphome.const import (
     CONF_ID,
-    CONF_BRIGHTNESS
+    CONF_BRIGHTNESS,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    UNIT_MILLISECOND,
+    UNIT_PERCENT,
 )
 
+AUTO_LOAD = ["sensor"]
+
 # Custom configuratiesleutel voor Todoist API-toegang
 CONF_TODOIST_API_KEY = "todoist_api_key"
+# Hoogte van de LVGL draw buffers in lijnen (er worden er twee gealloceerd)
+CONF_BUFFER_LINES = "buffer_lines"
+# Orientatie van het scherm, gedraaid door het paneel zelf (MADCTL) in plaats van door LVGL
+CONF_ORIENTATION = "orientation"
+# Landscape zoals voorheen: paneel in portrait, LVGL roteert in software (trager, zonder DMA).
+# Standaard aan in landscape, tot de panel rotatie op hardware is nagemeten; zet hem uit om de
+# panel rotatie te gebruiken. De opstartlog meet beide wegen.
+CONF_SOFTWARE_ROTATION = "software_rotation"
+# Orientatie -> LovyanGFX rotatie. Landscape (3) is afgeleid als de stand die LVGL eerder met
+# LV_DISP_ROT_90 gaf, maar niet op hardware nagemeten; software_rotation geeft de oude weg terug.
+ORIENTATIONS = {
+    "portrait": 0,
+    "landscape_inverted": 1,
+    "portrait_inverted": 2,
+    "landscape": 3,
+}
+# Kloksnelheid van de 8080 bus naar het paneel, optioneel automatisch opgevoerd bij het opstarten.
+# Auto-tune leest testpatronen terug en heeft daarvoor de RD pin van het paneel nodig.
+CONF_WRITE_FREQUENCY = "write_frequency"
+CONF_AUTO_TUNE = "auto_tune"
+CONF_READ_PIN = "read_pin"
+# Prestatie metrics: optionele sensors en een overlay op het scherm
+CONF_METRICS = "metrics"
+CONF_OVERLAY = "overlay"
 
 # Definieert wie verantwoordelijk is voor dit component in het ESPHome project
 CODEOWNERS = ["@strange-v"]
@@ -19,19 +51,79 @@ CODEOWNERS = ["@strange-v"]
 # Codegennamespace voor het component wordt gedefinieerd
 hd_device_ns = cg.esphome_ns.namespace("hd_device")
 HaDeckDevice = hd_device_ns.class_("HaDeckDevice", cg.Component)
+Metric = hd_device_ns.enum("Metric")
+
+# Sensor sleutel -> (Metric, eenheid, decimalen)
+METRIC_SENSORS = {
+    "fps": (Metric.METRIC_FPS, "FPS", 1),
+    "render_time": (Metric.METRIC_RENDER_TIME, UNIT_MILLISECOND, 1),
+    "flush_time": (Metric.METRIC_FLUSH_TIME, UNIT_MILLISECOND, 2),
+    "bytes_per_frame": (Metric.METRIC_BYTES_PER_FRAME, "B", 0),
+    "timer_handler_time": (Metric.METRIC_TIMER_HANDLER_TIME, UNIT_MILLISECOND, 2),
+    "lvgl_heap_used": (Metric.METRIC_LVGL_HEAP_USED, UNIT_PERCENT, 0),
+    "lvgl_heap_max_used": (Metric.METRIC_LVGL_HEAP_MAX_USED, "B", 0),
+    "lvgl_heap_fragmentation": (Metric.METRIC_LVGL_HEAP_FRAGMENTATION, UNIT_PERCENT, 0),
+    "internal_heap_free": (Metric.METRIC_INTERNAL_HEAP_FREE, "B", 0),
+    "psram_free": (Metric.METRIC_PSRAM_FREE, "B", 0),
+    "request_latency": (Metric.METRIC_REQUEST_LATENCY, UNIT_MILLISECOND, 0),
+}
+
+METRICS_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_OVERLAY, default=False): cv.boolean,
+        **{
+            cv.Optional(key): sensor.sensor_schema(
+                unit_of_measurement=unit,
+                accuracy_decimals=decimals,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            )
+            for key, (_, unit, decimals) in METRIC_SENSORS.items()
+        },
+    }
+)
+
+# Auto-tune zonder RD pin kan niets teruglezen
+def validate_auto_tune(config):
+    if config[CONF_AUTO_TUNE] and CONF_READ_PIN not in config:
+        raise cv.Invalid(f"{CONF_AUTO_TUNE} needs {CONF_READ_PIN} to read back test patterns")
+    return config
+
+# Software rotatie bestaat alleen voor landscape, de enige stand van de oude code; daar is hij
+# standaard aan, in de andere orientaties uit
+def validate_software_rotation(config):
+    landscape = config[CONF_ORIENTATION] == "landscape"
+    if CONF_SOFTWARE_ROTATION not in config:
+        config[CONF_SOFTWARE_ROTATION] = landscape
+    elif config[CONF_SOFTWARE_ROTATION] and not landscape:
+        raise cv.Invalid(f"{CONF_SOFTWARE_ROTATION} only supports {CONF_ORIENTATION}: landscape")
+    return config
 
 # Schema voor de configuratie in YAML-bestanden
 # Hiermee kan de gebruiker het volgende configureren:
 # 1. Component ID (verplicht)
 # 2. Helderheid (optioneel, standaard 75%)
 # 3. Todoist API-sleutel (optioneel)
-CONFIG_SCHEMA = cv.Schema(
+# 4. Hoogte van de display buffers (optioneel, standaard 10 lijnen)
+# 5. Orientatie van het scherm en software rotatie (optioneel, standaard landscape door LVGL)
+# 6. Kloksnelheid van de bus, auto-tune en RD pin (optioneel, standaard 10MHz zonder auto-tune)
+# 7. Prestatie metrics als sensors en/of overlay (optioneel)
+CONFIG_SCHEMA = cv.All(cv.Schema(
     {
         cv.GenerateID(): cv.declare_id(HaDeckDevice),
         cv.Optional(CONF_BRIGHTNESS, default=75): cv.int_range(min=0, max=100),
         cv.Optional(CONF_TODOIST_API_KEY): cv.string,
+        cv.Optional(CONF_BUFFER_LINES, default=10): cv.int_range(min=1, max=320),
+        cv.Optional(CONF_ORIENTATION, default="landscape"): cv.enum(ORIENTATIONS, lower=True),
+        cv.Optional(CONF_SOFTWARE_ROTATION): cv.boolean,
+        cv.Optional(CONF_WRITE_FREQUENCY, default="10MHz"): cv.All(
+            cv.frequency, cv.Range(min=1e6, max=40e6)
+        ),
+        cv.Optional(CONF_AUTO_TUNE, default=False): cv.boolean,
+        cv.Optional(CONF_READ_PIN): pins.internal_gpio_output_pin_number,
+        cv.Optional(CONF_METRICS): METRICS_SCHEMA,
     }
-)
+), validate_auto_tune, validate_software_rotation)
 
 # Buildvlaggen voor de LVGL grafische bibliotheek
 LVGL_BUILD_FLAGS = [
@@ -63,6 +155,28 @@ async def to_code(config):
     if CONF_BRIGHTNESS in config:
         cg.add(var.set_brightness(config[CONF_BRIGHTNESS]))
     
+    # Configureren van de display buffer hoogte
+    cg.add(var.set_buffer_lines(config[CONF_BUFFER_LINES]))
+    
+    # Configureren van de orientatie
+    cg.add(var.set_rotation(config[CONF_ORIENTATION]))
+    cg.add(var.set_software_rotation(config[CONF_SOFTWARE_ROTATION]))
+    
+    # Configureren van de bus klok
+    cg.add(var.set_write_frequency(int(config[CONF_WRITE_FREQUENCY])))
+    cg.add(var.set_auto_tune(config[CONF_AUTO_TUNE]))
+    if CONF_READ_PIN in config:
+        cg.add(var.set_read_pin(config[CONF_READ_PIN]))
+    
+    # Configureren van de metrics sensors en overlay
+    if CONF_METRICS in config:
+        metrics_config = config[CONF_METRICS]
+        cg.add(var.set_metrics_overlay(metrics_config[CONF_OVERLAY]))
+        for key, (metric, _, _) in METRIC_SENSORS.items():
+            if key in metrics_config:
+                sens = await sensor.new_sensor(metrics_config[key])
+                cg.add(var.set_metric_sensor(metric, sens))
+    
     # Configureren van Todoist API-sleutel als die is opgegeven    
     if CONF_TODOIST_API_KEY in config:
         cg.add(var.set_todoist_api_key(config[CONF_TODOIST_API_KEY]))
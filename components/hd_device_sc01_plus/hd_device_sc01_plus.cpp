@@ -1,17 +1,28 @@
 #include "hd_device_sc01_plus.h"
+#include <algorithm>
+#include <cstring>
 
 namespace esphome {
 namespace hd_device {
 
 static const char *const TAG = "HD_DEVICE";
 static lv_disp_draw_buf_t draw_buf;
+static lv_disp_drv_t disp_drv;
 
-// Reduced display buffer size for LVGL to optimize memory usage
-// Buffer size reduced from 20 to 10 lines to decrease memory consumption
-static lv_color_t *buf = nullptr;
+// Twee DMA buffers: LVGL rendert in de ene terwijl de andere over de bus gaat
+static lv_color_t *buf1 = nullptr;
+static lv_color_t *buf2 = nullptr;
 
 LGFX lcd;
 
+// Hashes van het laatst gepushte beeld, en de hoogte in lijnen waarop de rounder uitlijnt
+static TileHashes tiles;
+static uint16_t tile_lines = 1;
+
+// Gebied linksboven voor de zelftest van de bus; wordt daarna door LVGL overschreven
+static const int32_t SELF_TEST_WIDTH = 32;
+static const int32_t SELF_TEST_LINES = 8;
+
 // LVGL log callback for debug information
 static void lvgl_log_cb(const char * buf) {
 #ifdef DEBUG_LVGL
@@ -20,25 +31,122 @@ static void lvgl_log_cb(const char * buf) {
 }
 
 /**
- * @brief Flush pixels to display - optimized for performance with IRAM_ATTR
+ * @brief Flush pixels to display - asynchronous DMA when color_p is one of our draw buffers
  * @param disp LVGL display driver
  * @param area Area to update
  * @param color_p Color data to write
  */
 void IRAM_ATTR flush_pixels(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p)
 {
+    uint32_t start = micros();
     uint32_t w = (area->x2 - area->x1 + 1);
     uint32_t h = (area->y2 - area->y1 + 1);
     uint32_t len = w * h;
 
-    lcd.startWrite();
-    lcd.setAddrWindow(area->x1, area->y1, w, h);
-    lcd.writePixels((uint16_t *)&color_p->full, len, true);
-    lcd.endWrite();
+    // De write transactie blijft open tussen flushes, zodat DMA door kan lopen
+    if (lcd.getStartCount() == 0) {
+        lcd.startWrite();
+    }
+
+    // Eerst wachten tot de vorige transfer klaar is; pas dan is die buffer weer vrij
+    lcd.waitDMA();
+    uint32_t dma_wait_us = micros() - start;
+
+    // Alleen de tegels die sinds de vorige flush veranderd zijn gaan over de bus; de rest van het
+    // gebied wordt weggeclipt, LovyanGFX houdt zelf de stride van de buffer bij
+    const std::vector<lv_area_t> &runs = tiles.diff(area, (const uint16_t *) &color_p->full);
+    bool whole = runs.size() == 1 && runs[0].x1 == area->x1 && runs[0].y1 == area->y1 &&
+                 runs[0].x2 == area->x2 && runs[0].y2 == area->y2;
+    bool dma = buf2 != nullptr && (color_p == buf1 || color_p == buf2);
+    uint32_t pixels = 0;
+    for (const lv_area_t &run : runs) {
+        pixels += (run.x2 - run.x1 + 1) * (run.y2 - run.y1 + 1);
+        if (!whole) {
+            lcd.setClipRect(run.x1, run.y1, run.x2 - run.x1 + 1, run.y2 - run.y1 + 1);
+        }
+        if (dma) {
+            // LVGL rendert nu in de andere buffer, dus flush_ready kan meteen. De volgende flush
+            // wacht hierboven tot deze transfer klaar is voordat LVGL deze buffer terugkrijgt.
+            lcd.pushImageDMA(area->x1, area->y1, w, h, (lgfx::swap565_t *)&color_p->full);
+        } else if (whole) {
+            // Enkele buffer: LVGL rendert pas verder na flush_ready, dus blokkerend
+            lcd.setAddrWindow(area->x1, area->y1, w, h);
+            lcd.writePixels((uint16_t *)&color_p->full, len, false);
+        } else {
+            lcd.pushImage(area->x1, area->y1, w, h, (lgfx::swap565_t *)&color_p->full);
+        }
+    }
+    if (!whole) {
+        lcd.clearClipRect();
+    }
 
+    metrics.record_flush(micros() - start, dma_wait_us, pixels * sizeof(lv_color_t));
     lv_disp_flush_ready(disp);
 }
 
+/**
+ * @brief Write test patterns to the top left of the panel and read them back
+ * @return true if every pattern came back unchanged
+ */
+static bool bus_self_test()
+{
+    static const uint16_t PAIRS[][2] = {{0x0000, 0xFFFF}, {0xAAAA, 0x5555}, {0xF0F0, 0x0F0F}};
+    static const uint8_t RANDOM_ROUNDS = 4;
+    static lgfx::rgb565_t pattern[SELF_TEST_WIDTH * SELF_TEST_LINES];
+    static lgfx::rgb565_t readback[SELF_TEST_WIDTH * SELF_TEST_LINES];
+    const size_t pixels = SELF_TEST_WIDTH * SELF_TEST_LINES;
+    const uint8_t rounds = sizeof(PAIRS) / sizeof(PAIRS[0]) + RANDOM_ROUNDS;
+
+    uint32_t seed = 0x12345678;
+    for (uint8_t round = 0; round < rounds; round++) {
+        // Eerst patronen waarbij elke datalijn bij elke byte wisselt, daarna pseudo-willekeurig
+        for (size_t i = 0; i < pixels; i++) {
+            if (round < sizeof(PAIRS) / sizeof(PAIRS[0])) {
+                pattern[i].raw = PAIRS[round][i & 1];
+            } else {
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                pattern[i].raw = seed;
+            }
+        }
+        lcd.pushImage(0, 0, SELF_TEST_WIDTH, SELF_TEST_LINES, pattern);
+        lcd.readRect(0, 0, SELF_TEST_WIDTH, SELF_TEST_LINES, readback);
+        if (memcmp(pattern, readback, sizeof(pattern)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Align invalidated areas to the tile grid, so whole tiles can be compared and skipped
+ */
+static void rounder_cb(lv_disp_drv_t *disp, lv_area_t *area)
+{
+    area->x1 = area->x1 / TILE_WIDTH * TILE_WIDTH;
+    area->x2 = area->x2 / TILE_WIDTH * TILE_WIDTH + TILE_WIDTH - 1;
+    area->y1 = area->y1 / tile_lines * tile_lines;
+    area->y2 = area->y2 / tile_lines * tile_lines + tile_lines - 1;
+}
+
+/**
+ * @brief Refresh timer of the display: coalesce the dirty areas first, then let LVGL refresh
+ */
+static void refr_timer_cb(lv_timer_t *timer)
+{
+    coalesce_dirty_areas((lv_disp_t *) timer->user_data);
+    _lv_disp_refr_timer(timer);
+}
+
+/**
+ * @brief Called by LVGL after every refresh, used for the frame metrics
+ */
+static void monitor_cb(lv_disp_drv_t *disp, uint32_t time, uint32_t px)
+{
+    metrics.record_frame(time);
+}
+
 /**
  * @brief Read touchpad input for LVGL
  * @param indev_driver Input device driver
@@ -62,12 +170,18 @@ void HaDeckDevice::setup() {
     // Log memory usage at startup
     ESP_LOGCONFIG(TAG, "Free memory at startup: %d bytes", esp_get_free_heap_size());
     
-    // Allocate display buffer with error handling
-    buf = (lv_color_t *)heap_caps_malloc(TFT_HEIGHT * 10 * sizeof(lv_color_t), MALLOC_CAP_DMA);
-    if (buf == nullptr) {
+    // Allocate display buffers with error handling
+    size_t buf_pixels = TFT_HEIGHT * buffer_lines_;
+    buf1 = (lv_color_t *)heap_caps_malloc(buf_pixels * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    if (buf1 == nullptr) {
         ESP_LOGE(TAG, "Failed to allocate display buffer. System halted.");
         return;
     }
+    buf2 = (lv_color_t *)heap_caps_malloc(buf_pixels * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    if (buf2 == nullptr) {
+        // Zonder tweede buffer werkt alles nog, alleen zonder overlap van renderen en flushen
+        ESP_LOGW(TAG, "Failed to allocate second display buffer, falling back to blocking flush");
+    }
     
     lv_init();
 #ifdef DEBUG_LVGL
@@ -79,6 +193,9 @@ void HaDeckDevice::setup() {
                           lv_palette_main(LV_PALETTE_RED), 
                           false, LV_FONT_DEFAULT);
 
+    lcd.set_write_frequency(write_frequency_);
+    lcd.set_read_pin(read_pin_);
+
     // Initialize display with retry mechanism
     int retry_count = 0;
     const int max_retries = 3;
@@ -87,7 +204,8 @@ void HaDeckDevice::setup() {
         if (lcd.begin()) {
             delay(100);  // Short delay after initialization
             lcd.setBrightness(128);  // Set to 50% brightness
-            lcd.setRotation(0);      // Ensure correct rotation
+            lcd.setRotation(panel_rotation_());  // MADCTL: het paneel draait, tenzij LVGL dat doet
+            lcd.initDMA();
             break;
         }
         ESP_LOGW(TAG, "Display initialization attempt %d failed, retrying...", retry_count + 1);
@@ -100,22 +218,41 @@ void HaDeckDevice::setup() {
         return;
     }
 
-    // Initialize display buffer with optimized size
-    lv_disp_draw_buf_init(&draw_buf, buf, nullptr, TFT_HEIGHT * 10);
+    if (auto_tune_) {
+        tune_write_frequency_();
+    }
+    measure_full_frame_flush_(buf_pixels);
+
+    // Initialize display buffers with the configured size
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, buf_pixels);
+    ESP_LOGCONFIG(TAG, "Display buffers: %u lines, %s", buffer_lines_, buf2 != nullptr ? "double buffered" : "single buffered");
+
+    // Na setRotation geeft LovyanGFX de afmetingen in de gekozen orientatie. Bij software rotatie
+    // staat het paneel in portrait en is het LVGL scherm (na LV_DISP_ROT_90) landscape.
+    uint16_t lvgl_width = software_rotation_ ? lcd.height() : lcd.width();
+    uint16_t lvgl_height = software_rotation_ ? lcd.width() : lcd.height();
+    ESP_LOGCONFIG(TAG, "Display orientation: %s rotation %u, %ux%u", software_rotation_ ? "LVGL software" : "panel",
+                  software_rotation_ ? 1 : rotation_, lvgl_width, lvgl_height);
+
+    // Tegels zo hoog mogelijk (max TILE_WIDTH lijnen), zolang een tegelrij over de volle breedte
+    // nog in de draw buffer past; anders kan LVGL een uitgelijnd gebied niet meer opdelen
+    while (tile_lines * 2 <= TILE_WIDTH && lvgl_width * tile_lines * 2 <= buf_pixels) {
+        tile_lines *= 2;
+    }
 
     // Configure display driver
-    static lv_disp_drv_t disp_drv;
     lv_disp_drv_init(&disp_drv);
-    disp_drv.hor_res = TFT_WIDTH;
-    disp_drv.ver_res = TFT_HEIGHT;
-    disp_drv.rotated = 1;  // TODO: Make this configurable for different orientations
-    disp_drv.sw_rotate = 1;
+    apply_rotation_(nullptr, software_rotation_);
     disp_drv.flush_cb = flush_pixels;
+    disp_drv.rounder_cb = rounder_cb;
+    disp_drv.monitor_cb = monitor_cb;
     disp_drv.draw_buf = &draw_buf;
     lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
     
     if (!disp) {
         ESP_LOGE(TAG, "Display driver registration failed");
+    } else {
+        lv_timer_set_cb(disp->refr_timer, refr_timer_cb);
     }
 
     // Configure touch input driver
@@ -140,12 +277,147 @@ void HaDeckDevice::setup() {
     lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, LV_PART_MAIN);
     lv_obj_set_style_pad_all(screen, 0, LV_PART_MAIN);
     lv_obj_set_style_border_width(screen, 0, LV_PART_MAIN);
+
+    metrics.setup_overlay();
+
+    if (disp) {
+        compare_rotations_(disp);
+    }
     
     ESP_LOGCONFIG(TAG, "Free memory after setup: %d bytes", esp_get_free_heap_size());
 }
 
+void HaDeckDevice::tune_write_frequency_() {
+    // Stappen die de LCD klok van de ESP32-S3 exact haalt
+    static const uint32_t STEPS[] = {16000000, 20000000, 24000000, 30000000, 40000000};
+
+    uint32_t chosen = lcd.get_write_frequency();
+    if (!bus_self_test()) {
+        // Dan werkt teruglezen zelf niet; hogere klokken zijn op deze manier niet te beoordelen
+        ESP_LOGW(TAG, "Bus self-test fails at %u kHz, keeping that clock", (unsigned) (chosen / 1000));
+        return;
+    }
+
+    for (uint32_t freq : STEPS) {
+        if (freq <= chosen) {
+            continue;
+        }
+        lcd.releaseBus();
+        lcd.set_write_frequency(freq);
+        lcd.initBus();
+        bool ok = bus_self_test();
+        ESP_LOGD(TAG, "Bus self-test at %u kHz: %s", (unsigned) (freq / 1000), ok ? "ok" : "failed");
+        if (!ok) {
+            break;
+        }
+        chosen = freq;
+    }
+
+    // Een mislukte stap laat het paneel in een onbekende toestand achter: op de gekozen klok
+    // opnieuw initialiseren en nog één keer controleren
+    if (!reinit_panel_(chosen)) {
+        ESP_LOGW(TAG, "Bus self-test fails at %u kHz after re-init, falling back to %u kHz", (unsigned) (chosen / 1000),
+                 (unsigned) (write_frequency_ / 1000));
+        chosen = write_frequency_;
+        reinit_panel_(chosen);
+    }
+    ESP_LOGCONFIG(TAG, "Bus write clock auto-tuned to %u kHz", (unsigned) (chosen / 1000));
+}
+
+bool HaDeckDevice::reinit_panel_(uint32_t freq) {
+    // Zelfde volgorde als in setup(): init, helderheid, rotatie (MADCTL) en DMA
+    lcd.releaseBus();
+    lcd.set_write_frequency(freq);
+    if (!lcd.init()) {
+        return false;
+    }
+    lcd.setBrightness(128);
+    lcd.setRotation(panel_rotation_());
+    lcd.initDMA();
+    return bus_self_test();
+}
+
+void HaDeckDevice::measure_full_frame_flush_(size_t buf_pixels) {
+    // Een zwart beeld in stukken ter grootte van de draw buffer, zoals LVGL een volledig frame flusht
+    memset(buf1, 0, buf_pixels * sizeof(lv_color_t));
+    int32_t width = lcd.width();
+    int32_t height = lcd.height();
+    int32_t lines = buf_pixels / width;
+
+    uint32_t start = micros();
+    lcd.startWrite();
+    for (int32_t y = 0; y < height; y += lines) {
+        int32_t h = std::min(lines, height - y);
+        lcd.pushImageDMA(0, y, width, h, (lgfx::swap565_t *) &buf1->full);
+        lcd.waitDMA();
+    }
+    lcd.endWrite();
+    uint32_t elapsed = micros() - start;
+
+    ESP_LOGCONFIG(TAG, "Bus write clock %u kHz, full frame flush %u us", (unsigned) (lcd.get_write_frequency() / 1000),
+                  (unsigned) elapsed);
+}
+
+void HaDeckDevice::apply_rotation_(lv_disp_t *disp, bool software) {
+    lcd.waitDMA();
+    lcd.setRotation(software ? 0 : rotation_);
+    disp_drv.hor_res = lcd.width();
+    disp_drv.ver_res = lcd.height();
+    if (software) {
+        // LVGL krijgt de resolutie van het paneel en draait zelf; de flush komt dan uit een
+        // tijdelijke buffer van LVGL en gaat blokkerend over de bus. Door de rotatie van 90 graden
+        // wordt de LVGL x-as de y-as van het paneel, ook voor het tegelraster.
+        disp_drv.rotated = LV_DISP_ROT_90;
+        disp_drv.sw_rotate = 1;
+        tiles.setup(lcd.width(), lcd.height(), tile_lines, TILE_WIDTH);
+    } else {
+        disp_drv.rotated = LV_DISP_ROT_NONE;
+        disp_drv.sw_rotate = 0;
+        tiles.setup(lcd.width(), lcd.height(), TILE_WIDTH, tile_lines);
+    }
+    if (disp != nullptr) {
+        lv_disp_drv_update(disp, &disp_drv);
+    }
+}
+
+uint32_t HaDeckDevice::measure_full_frame_refresh_(lv_disp_t *disp) {
+    // Het hele scherm opnieuw laten tekenen, zonder tegels over te slaan
+    tiles.invalidate();
+    uint32_t start = micros();
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(disp);
+    lcd.waitDMA();
+    return micros() - start;
+}
+
+void HaDeckDevice::compare_rotations_(lv_disp_t *disp) {
+    if (rotation_ != LANDSCAPE_ROTATION) {
+        // Software rotatie bestaat alleen voor landscape; er is niets om mee te vergelijken
+        ESP_LOGCONFIG(TAG, "Full frame refresh (render + flush) with panel rotation: %u us",
+                      (unsigned) measure_full_frame_refresh_(disp));
+        return;
+    }
+
+    // Eerst de andere weg, dan de ingestelde, zodat die daarna actief blijft. Het scherm is hier
+    // nog leeg, dus de andere orientatie is hooguit één frame te zien.
+    apply_rotation_(disp, !software_rotation_);
+    uint32_t other = measure_full_frame_refresh_(disp);
+    apply_rotation_(disp, software_rotation_);
+    uint32_t active = measure_full_frame_refresh_(disp);
+
+    uint32_t software_us = software_rotation_ ? active : other;
+    uint32_t panel_us = software_rotation_ ? other : active;
+    ESP_LOGCONFIG(TAG, "Full frame refresh (render + flush): LVGL software rotation %u us, panel rotation %u us, using %s",
+                  (unsigned) software_us, (unsigned) panel_us, software_rotation_ ? "LVGL software" : "panel");
+}
+
 void HaDeckDevice::loop() {
+    uint32_t start = micros();
     lv_timer_handler();
+    metrics.record_timer_handler(micros() - start);
+
+    // Overlay verversen en sensors publiceren
+    metrics.loop();
 
 #ifdef DEBUG_MEMORY
     static unsigned long last_memory_check = 0;
@@ -4,6 +4,8 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 #include "LGFX.h"
+#include "hd_dirty_regions.h"
+#include "hd_metrics.h"
 #include "lvgl.h"
 
 // Removed the LV_IMG_DECLARE(bg_480x320) line which is no longer needed
@@ -20,12 +22,53 @@ public:
     uint8_t get_brightness();
     void set_brightness(uint8_t value);
     
+    // Hoogte van elk van de twee LVGL draw buffers in lijnen
+    void set_buffer_lines(uint16_t lines) { buffer_lines_ = lines; }
+    
+    // LovyanGFX rotatie (0-3) van het paneel; touch volgt dezelfde rotatie
+    void set_rotation(uint8_t rotation) { rotation_ = rotation; }
+    // LovyanGFX rotatie die landscape oplevert, de enige stand met software rotatie
+    static const uint8_t LANDSCAPE_ROTATION = 3;
+    // Landscape zoals voorheen: paneel in portrait en LVGL roteert in software (LV_DISP_ROT_90)
+    void set_software_rotation(bool software_rotation) { software_rotation_ = software_rotation; }
+    
+    // Kloksnelheid van de 8080 bus, en optioneel bij het opstarten de snelste die de zelftest haalt.
+    // De zelftest leest testpatronen terug en heeft daarvoor de RD pin nodig.
+    void set_write_frequency(uint32_t freq) { write_frequency_ = freq; }
+    void set_auto_tune(bool auto_tune) { auto_tune_ = auto_tune; }
+    void set_read_pin(int8_t pin) { read_pin_ = pin; }
+    
+    // Metrics als ESPHome sensors en optioneel als overlay op het scherm
+    void set_metric_sensor(Metric metric, sensor::Sensor *sensor) { metrics.set_sensor(metric, sensor); }
+    void set_metrics_overlay(bool overlay) { metrics.set_overlay(overlay); }
+    // Latency van een request van een ander component (name moet een vaste string zijn)
+    void record_request(const char *name, uint32_t ms) { metrics.record_request(name, ms); }
+    
     // Add method to set Todoist API key 
     void set_todoist_api_key(const std::string &api_key);
     
 private:
+    void tune_write_frequency_();
+    // Initialiseert het paneel opnieuw op freq en draait de bus self-test; false als die faalt
+    bool reinit_panel_(uint32_t freq);
+    void measure_full_frame_flush_(size_t buf_pixels);
+    // Zet paneel, LVGL driver en tegelraster op panel of software rotatie; disp mag nog nullptr zijn
+    void apply_rotation_(lv_disp_t *disp, bool software);
+    // Render en flush van een volledig frame door LVGL, in us
+    uint32_t measure_full_frame_refresh_(lv_disp_t *disp);
+    // Meet in landscape beide rotaties na elkaar en logt ze samen
+    void compare_rotations_(lv_disp_t *disp);
+    // Rotatie voor setRotation: bij software rotatie blijft het paneel in portrait
+    uint8_t panel_rotation_() const { return software_rotation_ ? 0 : rotation_; }
+
     unsigned long time_ = 0;
     uint8_t brightness_ = 0;
+    uint16_t buffer_lines_ = 10;
+    uint8_t rotation_ = 3;
+    bool software_rotation_ = true;
+    uint32_t write_frequency_ = 10000000;
+    bool auto_tune_ = false;
+    int8_t read_pin_ = -1;
     std::string todoist_api_key_;
 };
 
@@ -0,0 +1,127 @@
+#include "hd_dirty_regions.h"
+#include "esphome/core/log.h"
+#include <algorithm>
+
+namespace esphome {
+namespace hd_device {
+
+static const char *const TAG = "HD_DIRTY";
+
+// Wat een extra gebied ongeveer kost (render pass, adresvenster, flush) uitgedrukt in pixels
+static const uint32_t MERGE_SLACK_PX = 2 * TILE_WIDTH * TILE_WIDTH;
+
+static const uint32_t FNV_OFFSET = 2166136261UL;
+static const uint32_t FNV_PRIME = 16777619UL;
+
+void coalesce_dirty_areas(lv_disp_t *disp) {
+    bool merged = true;
+    while (merged && disp->inv_p > 1) {
+        merged = false;
+        for (uint16_t i = 0; i < disp->inv_p && !merged; i++) {
+            for (uint16_t j = i + 1; j < disp->inv_p; j++) {
+                lv_area_t joined;
+                _lv_area_join(&joined, &disp->inv_areas[i], &disp->inv_areas[j]);
+                uint32_t separate = lv_area_get_size(&disp->inv_areas[i]) + lv_area_get_size(&disp->inv_areas[j]);
+                if (lv_area_get_size(&joined) > separate + MERGE_SLACK_PX) {
+                    continue;
+                }
+                // j vervangen door het laatste gebied; de lijst blijft zonder gaten voor LVGL
+                disp->inv_areas[i] = joined;
+                disp->inv_p--;
+                disp->inv_areas[j] = disp->inv_areas[disp->inv_p];
+                merged = true;
+                break;
+            }
+        }
+    }
+    for (uint16_t i = 0; i < disp->inv_p; i++) {
+        disp->inv_area_joined[i] = 0;
+    }
+}
+
+bool TileHashes::setup(uint16_t width, uint16_t height, uint16_t tile_w, uint16_t tile_h) {
+    tile_w_ = tile_w;
+    tile_h_ = tile_h;
+    cols_ = (width + tile_w - 1) / tile_w;
+    size_t rows = (height + tile_h - 1) / tile_h;
+    hashes_.assign(cols_ * rows, 0);
+    band_.assign(cols_, 0);
+    runs_.reserve(16);
+    ESP_LOGCONFIG(TAG, "Tile hashes: %ux%u px tiles, %u bytes", tile_w, tile_h, (unsigned) (hashes_.size() * sizeof(uint32_t)));
+    return true;
+}
+
+void TileHashes::invalidate() {
+    std::fill(hashes_.begin(), hashes_.end(), 0);
+}
+
+const std::vector<lv_area_t> &TileHashes::diff(const lv_area_t *area, const uint16_t *pixels) {
+    runs_.clear();
+    if (hashes_.empty()) {
+        runs_.push_back(*area);
+        return runs_;
+    }
+
+    int32_t w = area->x2 - area->x1 + 1;
+    int32_t tx1 = area->x1 / tile_w_;
+    int32_t tx2 = area->x2 / tile_w_;
+
+    for (int32_t y = area->y1; y <= area->y2;) {
+        int32_t ty = y / tile_h_;
+        int32_t band_y2 = std::min<int32_t>((ty + 1) * tile_h_ - 1, area->y2);
+        bool full_band = y == ty * tile_h_ && band_y2 == (ty + 1) * tile_h_ - 1;
+
+        // Rij voor rij door de buffer, zodat de pixels sequentieel gelezen worden
+        if (full_band) {
+            std::fill(band_.begin() + tx1, band_.begin() + tx2 + 1, FNV_OFFSET);
+            for (int32_t row = y; row <= band_y2; row++) {
+                const uint16_t *line = pixels + (row - area->y1) * w;
+                for (int32_t x = area->x1; x <= area->x2; x++) {
+                    uint32_t &hash = band_[x / tile_w_];
+                    hash = (hash ^ line[x - area->x1]) * FNV_PRIME;
+                }
+            }
+        }
+
+        int32_t run_start = -1;
+        for (int32_t tx = tx1; tx <= tx2 + 1; tx++) {
+            bool changed = false;
+            if (tx <= tx2) {
+                uint32_t &stored = hashes_[ty * cols_ + tx];
+                bool full = full_band && tx * tile_w_ >= area->x1 && (tx + 1) * tile_w_ - 1 <= area->x2;
+                if (full) {
+                    uint32_t hash = band_[tx] != 0 ? band_[tx] : 1;
+                    changed = hash != stored;
+                    stored = hash;
+                } else {
+                    changed = true;
+                    stored = 0;
+                }
+            }
+
+            if (changed && run_start < 0) {
+                run_start = tx;
+            } else if (!changed && run_start >= 0) {
+                lv_area_t run;
+                run.x1 = std::max<int32_t>(run_start * tile_w_, area->x1);
+                run.x2 = std::min<int32_t>(tx * tile_w_ - 1, area->x2);
+                run.y1 = y;
+                run.y2 = band_y2;
+                // Zelfde kolommen direct onder de vorige run: één venster, meestal het hele gebied
+                if (!runs_.empty() && runs_.back().x1 == run.x1 && runs_.back().x2 == run.x2 &&
+                    runs_.back().y2 + 1 == run.y1) {
+                    runs_.back().y2 = run.y2;
+                } else {
+                    runs_.push_back(run);
+                }
+                run_start = -1;
+            }
+        }
+
+        y = band_y2 + 1;
+    }
+    return runs_;
+}
+
+}  // namespace hd_device
+}  // namespace esphome
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "lvgl.h"
+#include <vector>
+
+namespace esphome {
+namespace hd_device {
+
+// Breedte van een tegel in LVGL coordinaten. Veelvoud van 2 pixels, zodat elke rij een veelvoud
+// van 4 bytes is en de DMA transfers uitgelijnd blijven; 480 en 320 zijn er veelvouden van.
+static const uint16_t TILE_WIDTH = 16;
+
+// Voegt de invalidated gebieden van dit frame samen als het samengevoegde gebied niet meer dan
+// een paar tegels groter is dan de losse gebieden samen. LVGL voegt zelf alleen samen als dat
+// strikt kleiner is, waardoor bijvoorbeeld twee aangrenzende regels in een lijst elk een eigen
+// render pass en adresvenster krijgen.
+void coalesce_dirty_areas(lv_disp_t *disp);
+
+// Hash per tegel van wat het laatst naar het paneel gestuurd is, in flush (paneel) coordinaten.
+// Van een geflusht gebied worden alleen de tegels die anders zijn dan de vorige keer gepusht,
+// per tegelrij samengevoegd tot horizontale runs. Tegels die het gebied maar deels bedekt
+// worden altijd gepusht en vergeten. Alleen gebruikt vanuit de flush callback.
+class TileHashes {
+public:
+    bool setup(uint16_t width, uint16_t height, uint16_t tile_w, uint16_t tile_h);
+    // Na iets dat buiten LVGL om op het paneel getekend is
+    void invalidate();
+
+    // Ververst de hashes voor area en geeft de stukken die gepusht moeten worden. Het resultaat
+    // blijft geldig tot de volgende aanroep.
+    const std::vector<lv_area_t> &diff(const lv_area_t *area, const uint16_t *pixels);
+
+protected:
+    uint16_t tile_w_ = 0;
+    uint16_t tile_h_ = 0;
+    uint16_t cols_ = 0;
+    // 0 betekent onbekend; een berekende hash is nooit 0
+    std::vector<uint32_t> hashes_;
+    // Hashes van de tegelrij die nu berekend wordt, en de runs van de laatste diff
+    std::vector<uint32_t> band_;
+    std::vector<lv_area_t> runs_;
+};
+
+}  // namespace hd_device
+}  // namespace esphome
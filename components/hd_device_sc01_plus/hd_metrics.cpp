@@ -0,0 +1,223 @@
+#include "hd_metrics.h"
+#include "esphome/core/log.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <cstring>
+
+namespace esphome {
+namespace hd_device {
+
+static const char *const TAG = "HD_METRICS";
+
+Metrics metrics;
+
+const uint32_t LatencyHistogram::BOUNDS_MS[LatencyHistogram::BUCKETS - 1] = {100, 250, 500, 1000, 2000, 5000, 10000};
+
+void LatencyHistogram::record(uint32_t ms) {
+    uint8_t bucket = 0;
+    while (bucket < BUCKETS - 1 && ms >= BOUNDS_MS[bucket]) {
+        bucket++;
+    }
+    buckets_[bucket]++;
+    count_++;
+    if (ms > max_ms_) {
+        max_ms_ = ms;
+    }
+}
+
+void LatencyHistogram::reset() {
+    memset(buckets_, 0, sizeof(buckets_));
+    count_ = 0;
+    max_ms_ = 0;
+}
+
+uint32_t LatencyHistogram::percentile(uint8_t pct) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    uint32_t target = (count_ * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < BUCKETS - 1; i++) {
+        seen += buckets_[i];
+        if (seen >= target) {
+            return BOUNDS_MS[i] < max_ms_ ? BOUNDS_MS[i] : max_ms_;
+        }
+    }
+    return max_ms_;
+}
+
+void LatencyHistogram::format(char *buf, size_t len) const {
+    size_t pos = 0;
+    buf[0] = '\0';
+    for (uint8_t i = 0; i < BUCKETS && pos < len; i++) {
+        if (buckets_[i] == 0) {
+            continue;
+        }
+        int written = i < BUCKETS - 1
+            ? snprintf(buf + pos, len - pos, "<%u:%u ", (unsigned) BOUNDS_MS[i], (unsigned) buckets_[i])
+            : snprintf(buf + pos, len - pos, ">=%u:%u ", (unsigned) BOUNDS_MS[i - 1], (unsigned) buckets_[i]);
+        if (written < 0) {
+            break;
+        }
+        pos += written;
+    }
+}
+
+void Metrics::record_frame(uint32_t render_ms) {
+    for (Window *window : {&second_, &interval_}) {
+        window->frames++;
+        window->render_ms += render_ms;
+        if (render_ms > window->render_max_ms) {
+            window->render_max_ms = render_ms;
+        }
+    }
+}
+
+void Metrics::record_flush(uint32_t flush_us, uint32_t dma_wait_us, uint32_t bytes) {
+    for (Window *window : {&second_, &interval_}) {
+        window->flushes++;
+        window->flush_us += flush_us;
+        window->dma_wait_us += dma_wait_us;
+        window->bytes += bytes;
+    }
+}
+
+void Metrics::record_timer_handler(uint32_t us) {
+    for (Window *window : {&second_, &interval_}) {
+        window->timer_calls++;
+        window->timer_us += us;
+        if (us > window->timer_max_us) {
+            window->timer_max_us = us;
+        }
+    }
+}
+
+void Metrics::record_request(const char *name, uint32_t ms) {
+    all_requests_.record(ms);
+    for (NamedHistogram &entry : requests_) {
+        if (strcmp(entry.name, name) == 0) {
+            entry.histogram.record(ms);
+            return;
+        }
+    }
+    requests_.push_back({name, LatencyHistogram()});
+    requests_.back().histogram.record(ms);
+}
+
+void Metrics::setup_overlay() {
+    if (!overlay_enabled_) {
+        return;
+    }
+
+    // Op de systeemlaag, zodat het boven elk scherm en elke modal blijft staan
+    overlay_ = lv_label_create(lv_layer_sys());
+    if (overlay_ == nullptr) {
+        ESP_LOGW(TAG, "Failed to create metrics overlay");
+        return;
+    }
+    lv_obj_set_style_text_font(overlay_, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_set_style_text_color(overlay_, lv_color_hex(0xFFFFFF), LV_PART_MAIN);
+    lv_obj_set_style_bg_color(overlay_, lv_color_hex(0x000000), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(overlay_, LV_OPA_70, LV_PART_MAIN);
+    lv_obj_set_style_pad_all(overlay_, 3, LV_PART_MAIN);
+    lv_obj_align(overlay_, LV_ALIGN_BOTTOM_LEFT, 0, 0);
+    lv_label_set_text(overlay_, "");
+}
+
+void Metrics::loop() {
+    uint32_t now = millis();
+
+    if (now - second_.start_ms >= 1000) {
+        update_overlay_(second_, now);
+        second_ = {};
+        second_.start_ms = now;
+    }
+
+    if (now - interval_.start_ms >= PUBLISH_INTERVAL_MS) {
+        publish_(interval_, now);
+        interval_ = {};
+        interval_.start_ms = now;
+    }
+}
+
+void Metrics::update_overlay_(const Window &window, uint32_t now) {
+    if (overlay_ == nullptr) {
+        return;
+    }
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    uint32_t elapsed = now - window.start_ms;
+    lv_label_set_text_fmt(overlay_, "%u fps  render %u ms  flush %u us  %u kB/frame  timer %u us\nlvgl %u%% frag %u%%  heap %u kB  psram %u kB",
+                          (unsigned) (window.frames * 1000 / (elapsed ? elapsed : 1)),
+                          (unsigned) (window.frames ? window.render_ms / window.frames : 0),
+                          (unsigned) (window.flushes ? window.flush_us / window.flushes : 0),
+                          (unsigned) (window.frames ? window.bytes / window.frames / 1024 : 0),
+                          (unsigned) (window.timer_calls ? window.timer_us / window.timer_calls : 0),
+                          (unsigned) mon.used_pct, (unsigned) mon.frag_pct,
+                          (unsigned) (heap_caps_get_free_size(MALLOC_CAP_INTERNAL) / 1024),
+                          (unsigned) (heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024));
+}
+
+void Metrics::publish_(const Window &window, uint32_t now) {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    uint32_t elapsed = now - window.start_ms;
+    size_t internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    size_t psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+
+    float fps = window.frames * 1000.0f / (elapsed ? elapsed : 1);
+    publish_sensor_(METRIC_FPS, fps);
+    if (window.frames > 0) {
+        publish_sensor_(METRIC_RENDER_TIME, (float) window.render_ms / window.frames);
+        publish_sensor_(METRIC_BYTES_PER_FRAME, (float) window.bytes / window.frames);
+    }
+    if (window.flushes > 0) {
+        publish_sensor_(METRIC_FLUSH_TIME, window.flush_us / 1000.0f / window.flushes);
+    }
+    if (window.timer_calls > 0) {
+        publish_sensor_(METRIC_TIMER_HANDLER_TIME, window.timer_us / 1000.0f / window.timer_calls);
+    }
+    publish_sensor_(METRIC_LVGL_HEAP_USED, mon.used_pct);
+    publish_sensor_(METRIC_LVGL_HEAP_MAX_USED, mon.max_used);
+    publish_sensor_(METRIC_LVGL_HEAP_FRAGMENTATION, mon.frag_pct);
+    publish_sensor_(METRIC_INTERNAL_HEAP_FREE, internal_free);
+    publish_sensor_(METRIC_PSRAM_FREE, psram_free);
+    if (all_requests_.count() > 0) {
+        publish_sensor_(METRIC_REQUEST_LATENCY, all_requests_.percentile(95));
+    }
+
+    if (window.frames > 0) {
+        ESP_LOGD(TAG, "Display: %.1f fps, render %u ms/frame (max %u), %u flushes, flush %u us (DMA wait %u us) avg, %u B/frame pushed",
+                 fps, (unsigned) (window.render_ms / window.frames), (unsigned) window.render_max_ms,
+                 (unsigned) window.flushes, (unsigned) (window.flushes ? window.flush_us / window.flushes : 0),
+                 (unsigned) (window.flushes ? window.dma_wait_us / window.flushes : 0),
+                 (unsigned) (window.bytes / window.frames));
+    }
+    ESP_LOGD(TAG, "lv_timer_handler %u us avg, %u us max; LVGL heap %u%% used, max %u B, frag %u%%",
+             (unsigned) (window.timer_calls ? window.timer_us / window.timer_calls : 0), (unsigned) window.timer_max_us,
+             (unsigned) mon.used_pct, (unsigned) mon.max_used, (unsigned) mon.frag_pct);
+    ESP_LOGD(TAG, "Heap: internal %u B free (min %u B), PSRAM %u B free", (unsigned) internal_free,
+             (unsigned) heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL), (unsigned) psram_free);
+
+    for (NamedHistogram &entry : requests_) {
+        if (entry.histogram.count() == 0) {
+            continue;
+        }
+        char buf[96];
+        entry.histogram.format(buf, sizeof(buf));
+        ESP_LOGD(TAG, "Requests %s: %u, p50 %u ms, p95 %u ms [%s]", entry.name, (unsigned) entry.histogram.count(),
+                 (unsigned) entry.histogram.percentile(50), (unsigned) entry.histogram.percentile(95), buf);
+        entry.histogram.reset();
+    }
+    all_requests_.reset();
+}
+
+void Metrics::publish_sensor_(Metric metric, float value) {
+    if (sensors_[metric] != nullptr) {
+        sensors_[metric]->publish_state(value);
+    }
+}
+
+}  // namespace hd_device
+}  // namespace esphome
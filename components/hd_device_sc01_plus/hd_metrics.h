@@ -0,0 +1,107 @@
+#pragma once
+
+#include "esphome/core/helpers.h"
+#include "esphome/components/sensor/sensor.h"
+#include "lvgl.h"
+#include <vector>
+
+namespace esphome {
+namespace hd_device {
+
+// Metrics die als ESPHome sensor gepubliceerd kunnen worden
+enum Metric : uint8_t {
+    METRIC_FPS,
+    METRIC_RENDER_TIME,
+    METRIC_FLUSH_TIME,
+    METRIC_BYTES_PER_FRAME,
+    METRIC_TIMER_HANDLER_TIME,
+    METRIC_LVGL_HEAP_USED,
+    METRIC_LVGL_HEAP_MAX_USED,
+    METRIC_LVGL_HEAP_FRAGMENTATION,
+    METRIC_INTERNAL_HEAP_FREE,
+    METRIC_PSRAM_FREE,
+    METRIC_REQUEST_LATENCY,
+    METRIC_COUNT,
+};
+
+// Latency histogram met vaste bucket grenzen in ms
+class LatencyHistogram {
+public:
+    static const uint8_t BUCKETS = 8;
+
+    void record(uint32_t ms);
+    void reset();
+    uint32_t count() const { return count_; }
+    // Bovengrens van de bucket waarin het percentiel valt; voor de laatste bucket het maximum
+    uint32_t percentile(uint8_t pct) const;
+    // "<100:3 <250:1 ..." voor in de log
+    void format(char *buf, size_t len) const;
+
+protected:
+    static const uint32_t BOUNDS_MS[BUCKETS - 1];
+
+    uint32_t buckets_[BUCKETS] = {};
+    uint32_t count_ = 0;
+    uint32_t max_ms_ = 0;
+};
+
+// Verzamelt render-, flush- en heap statistieken voor het display en request latency voor
+// componenten zoals Todoist. Alle record_ functies draaien op de main loop.
+class Metrics {
+public:
+    void record_frame(uint32_t render_ms);
+    // bytes: wat er na het overslaan van ongewijzigde tegels echt over de bus ging
+    void record_flush(uint32_t flush_us, uint32_t dma_wait_us, uint32_t bytes);
+    void record_timer_handler(uint32_t us);
+    void record_request(const char *name, uint32_t ms);
+
+    void set_sensor(Metric metric, sensor::Sensor *sensor) { sensors_[metric] = sensor; }
+    void set_overlay(bool overlay) { overlay_enabled_ = overlay; }
+
+    // Maakt het overlay label op lv_layer_sys, na lv_init
+    void setup_overlay();
+    // Ververst het overlay elke seconde en publiceert de sensors elk interval
+    void loop();
+
+protected:
+    // Tellers over een tijdvenster
+    struct Window {
+        uint32_t start_ms;
+        uint32_t frames;
+        uint32_t render_ms;
+        uint32_t render_max_ms;
+        uint32_t flushes;
+        uint32_t flush_us;
+        uint32_t dma_wait_us;
+        uint32_t bytes;
+        uint32_t timer_calls;
+        uint32_t timer_us;
+        uint32_t timer_max_us;
+    };
+
+    struct NamedHistogram {
+        const char *name;
+        LatencyHistogram histogram;
+    };
+
+    void update_overlay_(const Window &window, uint32_t now);
+    void publish_(const Window &window, uint32_t now);
+    void publish_sensor_(Metric metric, float value);
+
+    Window second_ = {};
+    Window interval_ = {};
+    static const uint32_t PUBLISH_INTERVAL_MS = 10000;
+
+    // Per request soort en alles samen, gereset na elk publish interval
+    std::vector<NamedHistogram> requests_;
+    LatencyHistogram all_requests_;
+
+    sensor::Sensor *sensors_[METRIC_COUNT] = {};
+    bool overlay_enabled_ = false;
+    lv_obj_t *overlay_ = nullptr;
+};
+
+extern Metrics metrics;
+
+}  // namespace hd_device
+}  // namespace esphome
@@ -1,21 +1,79 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.const import CONF_ID, CONF_TIME_ID, CONF_INTERVAL
-from esphome.components import time
+from esphome.const import (
+    CONF_ID,
+    CONF_TIME_ID,
+    CONF_INTERVAL,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_TOTAL_INCREASING,
+)
+from esphome.components import sensor, time
 
 DEPENDENCIES = ["network", "time", "http_request"] # Ensure http_request is listed
-AUTO_LOAD = ["http_request"]
+AUTO_LOAD = ["http_request", "sensor"]
 
 CONF_TODOIST_API_KEY = "todoist_api_key"
+CONF_API_URL = "api_url"
+CONF_INCREMENTAL_SYNC = "incremental_sync"
+CONF_SNAPSHOT = "snapshot"
+CONF_POLLING = "polling"
+CONF_ACTIVE_INTERVAL = "active_interval"
+CONF_MAX_INTERVAL = "max_interval"
+CONF_IDLE_TIMEOUT = "idle_timeout"
+CONF_JITTER = "jitter"
+# Tellers sinds boot als optionele sensors
+CONF_METRICS = "metrics"
+# Request latency naar de metrics van het display component; todoist hangt zelf niet van hd_device af
+CONF_DEVICE_ID = "device_id"
 
 todoist_ns = cg.esphome_ns.namespace('todoist')
 TodoistComponent = todoist_ns.class_('TodoistComponent', cg.Component)
+HaDeckDevice = cg.esphome_ns.namespace('hd_device').class_('HaDeckDevice', cg.Component)
+Counter = todoist_ns.enum('Counter')
+
+# Sensor sleutel -> teller
+COUNTER_SENSORS = {
+    "not_modified_count": Counter.COUNTER_NOT_MODIFIED,
+    "full_fetch_count": Counter.COUNTER_FULL_FETCH,
+    "fetches_triggered": Counter.COUNTER_FETCHES_TRIGGERED,
+    "fetches_executed": Counter.COUNTER_FETCHES_EXECUTED,
+}
+
+METRICS_SCHEMA = cv.Schema({
+    cv.Optional(key): sensor.sensor_schema(
+        accuracy_decimals=0,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    )
+    for key in COUNTER_SENSORS
+})
+
+def validate_api_url(value):
+    value = cv.url(value)
+    if not value.startswith("https://"):
+        raise cv.Invalid("The API URL must use https://")
+    return value
 
 CONFIG_SCHEMA = cv.Schema({
     cv.GenerateID(): cv.declare_id(TodoistComponent),
     cv.Required(CONF_TODOIST_API_KEY): cv.string,
     cv.Required(CONF_TIME_ID): cv.use_id(time.RealTimeClock),
+    # Bijvoorbeeld een lokale stand-in server om te testen; host en poort komen uit de URL
+    cv.Optional(CONF_API_URL, default="https://api.todoist.com"): validate_api_url,
     cv.Optional(CONF_INTERVAL, default="300s"): cv.update_interval,
+    # Opt-in: de Sync API geeft alle taken met een datum, niet alleen overdue/vandaag zoals het
+    # REST filter, en loopt op grotere accounts tegen TaskStore::MAX_TASKS/MAX_ARENA_SIZE aan
+    cv.Optional(CONF_INCREMENTAL_SYNC, default=False): cv.boolean,
+    cv.Optional(CONF_SNAPSHOT, default=True): cv.boolean,
+    cv.Optional(CONF_DEVICE_ID): cv.use_id(HaDeckDevice),
+    cv.Optional(CONF_METRICS): METRICS_SCHEMA,
+    # interval geldt als niemand het scherm gebruikt; zie PollScheduler
+    cv.Optional(CONF_POLLING, default={}): cv.Schema({
+        cv.Optional(CONF_ACTIVE_INTERVAL, default="30s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MAX_INTERVAL, default="30min"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_IDLE_TIMEOUT, default="120s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_JITTER, default="10%"): cv.All(cv.percentage, cv.Range(max=0.5)),
+    }),
 }).extend(cv.COMPONENT_SCHEMA)
 
 async def to_code(config):
@@ -24,6 +82,7 @@ async def to_code(config):
     
     # Set API key
     cg.add(var.set_api_key(config[CONF_TODOIST_API_KEY]))
+    cg.add(var.set_api_url(config[CONF_API_URL]))
     
     # Set time component
     time_var = await cg.get_variable(config[CONF_TIME_ID])
@@ -33,5 +92,32 @@ async def to_code(config):
     interval = config[CONF_INTERVAL].total_seconds
     cg.add(var.set_update_interval(interval))
     
+    # Alleen wijzigingen ophalen via de Sync API
+    cg.add(var.set_incremental_sync(config[CONF_INCREMENTAL_SYNC]))
+    
+    # Laatste takenlijst op de spiffs partitie, voor een gevulde lijst direct na het opstarten
+    cg.add(var.set_snapshot(config[CONF_SNAPSHOT]))
+    
+    # Request latency in de histogrammen van de display metrics
+    if CONF_DEVICE_ID in config:
+        device = await cg.get_variable(config[CONF_DEVICE_ID])
+        cg.add(var.set_on_request(cg.RawExpression(
+            f"[](const char *name, uint32_t ms) {{ {device}->record_request(name, ms); }}"
+        )))
+    
+    # Tellers als sensors
+    if CONF_METRICS in config:
+        for key, counter in COUNTER_SENSORS.items():
+            if key in config[CONF_METRICS]:
+                sens = await sensor.new_sensor(config[CONF_METRICS][key])
+                cg.add(var.set_counter_sensor(counter, sens))
+    
+    # Adaptive polling
+    polling = config[CONF_POLLING]
+    cg.add(var.set_active_interval(polling[CONF_ACTIVE_INTERVAL].total_milliseconds))
+    cg.add(var.set_max_interval(polling[CONF_MAX_INTERVAL].total_milliseconds))
+    cg.add(var.set_idle_timeout(polling[CONF_IDLE_TIMEOUT].total_milliseconds))
+    cg.add(var.set_poll_jitter(polling[CONF_JITTER]))
+    
     # Verwijder de expliciete toevoeging van ArduinoJson, ESPHome detecteert dit meestal automatisch
     # cg.add_library("ArduinoJson", "^6.18.5")
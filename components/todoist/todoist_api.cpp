@@ -1,19 +1,307 @@
 #include "todoist_api.h"
+#include "todoist_body_stream.h"
+#include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 #include <ArduinoJson.h>
+#include <WiFi.h>
+#include <esp_heap_caps.h>
+#include <cstdlib>
+#include <cstring>
 
 namespace esphome {
 namespace todoist {
 
 static const char *const TAG = "todoist.api";
-static const char *const API_BASE_URL = "https://api.todoist.com/rest/v2";
+static const char *const REST_API_PATH = "/rest/v2";
+static const char *const SYNC_API_PATH = "/sync/v9/sync";
+
+// Todoist sluit idle keep-alive verbindingen na ongeveer een minuut
+static const uint32_t IDLE_TIMEOUT_MS = 50000;
+// Restje body dat we nog wegwerken om de verbinding te kunnen hergebruiken
+static const size_t DRAIN_LIMIT = 1024;
+
+// Completions die kort na elkaar komen gaan samen in één request
+static const uint32_t FLUSH_DELAY_MS = 2000;
+// Backoff voor de outbox na een mislukte flush: 5 s, 10 s, 20 s, ... tot 5 minuten
+static const uint32_t FLUSH_BACKOFF_MS = 5000;
+static const uint32_t FLUSH_BACKOFF_MAX_MS = 5 * 60 * 1000;
+
+// Bij een 429 zonder (bruikbare) Retry-After header
+static const uint32_t DEFAULT_RETRY_AFTER_S = 60;
+
+// Circuit breaker: open na zoveel fouten op rij, eerst 15 s, daarna steeds twee keer zo lang
+static const uint8_t CIRCUIT_FAILURE_THRESHOLD = 3;
+static const uint32_t CIRCUIT_OPEN_MS = 15000;
+static const uint32_t CIRCUIT_OPEN_MAX_MS = 10 * 60 * 1000;
+// Langer dan de circuit breaker ooit zelf wacht honoreren we een Retry-After niet; zo blijft
+// retry_after_s * 1000 ook ruim binnen uint32_t
+static const uint32_t RETRY_AFTER_MAX_S = CIRCUIT_OPEN_MAX_MS / 1000;
+
+// Netwerktaak: TLS heeft ruim stack nodig, core 0 deelt hij met de WiFi stack
+static const uint32_t WORKER_STACK_SIZE = 12 * 1024;
+static const UBaseType_t WORKER_PRIORITY = 1;
+static const BaseType_t WORKER_CORE = 0;
+
+// Percent-encoding voor form parameters (RFC 3986 unreserved tekens blijven staan)
+static std::string url_encode(const std::string &value) {
+  static const char *const HEX_DIGITS = "0123456789ABCDEF";
+  std::string encoded;
+  encoded.reserve(value.size());
+  for (char ch : value) {
+    uint8_t c = static_cast<uint8_t>(ch);
+    if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+      encoded += ch;
+    } else {
+      encoded += '%';
+      encoded += HEX_DIGITS[c >> 4];
+      encoded += HEX_DIGITS[c & 0x0F];
+    }
+  }
+  return encoded;
+}
 
 TodoistApi::TodoistApi() {
-  // Nothing to initialize
+  // Eén persistente verbinding naar de API host; het certificaat wordt niet gecontroleerd,
+  // net als voorheen met http_.begin(url)
+  client_.setInsecure();
+  http_.setReuse(true);
+}
+
+bool TodoistApi::set_base_url(const std::string &url) {
+  // Alleen https://host[:poort][/pad]; de verbinding is altijd TLS
+  static const char *const SCHEME = "https://";
+  if (url.compare(0, strlen(SCHEME), SCHEME) != 0) {
+    ESP_LOGE(TAG, "API URL must start with %s: %s", SCHEME, url.c_str());
+    return false;
+  }
+  size_t host_start = strlen(SCHEME);
+  size_t path_start = url.find('/', host_start);
+  if (path_start == std::string::npos)
+    path_start = url.size();
+  std::string authority = url.substr(host_start, path_start - host_start);
+
+  uint16_t port = 443;
+  size_t colon = authority.rfind(':');
+  if (colon != std::string::npos) {
+    char *end;
+    long value = strtol(authority.c_str() + colon + 1, &end, 10);
+    if (*end != '\0' || value <= 0 || value > 65535) {
+      ESP_LOGE(TAG, "Invalid port in API URL: %s", url.c_str());
+      return false;
+    }
+    port = value;
+    authority.resize(colon);
+  }
+  if (authority.empty()) {
+    ESP_LOGE(TAG, "No host in API URL: %s", url.c_str());
+    return false;
+  }
+
+  // Zonder slash aan het einde, de paden van de endpoints beginnen er zelf mee
+  std::string base_url = url;
+  while (base_url.size() > path_start && base_url.back() == '/')
+    base_url.pop_back();
+
+  base_url_ = base_url;
+  host_ = authority;
+  port_ = port;
+  return true;
+}
+
+bool TodoistApi::start() {
+  if (worker_ != nullptr)
+    return true;
+  
+  // Completions van de vorige sessie gaan bij de eerste loop() alsnog de deur uit, ook als de
+  // netwerktaak niet start en requests synchroon lopen
+  outbox_.load();
+  
+  queue_ = xQueueCreate(QUEUE_SIZE, sizeof(Job *));
+  if (queue_ == nullptr) {
+    ESP_LOGE(TAG, "Failed to create request queue, requests will block the main loop");
+    return false;
+  }
+  
+  if (xTaskCreatePinnedToCore(worker_task_, "todoist_net", WORKER_STACK_SIZE, this, WORKER_PRIORITY, &worker_,
+                              WORKER_CORE) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start network task, requests will block the main loop");
+    vQueueDelete(queue_);
+    queue_ = nullptr;
+    worker_ = nullptr;
+    return false;
+  }
+  
+  ESP_LOGI(TAG, "Network task started");
+  return true;
+}
+
+void TodoistApi::loop() {
+  Job *job;
+  while (results_.pop(job)) {
+    dispatch_(job);
+  }
+  flush_outbox_();
+}
+
+void TodoistApi::flush_outbox_() {
+  if (outbox_.empty() || flush_in_flight_ || api_key_.empty())
+    return;
+  if ((int32_t) (millis() - next_flush_) < 0)
+    return;
+  
+  Job *job = new Job();
+  job->type = JOB_COMPLETE_TASK;
+  for (size_t i = 0; i < outbox_.size(); i++) {
+    job->commands.push_back(outbox_[i]);
+  }
+  flush_in_flight_ = true;
+  submit_(job);
+}
+
+void TodoistApi::worker_task_(void *param) {
+  TodoistApi *api = static_cast<TodoistApi *>(param);
+  while (true) {
+    Job *job;
+    if (xQueueReceive(api->queue_, &job, portMAX_DELAY) != pdTRUE)
+      continue;
+    
+    api->run_job_(job);
+    
+    // Alles wat in de queue past past ook in de ring. Vol raakt hij alleen als de main loop al
+    // meer dan een volle queue aan resultaten heeft laten liggen; dan wachten tot er plek is.
+    while (!api->results_.push(job)) {
+      vTaskDelay(pdMS_TO_TICKS(10));
+    }
+  }
+}
+
+void TodoistApi::submit_(Job *job) {
+  if (queue_ == nullptr) {
+    // Geen netwerktaak: synchroon uitvoeren zoals voorheen
+    run_job_(job);
+    dispatch_(job);
+    return;
+  }
+  
+  if (xQueueSend(queue_, &job, 0) != pdTRUE) {
+    job->ok = false;
+    job->error_message = "Request queue full";
+    dispatch_(job);
+  }
+}
+
+void TodoistApi::run_job_(Job *job) {
+  uint32_t start = millis();
+  switch (job->type) {
+    case JOB_FETCH_TASKS:
+      job->ok = fetch_tasks_blocking_(job->tasks, job->error_message);
+      job->not_modified = not_modified_;
+      break;
+    case JOB_COMPLETE_TASK:
+      job->ok = close_tasks_blocking_(job->commands, job->commands_done, job->error_message);
+      break;
+    case JOB_SYNC_TASKS:
+      job->ok = sync_tasks_blocking_(job->tasks, job->full_sync, job->error_message);
+      break;
+  }
+  job->duration_ms = millis() - start;
+  job->retry_after_s = retry_after_s_;
+  timing_.heap_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+  job->timing = timing_;
+}
+
+void TodoistApi::dispatch_(Job *job) {
+  const RequestTiming &t = job->timing;
+  ESP_LOGD(TAG, "Request timing: dns %u ms, connect %u ms, first byte %u ms, body %u ms (%s, %u/%u connections/requests)",
+           (unsigned) t.dns_ms, (unsigned) t.connect_ms, (unsigned) t.first_byte_ms, (unsigned) t.body_ms,
+           t.reused ? "reused" : "new", (unsigned) connections_opened_, (unsigned) requests_total_);
+  if (job->ok && t.body_bytes > 0) {
+    // Doorvoer van lezen + parsen, om optimalisaties in het fetch -> parse pad te kunnen meten
+    ESP_LOGD(TAG, "Parsed %u bytes into %u items in %u ms (%u kB/s, %u B stored per item), min free heap %u B",
+             (unsigned) t.body_bytes, (unsigned) job->tasks.size(), (unsigned) t.body_ms,
+             (unsigned) (t.body_ms ? t.body_bytes / t.body_ms : 0),
+             (unsigned) (job->tasks.empty() ? 0 : job->tasks.memory_usage() / job->tasks.size()),
+             (unsigned) t.heap_min_free);
+  }
+  
+  // Latency per soort request, bijvoorbeeld voor de histogrammen van de display metrics
+  static const char *const JOB_NAMES[] = {"todoist_fetch", "todoist_sync", "todoist_complete"};
+  if (on_request_) {
+    on_request_(JOB_NAMES[job->type], job->duration_ms);
+  }
+  if (job->type != JOB_COMPLETE_TASK) {
+    end_read_(job);
+  }
+  
+  switch (job->type) {
+    case JOB_FETCH_TASKS:
+      if (job->ok && job->not_modified) {
+        not_modified_count_++;
+        ESP_LOGI(TAG, "Tasks not modified in %u ms (%u not modified / %u full fetches)", (unsigned) job->duration_ms,
+                 (unsigned) not_modified_count_, (unsigned) full_fetch_count_);
+        job->fetch_callback(std::move(job->tasks), false);
+      } else if (job->ok) {
+        full_fetch_count_++;
+        ESP_LOGI(TAG, "Successfully fetched %u tasks in %u ms (%u bytes stored)", (unsigned) job->tasks.size(),
+                 (unsigned) job->duration_ms, (unsigned) job->tasks.memory_usage());
+        job->fetch_callback(std::move(job->tasks), true);
+      } else {
+        ESP_LOGE(TAG, "Failed to fetch tasks: %s", job->error_message.c_str());
+        if (job->error_callback) {
+          job->error_callback(job->error_message);
+        }
+      }
+      break;
+      
+    case JOB_SYNC_TASKS:
+      if (job->ok) {
+        ESP_LOGI(TAG, "Synced %u changed items in %u ms (%s)", (unsigned) job->tasks.size(), (unsigned) job->duration_ms,
+                 job->full_sync ? "full" : "incremental");
+        job->sync_callback(std::move(job->tasks), job->full_sync);
+      } else {
+        ESP_LOGE(TAG, "Failed to sync tasks: %s", job->error_message.c_str());
+        if (job->error_callback) {
+          job->error_callback(job->error_message);
+        }
+      }
+      break;
+      
+    case JOB_COMPLETE_TASK:
+      flush_in_flight_ = false;
+      if (job->ok) {
+        size_t done = 0;
+        for (size_t i = 0; i < job->commands.size(); i++) {
+          if (job->commands_done[i]) {
+            outbox_.remove(job->commands[i].uuid);
+            done++;
+          }
+        }
+        ESP_LOGI(TAG, "Marked %u of %u tasks completed, %u still in outbox", (unsigned) done,
+                 (unsigned) job->commands.size(), (unsigned) outbox_.size());
+        flush_failures_ = 0;
+        next_flush_ = millis();
+        if (done > 0 && on_tasks_closed_) {
+          on_tasks_closed_();
+        }
+      } else {
+        // Exponentiële backoff; de outbox blijft bewaard tot Todoist de commands bevestigt
+        flush_failures_++;
+        uint32_t backoff = FLUSH_BACKOFF_MS << (flush_failures_ < 7 ? flush_failures_ - 1 : 6);
+        if (backoff > FLUSH_BACKOFF_MAX_MS)
+          backoff = FLUSH_BACKOFF_MAX_MS;
+        if (job->retry_after_s * 1000 > backoff)
+          backoff = job->retry_after_s * 1000;
+        next_flush_ = millis() + backoff;
+        ESP_LOGW(TAG, "Failed to complete %u tasks: %s, retrying in %u s", (unsigned) job->commands.size(),
+                 job->error_message.c_str(), (unsigned) (backoff / 1000));
+      }
+      break;
+  }
+  delete job;
 }
 
 void TodoistApi::fetch_tasks(
-  std::function<void(std::vector<TodoistTask>)> success_callback,
+  std::function<void(TaskStore &&, bool)> success_callback,
   std::function<void(std::string)> error_callback
 ) {
   ESP_LOGI(TAG, "Fetching tasks from Todoist");
@@ -25,42 +313,21 @@ void TodoistApi::fetch_tasks(
     }
     return;
   }
-
-  // Filter taken aan de API-kant: alleen taken die vandaag of eerder afgehandeld moeten worden
-  // URL-encoded filter: (overdue | today) -> %28overdue%20%7C%20today%29
-  std::string url = std::string(API_BASE_URL) + "/tasks?filter=%28overdue%20%7C%20today%29";
-  std::string response;
-  std::string error_message;
-  
-  // Make the HTTP request
-  if (!do_http_request(url, "GET", response, error_message)) {
-    ESP_LOGE(TAG, "Failed to fetch tasks: %s", error_message.c_str());
-    if (error_callback) {
-      error_callback(error_message);
-    }
+  if (!begin_read_(error_callback))
     return;
-  }
-  
-  // Parse the response
-  std::vector<TodoistTask> tasks;
-  std::string parse_error;
-  if (parse_tasks_json_internal(response, tasks, parse_error)) {
-    ESP_LOGI(TAG, "Successfully fetched %d tasks", tasks.size());
-    success_callback(tasks);
-  } else {
-    ESP_LOGE(TAG, "Error parsing tasks JSON: %s", parse_error.c_str());
-    if (error_callback) {
-      error_callback("Parse error: " + parse_error);
-    }
-  }
+
+  Job *job = new Job();
+  job->type = JOB_FETCH_TASKS;
+  job->fetch_callback = std::move(success_callback);
+  job->error_callback = std::move(error_callback);
+  submit_(job);
 }
 
-void TodoistApi::complete_task(
-  const std::string &task_id,
-  std::function<void(bool)> success_callback,
+void TodoistApi::sync_tasks(
+  std::function<void(TaskStore &&, bool)> success_callback,
   std::function<void(std::string)> error_callback
 ) {
-  ESP_LOGI(TAG, "Marking task %s as completed", task_id.c_str());
+  ESP_LOGI(TAG, "Syncing tasks with Todoist");
 
   if (api_key_.empty()) {
     ESP_LOGE(TAG, "API key not set");
@@ -69,58 +336,343 @@ void TodoistApi::complete_task(
     }
     return;
   }
+  if (!begin_read_(error_callback))
+    return;
 
-  std::string url = std::string(API_BASE_URL) + "/tasks/" + task_id + "/close";
-  std::string response;
-  std::string error_message;
+  Job *job = new Job();
+  job->type = JOB_SYNC_TASKS;
+  job->full_sync = full_sync_requested_;
+  full_sync_requested_ = false;
+  job->sync_callback = std::move(success_callback);
+  job->error_callback = std::move(error_callback);
+  submit_(job);
+}
+
+bool TodoistApi::begin_read_(const std::function<void(std::string)> &error_callback) {
+  // Opnieuw op Retry drukken terwijl er al een request loopt levert geen tweede request op
+  if (read_in_flight_) {
+    ESP_LOGD(TAG, "Fetch already in flight, coalescing");
+    return false;
+  }
   
-  // Make the HTTP request
-  if (!do_http_request(url, "POST", response, error_message)) {
-    ESP_LOGE(TAG, "Failed to complete task: %s", error_message.c_str());
-    if (error_callback) {
-      error_callback(error_message);
-    } else {
-      success_callback(false);
+  if (circuit_ == CIRCUIT_OPEN) {
+    if ((int32_t) (millis() - circuit_open_until_) < 0) {
+      std::string error = "Circuit open, retrying in " + std::to_string(get_retry_after()) + " s";
+      ESP_LOGD(TAG, "%s", error.c_str());
+      if (error_callback) {
+        error_callback(error);
+      }
+      return false;
     }
+    // Wachttijd voorbij: één probe; die bepaalt of het circuit dicht of weer open gaat
+    ESP_LOGI(TAG, "Circuit half open, sending probe request");
+    circuit_ = CIRCUIT_HALF_OPEN;
+  }
+  
+  read_in_flight_ = true;
+  return true;
+}
+
+void TodoistApi::end_read_(const Job *job) {
+  read_in_flight_ = false;
+  
+  if (job->ok) {
+    if (circuit_ != CIRCUIT_CLOSED) {
+      ESP_LOGI(TAG, "Circuit closed after %u failures", (unsigned) read_failures_);
+    }
+    circuit_ = CIRCUIT_CLOSED;
+    read_failures_ = 0;
+    circuit_open_ms_ = 0;
+    return;
+  }
+  
+  if (read_failures_ < 255)
+    read_failures_++;
+  // Een mislukte probe of een Retry-After opent meteen; anders pas na een paar fouten op rij
+  if (circuit_ != CIRCUIT_HALF_OPEN && job->retry_after_s == 0 && read_failures_ < CIRCUIT_FAILURE_THRESHOLD)
     return;
+  
+  circuit_open_ms_ = circuit_open_ms_ == 0 ? CIRCUIT_OPEN_MS : circuit_open_ms_ * 2;
+  if (circuit_open_ms_ > CIRCUIT_OPEN_MAX_MS)
+    circuit_open_ms_ = CIRCUIT_OPEN_MAX_MS;
+  // +/- 20% jitter, en nooit korter dan de server vraagt
+  uint32_t open_ms = circuit_open_ms_ * (0.8f + 0.4f * random_float());
+  if (job->retry_after_s * 1000 > open_ms)
+    open_ms = job->retry_after_s * 1000;
+  circuit_ = CIRCUIT_OPEN;
+  circuit_open_until_ = millis() + open_ms;
+  ESP_LOGW(TAG, "Circuit open for %u s after %u failures", (unsigned) (open_ms / 1000), (unsigned) read_failures_);
+}
+
+uint32_t TodoistApi::get_retry_after() const {
+  if (circuit_ != CIRCUIT_OPEN)
+    return 0;
+  int32_t remaining = circuit_open_until_ - millis();
+  return remaining > 0 ? (remaining + 999) / 1000 : 0;
+}
+
+bool TodoistApi::complete_task(const std::string &task_id) {
+  ESP_LOGI(TAG, "Marking task %s as completed", task_id.c_str());
+  
+  if (!outbox_.add(task_id.c_str()))
+    return false;
+  
+  // Kort wachten zodat meerdere completions in één request gaan, tenzij we al in backoff zitten
+  if (flush_failures_ == 0)
+    next_flush_ = millis() + FLUSH_DELAY_MS;
+  return true;
+}
+
+bool TodoistApi::fetch_tasks_blocking_(TaskStore &tasks, std::string &error_message) {
+  // Filter taken aan de API-kant: alleen taken die vandaag of eerder afgehandeld moeten worden
+  // URL-encoded filter: (overdue | today) -> %28overdue%20%7C%20today%29
+  std::string url = base_url_ + REST_API_PATH + "/tasks?filter=%28overdue%20%7C%20today%29";
+  
+  // Make the HTTP request; de body wordt direct vanuit de stream geparsed
+  return do_http_request(url, "GET", "", [this, &tasks](Stream &stream, std::string &parse_error) {
+    if (!parse_tasks_stream(stream, tasks, parse_error)) {
+      parse_error = "Parse error: " + parse_error;
+      return false;
+    }
+    return true;
+  }, error_message);
+}
+
+bool TodoistApi::close_tasks_blocking_(const std::vector<Outbox::Entry> &commands, std::vector<bool> &done,
+                                       std::string &error_message) {
+  // Eén Sync API request met een item_close command per taak
+  JsonDocument doc;
+  JsonArray array = doc.to<JsonArray>();
+  for (const Outbox::Entry &entry : commands) {
+    JsonObject command = array.add<JsonObject>();
+    command["type"] = "item_close";
+    command["uuid"] = entry.uuid;
+    command["args"]["id"] = entry.task_id;
   }
+  std::string json;
+  serializeJson(doc, json);
+  
+  // sync_status heeft per command uuid "ok" of een error object; de rest van de response
+  // (o.a. temp_id_mapping en een nieuwe sync_token) wordt tijdens het parsen al weggefilterd
+  JsonDocument result;
+  bool ok = do_http_request(base_url_ + SYNC_API_PATH, "POST", "commands=" + url_encode(json),
+                            [&result](Stream &stream, std::string &parse_error) {
+    JsonDocument filter;
+    filter["sync_status"] = true;
+    DeserializationError error = deserializeJson(result, stream, DeserializationOption::Filter(filter));
+    if (error) {
+      parse_error = std::string("Parse error: ") + error.c_str();
+      return false;
+    }
+    return true;
+  }, error_message);
+  if (!ok)
+    return false;
   
-  ESP_LOGI(TAG, "Taak %s succesvol als voltooid gemarkeerd", task_id.c_str());
-  success_callback(true);
+  JsonObjectConst sync_status = result["sync_status"];
+  done.assign(commands.size(), false);
+  for (size_t i = 0; i < commands.size(); i++) {
+    JsonVariantConst status = sync_status[commands[i].uuid];
+    if (status.isNull())
+      continue;  // Niet verwerkt, gaat mee in de volgende flush
+    done[i] = true;
+    if (!status.is<const char *>()) {
+      // Bijvoorbeeld een taak die al verwijderd is; opnieuw proberen heeft geen zin
+      const char *reason = status["error"].as<const char *>();
+      ESP_LOGW(TAG, "Todoist rejected completion of task %s: %s", commands[i].task_id,
+               reason != nullptr ? reason : "unknown error");
+    }
+  }
+  return true;
 }
 
-bool TodoistApi::do_http_request(const std::string& url, 
+bool TodoistApi::sync_tasks_blocking_(TaskStore &changes, bool &full_sync, std::string &error_message) {
+  // Alleen items; een sync_token van "*" vraagt om een volledige sync
+  if (full_sync)
+    sync_token_ = "*";
+  std::string body = "sync_token=" + url_encode(sync_token_) + "&resource_types=%5B%22items%22%5D";
+  std::string new_token;
+  full_sync = sync_token_ == "*";
+  
+  bool ok = do_http_request(base_url_ + SYNC_API_PATH, "POST", body,
+                            [this, &changes, &full_sync, &new_token](Stream &stream, std::string &parse_error) {
+    if (!parse_sync_stream(stream, changes, full_sync, new_token, parse_error)) {
+      parse_error = "Parse error: " + parse_error;
+      return false;
+    }
+    return true;
+  }, error_message);
+  
+  if (ok) {
+    sync_token_ = new_token;
+  } else if ((last_status_code_ >= 400 && last_status_code_ < 500) || store_full_) {
+    // Ongeldig of verlopen token, of een delta die niet in de store past: volgende keer opnieuw
+    // volledig synchroniseren. Het token schuift nooit op voorbij items die we niet bewaard hebben.
+    sync_token_ = "*";
+  }
+  return ok;
+}
+
+bool TodoistApi::do_http_request(const std::string& url,
                                  const std::string& method,
-                                 std::string& response,
+                                 const std::string& body,
+                                 const BodyHandler &body_handler,
                                  std::string& error_message) {
-  http_.begin(url.c_str());
+  int32_t httpResponseCode;
+  if (!send_request_(url, method, body, httpResponseCode, error_message)) {
+    return false;
+  }
   
-  // Voeg standaard headers toe
-  http_.addHeader("Authorization", ("Bearer " + api_key_).c_str());
-  http_.addHeader("Content-Type", "application/json");
+  bool ok = true;
+  uint32_t start = millis();
+  if (httpResponseCode != 204 && httpResponseCode != 304) { // 204 No Content / 304 Not Modified have no body
+    BodyStream body_stream(http_.getStream(), http_.getSize(),
+                           http_.header("Transfer-Encoding").equalsIgnoreCase("chunked"), read_buffer_,
+                           sizeof(read_buffer_));
+    ok = body_handler(body_stream, error_message);
+    timing_.body_bytes = body_stream.bytes_read();
+    
+    // Alleen een volledig gelezen body laat de verbinding bruikbaar achter
+    if (!body_stream.drain(DRAIN_LIMIT)) {
+      ESP_LOGD(TAG, "Response body not fully consumed, closing connection");
+      client_.stop();
+    }
+  }
+  timing_.body_ms = millis() - start;
   
-  // Voeg extra headers toe voor het beheersen van cache en compressie
-  http_.addHeader("Cache-Control", "no-cache");
+  http_.end();
+  if (ok && method == "GET" && !not_modified_) {
+    if (response_validator_.etag.empty() && response_validator_.last_modified.empty()) {
+      validators_.erase(url);
+    } else {
+      validators_[url] = std::move(response_validator_);
+    }
+  }
+  return ok;
+}
+
+bool TodoistApi::ensure_connected_(std::string& error_message) {
+  // De server sluit idle verbindingen zelf; niet wachten tot een request daarop stukloopt
+  if (client_.connected() && millis() - last_used_ > IDLE_TIMEOUT_MS) {
+    ESP_LOGD(TAG, "Connection idle for too long, reconnecting");
+    client_.stop();
+  }
   
-  // Als het een POST is met lege body, voeg Content-Length toe
-  if (method == "POST") {
-    http_.addHeader("Content-Length", "0");
+  if (client_.connected()) {
+    timing_.reused = true;
+    return true;
   }
   
-  // Perform the request
-  int32_t httpResponseCode;
-  if (method == "GET") {
-    httpResponseCode = http_.GET();
-  } else if (method == "POST") {
-    httpResponseCode = http_.POST("");
-  } else {
-    http_.end();
-    error_message = "Unsupported method: " + method;
+  // DNS apart timen; connect() zoekt het adres daarna uit de lwIP cache
+  IPAddress ip;
+  uint32_t start = millis();
+  if (!WiFi.hostByName(host_.c_str(), ip)) {
+    error_message = "DNS lookup failed";
+    return false;
+  }
+  timing_.dns_ms = millis() - start;
+  
+  start = millis();
+  if (!client_.connect(host_.c_str(), port_)) {
+    error_message = "Connection failed";
     return false;
   }
+  timing_.connect_ms = millis() - start;
+  connections_opened_++;
+  return true;
+}
+
+bool TodoistApi::send_request_(const std::string& url,
+                               const std::string& method,
+                               const std::string& body,
+                               int32_t &status_code,
+                               std::string& error_message) {
+  static const char *collected_headers[] = {"Transfer-Encoding", "ETag", "Last-Modified", "Retry-After"};
+  timing_ = RequestTiming();
+  response_validator_ = Validator();
+  last_status_code_ = 0;
+  not_modified_ = false;
+  retry_after_s_ = 0;
+  requests_total_++;
+  
+  // Conditional GET met de validators van de vorige response op dit endpoint
+  const Validator *validator = nullptr;
+  if (method == "GET") {
+    auto it = validators_.find(url);
+    if (it != validators_.end())
+      validator = &it->second;
+  }
+  
+  int32_t httpResponseCode = 0;
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (!ensure_connected_(error_message)) {
+      return false;
+    }
+    
+    // Met de eigen client hergebruikt HTTPClient de open (TLS) verbinding
+    http_.begin(client_, url.c_str());
+    http_.collectHeaders(collected_headers, 4);
+    
+    // Voeg standaard headers toe; de Sync API verwacht form-encoded parameters
+    http_.addHeader("Authorization", ("Bearer " + api_key_).c_str());
+    http_.addHeader("Content-Type", body.empty() ? "application/json" : "application/x-www-form-urlencoded");
+    
+    // Voeg extra headers toe voor het beheersen van cache en compressie
+    if (validator != nullptr) {
+      if (!validator->etag.empty())
+        http_.addHeader("If-None-Match", validator->etag.c_str());
+      if (!validator->last_modified.empty())
+        http_.addHeader("If-Modified-Since", validator->last_modified.c_str());
+    } else {
+      http_.addHeader("Cache-Control", "no-cache");
+    }
+    
+    // Als het een POST is met lege body, voeg Content-Length toe
+    if (method == "POST" && body.empty()) {
+      http_.addHeader("Content-Length", "0");
+    }
+    
+    // Perform the request
+    uint32_t start = millis();
+    if (method == "GET") {
+      httpResponseCode = http_.GET();
+    } else if (method == "POST") {
+      httpResponseCode = http_.POST(body.c_str());
+    } else {
+      http_.end();
+      error_message = "Unsupported method: " + method;
+      return false;
+    }
+    timing_.first_byte_ms = millis() - start;
+    last_used_ = millis();
+    
+    // Een hergebruikte verbinding kan al door de server gesloten zijn: één keer opnieuw met een verse
+    if (httpResponseCode < 0 && timing_.reused) {
+      ESP_LOGD(TAG, "Reused connection failed (%d), reconnecting", httpResponseCode);
+      http_.end();
+      client_.stop();
+      timing_ = RequestTiming();
+      continue;
+    }
+    break;
+  }
   
   // Check response
+  last_status_code_ = httpResponseCode;
+  if (httpResponseCode == HTTP_CODE_NOT_MODIFIED && validator != nullptr) {
+    // Body, parse en render kunnen allemaal worden overgeslagen
+    not_modified_ = true;
+    status_code = httpResponseCode;
+    return true;
+  }
   if (httpResponseCode < 200 || httpResponseCode >= 300) {
+    if (httpResponseCode == 429 || httpResponseCode == 503) {
+      // Alleen de seconden-vorm; een HTTP datum valt terug op de standaard
+      long seconds = http_.header("Retry-After").toInt();
+      if (seconds > (long) RETRY_AFTER_MAX_S)
+        seconds = RETRY_AFTER_MAX_S;
+      retry_after_s_ = seconds > 0 ? seconds : (httpResponseCode == 429 ? DEFAULT_RETRY_AFTER_S : 0);
+    }
     if (httpResponseCode > 0) {
       error_message = "HTTP error code: " + std::to_string(httpResponseCode);
       // Fix string concatenation error - use append or separate concatenations
@@ -130,120 +682,341 @@ bool TodoistApi::do_http_request(const std::string& url,
       }
     } else {
       error_message = "Connection failed";
+      client_.stop();
     }
     http_.end();
     return false;
   }
   
-  // Get the response
-  if (httpResponseCode != 204) { // 204 No Content has no body
-    response = http_.getString().c_str();
+  if (method == "GET") {
+    // Pas opslaan als de body ook gelezen en geparsed is, anders geeft de volgende request een
+    // 304 op data die we nooit gezien hebben
+    response_validator_.etag = http_.header("ETag").c_str();
+    response_validator_.last_modified = http_.header("Last-Modified").c_str();
   }
   
-  http_.end();
+  status_code = httpResponseCode;
   return true;
 }
 
-// Drastisch verkleinen van de JSON buffer
-bool TodoistApi::parse_tasks_json_internal(const std::string &json, std::vector<TodoistTask>& tasks, std::string& error_message) {
-  tasks.clear();
-  
-  if (json.empty()) {
-    error_message = "Empty JSON response";
+// Leest/peekt één teken en wacht daarbij tot de stream timeout (-1 bij timeout of einde body)
+static int timed_read(Stream &stream) {
+  uint32_t start = millis();
+  do {
+    int c = stream.read();
+    if (c >= 0)
+      return c;
+    yield(); // Data is nog onderweg
+  } while (millis() - start < stream.getTimeout());
+  return -1;
+}
+
+static int timed_peek(Stream &stream) {
+  uint32_t start = millis();
+  do {
+    int c = stream.peek();
+    if (c >= 0)
+      return c;
+    yield(); // Data is nog onderweg
+  } while (millis() - start < stream.getTimeout());
+  return -1;
+}
+
+// Wacht op het volgende niet-whitespace teken zonder het te consumeren (-1 bij timeout)
+static int peek_next_char(Stream &stream) {
+  int c;
+  while ((c = timed_peek(stream)) >= 0 && isspace(c)) {
+    stream.read();
+  }
+  return c;
+}
+
+// Leest een JSON string (sleutel of token); escapes worden letterlijk overgenomen, \uXXXX niet gedecodeerd
+static bool read_json_string(Stream &stream, std::string &out, size_t max_length) {
+  out.clear();
+  if (peek_next_char(stream) != '"')
     return false;
+  stream.read();
+  while (true) {
+    int c = timed_read(stream);
+    if (c < 0)
+      return false;
+    if (c == '"')
+      return true;
+    if (c == '\\' && (c = timed_read(stream)) < 0)
+      return false;
+    if (out.size() >= max_length)
+      return false;
+    out += (char) c;
   }
+}
 
-  ESP_LOGD(TAG, "Received JSON string length: %d", json.length());
+// Leest een getal of literal (true/false/null) tot het scheidingsteken
+static bool read_json_scalar(Stream &stream, char *buf, size_t len) {
+  size_t n = 0;
+  int c = peek_next_char(stream);
+  while (c >= 0 && c != ',' && c != '}' && c != ']' && !isspace(c)) {
+    if (n + 1 < len)
+      buf[n++] = (char) c;
+    stream.read();
+    c = timed_peek(stream);
+  }
+  buf[n] = '\0';
+  return c >= 0;
+}
 
-  // JSON buffer ingesteld op 24KB
-  JsonDocument doc; // Modern JsonDocument
+// Slaat een willekeurige JSON waarde over zonder iets op te slaan
+static bool skip_json_value(Stream &stream) {
+  int c = peek_next_char(stream);
+  if (c != '{' && c != '[' && c != '"') {
+    char scalar[8];
+    return read_json_scalar(stream, scalar, sizeof(scalar));
+  }
+  
+  int depth = 0;
+  bool in_string = false;
+  bool escaped = false;
+  do {
+    c = timed_read(stream);
+    if (c < 0)
+      return false;
+    if (in_string) {
+      if (escaped) {
+        escaped = false;
+      } else if (c == '\\') {
+        escaped = true;
+      } else if (c == '"') {
+        in_string = false;
+      }
+    } else if (c == '"') {
+      in_string = true;
+    } else if (c == '{' || c == '[') {
+      depth++;
+    } else if (c == '}' || c == ']') {
+      depth--;
+    }
+  } while (depth > 0 || in_string);
+  return true;
+}
+
+// Alleen de velden die we tonen; labels, creator_id, url etc. worden tijdens het lezen overgeslagen
+static void build_task_filter(JsonDocument &filter) {
+  filter["id"] = true;
+  filter["content"] = true;
+  filter["description"] = true;
+  filter["project_id"] = true;
+  filter["priority"] = true;
+  filter["due"]["date"] = true;
+  filter["due"]["datetime"] = true;
+  filter["due"]["string"] = true;
+  // Sync API items: voltooid / verwijderd
+  filter["checked"] = true;
+  filter["is_completed"] = true;
+  filter["is_deleted"] = true;
+}
+
+static void parse_task_object(JsonObjectConst obj, TodoistTask &task) {
+  // Alleen de echt nodige velden ophalen
+  if (obj["id"].is<const char*>()) task.id = obj["id"].as<const char*>();
+  if (obj["content"].is<const char*>()) task.content = obj["content"].as<const char*>();
+  
+  // Beschrijving is groot en vaak onnodig - alleen ophalen als heel kort
+  if (obj["description"].is<const char*>()) {
+    const char* desc = obj["description"].as<const char*>();
+    if (strlen(desc) < 100) { // Alleen korte beschrijvingen
+      task.description = desc;
+    }
+  }
+  
+  // Alleen essentiële velden, section_id en parent_id worden niet geparsed om geheugen te besparen
+  if (obj["project_id"].is<const char*>()) task.project_id = obj["project_id"].as<const char*>();
   
-  // Gebruik geen extra options die meer geheugen gebruiken
-  DeserializationError error = deserializeJson(doc, json);
-  if (error) {
-    ESP_LOGE(TAG, "Failed to parse JSON: %s", error.c_str());
-    error_message = std::string("JSON parse error: ") + error.c_str();
+  // Due date processing
+  JsonObjectConst due_obj = obj["due"];
+  if (!due_obj.isNull()) {
+    if (due_obj["date"].is<const char*>()) task.due_date = due_obj["date"].as<const char*>();
+    // REST geeft de tijd alleen in datetime (UTC); date is daar altijd alleen de dag
+    if (due_obj["datetime"].is<const char*>()) task.due_date = due_obj["datetime"].as<const char*>();
+    if (due_obj["string"].is<const char*>()) task.due_string = due_obj["string"].as<const char*>();
+  }
+
+  // Parse priority
+  switch (obj["priority"] | 1) {
+    case 2: task.priority = PRIORITY_3; break;
+    case 3: task.priority = PRIORITY_2; break;
+    case 4: task.priority = PRIORITY_1; break;
+    case 1:
+    default: task.priority = PRIORITY_4; break;
+  }
+  
+  // REST gebruikt is_completed, de Sync API checked
+  task.is_completed = (obj["checked"] | false) || (obj["is_completed"] | false);
+  task.is_deleted = obj["is_deleted"] | false;
+}
+
+// Leest een JSON array van objecten element voor element; on_object geeft false terug om te stoppen
+static bool parse_object_array(Stream &stream, const JsonDocument &filter,
+                               const std::function<bool(JsonObjectConst)> &on_object, std::string &error_message) {
+  if (peek_next_char(stream) != '[') {
+    ESP_LOGE(TAG, "JSON is not an array");
+    error_message = "JSON is not an array";
     return false;
   }
+  stream.read();
 
-  // Parseer niet alle taken tegelijk maar beperk tot max. 5 om geheugen te sparen
-  int32_t task_count = 0;
-  const int32_t MAX_TASKS = 5; // Verlaagd naar 5
+  // Eén document per element: het wordt bij elke deserializeJson hergebruikt
+  JsonDocument doc;
 
-  JsonArray array = doc.as<JsonArray>();
-  if (array.isNull()) {
-      ESP_LOGE(TAG, "JSON is not an array");
-      error_message = "JSON is not an array";
-      return false;
+  if (peek_next_char(stream) == ']') {
+    stream.read();
+    return true; // Lege lijst
   }
 
-  for (JsonVariant task_json : array) {
-    if (task_count >= MAX_TASKS) {
-      ESP_LOGW(TAG, "Reached MAX_TASKS limit (%d), stopping parse.", MAX_TASKS);
-      break; // Hard limit op aantal taken
+  while (true) {
+    DeserializationError error = deserializeJson(doc, stream, DeserializationOption::Filter(filter));
+    if (error) {
+      ESP_LOGE(TAG, "Failed to parse JSON: %s", error.c_str());
+      error_message = std::string("JSON parse error: ") + error.c_str();
+      return false;
     }
     
-    if (!task_json.is<JsonObject>()) continue; // Skip non-object elements
+    if (doc.is<JsonObjectConst>() && !on_object(doc.as<JsonObjectConst>())) { // Skip non-object elements
+      return true; // De rest van de body wordt niet gelezen
+    }
+    
+    int c = peek_next_char(stream);
+    if (c == ',') {
+      stream.read();
+    } else if (c == ']') {
+      stream.read();
+      return true;
+    } else {
+      ESP_LOGE(TAG, "Unexpected end of array");
+      error_message = "JSON parse error: IncompleteInput";
+      return false;
+    }
+  }
+}
 
+bool TodoistApi::parse_tasks_stream(Stream &stream, TaskStore& tasks, std::string& error_message) {
+  tasks.clear();
+  store_full_ = false;
+  
+  JsonDocument filter;
+  build_task_filter(filter);
+  
+  bool ok = parse_object_array(stream, filter, [this, &tasks](JsonObjectConst obj) {
     TodoistTask task;
-    JsonObject obj = task_json.as<JsonObject>();
+    parse_task_object(obj, task);
+    if (!tasks.add(task)) {
+      ESP_LOGW(TAG, "Task store full at %u tasks, rejecting the fetch.", (unsigned) tasks.size());
+      store_full_ = true;
+      return false;
+    }
+    return true;
+  }, error_message);
+  // Een afgekapte lijst is geen succes: net als bij de sync blijft de vorige lijst staan
+  if (ok && store_full_) {
+    error_message = "Task store full";
+    return false;
+  }
+  return ok;
+}
 
-    // Alleen de echt nodige velden ophalen
-    if (obj["id"].is<const char*>()) task.id = obj["id"].as<std::string>(); 
-    if (obj["content"].is<const char*>()) task.content = obj["content"].as<std::string>();
-    
-    // Beschrijving is groot en vaak onnodig - alleen ophalen als heel kort
-    if (obj["description"].is<const char*>()) {
-      const char* desc = obj["description"].as<const char*>();
-      if (strlen(desc) < 100) { // Alleen korte beschrijvingen
-        task.description = desc;
-      }
+bool TodoistApi::parse_sync_stream(Stream &stream, TaskStore& changes, bool &full_sync, std::string &sync_token,
+                                   std::string& error_message) {
+  changes.clear();
+  sync_token.clear();
+  store_full_ = false;
+  bool have_items = false;
+  size_t dropped_tombstones = 0;
+  
+  if (peek_next_char(stream) != '{') {
+    error_message = "JSON is not an object";
+    return false;
+  }
+  stream.read();
+  
+  JsonDocument filter;
+  build_task_filter(filter);
+  
+  std::string key;
+  while (true) {
+    int c = peek_next_char(stream);
+    if (c == ',') {
+      stream.read();
+      continue;
     }
+    if (c == '}') {
+      stream.read();
+      break;
+    }
+    if (!read_json_string(stream, key, 64) || peek_next_char(stream) != ':') {
+      error_message = "JSON parse error: InvalidInput";
+      return false;
+    }
+    stream.read();
     
-    // Alleen essentiële velden
-    if (obj["project_id"].is<const char*>()) task.project_id = obj["project_id"].as<std::string>();
-    // section_id en parent_id worden niet geparsed om geheugen te besparen
-    // if (obj["section_id"].is<const char*>()) task.section_id = obj["section_id"].as<std::string>();
-    // if (obj["parent_id"].is<const char*>()) task.parent_id = obj["parent_id"].as<std::string>();
-    
-    // Due date processing
-    if (obj["due"].is<JsonObject>()) {
-        JsonObject due_obj = obj["due"];
-        if (due_obj["date"].is<const char*>()) task.due_date = due_obj["date"].as<std::string>();
-        if (due_obj["string"].is<const char*>()) task.due_string = due_obj["string"].as<std::string>();
-    }
-
-    // Parse priority
-    if (obj["priority"].is<int32_t>()) {
-        int32_t priority = obj["priority"].as<int32_t>();
-        switch (priority) {
-          case 1: task.priority = PRIORITY_4; break;
-          case 2: task.priority = PRIORITY_3; break;
-          case 3: task.priority = PRIORITY_2; break;
-          case 4: task.priority = PRIORITY_1; break;
-          default: task.priority = PRIORITY_4; break;
+    bool ok;
+    if (key == "items") {
+      have_items = true;
+      ok = parse_object_array(stream, filter, [this, &changes, &full_sync, &dropped_tombstones](JsonObjectConst obj) {
+        TodoistTask task;
+        parse_task_object(obj, task);
+        // Voltooid, verwijderd of zonder deadline: bij een delta alleen het id onthouden als tombstone,
+        // bij een full sync helemaal overslaan. full_sync is hier alleen bekend als we er zelf om
+        // vroegen of de sleutel al voorbij kwam; anders ruimt apply_changes de tombstones op.
+        if (task.is_completed || task.is_deleted || task.due_date.empty()) {
+          if (full_sync)
+            return true;
+          TodoistTask tombstone;
+          tombstone.id = task.id;
+          tombstone.is_deleted = true;
+          task = tombstone;
         }
+        if (!changes.add(task)) {
+          if (task.is_deleted) {
+            dropped_tombstones++;  // Alleen een fout als dit geen full sync blijkt te zijn
+            return true;
+          }
+          ESP_LOGW(TAG, "Task store full at %u items, rejecting the sync.", (unsigned) changes.size());
+          store_full_ = true;
+          return false;
+        }
+        return true;
+      }, error_message);
+      if (store_full_) {
+        error_message = "Task store full";
+        return false;
+      }
+    } else if (key == "sync_token") {
+      ok = read_json_string(stream, sync_token, 256);
+    } else if (key == "full_sync") {
+      char value[8];
+      ok = read_json_scalar(stream, value, sizeof(value));
+      full_sync = strcmp(value, "true") == 0;
     } else {
-        task.priority = PRIORITY_4;
+      ok = skip_json_value(stream);
+    }
+    if (!ok) {
+      if (error_message.empty())
+        error_message = "JSON parse error: IncompleteInput";
+      return false;
     }
-
-    tasks.push_back(task);
-    task_count++;
   }
-
+  
+  if (!have_items || sync_token.empty()) {
+    error_message = "Incomplete sync response";
+    return false;
+  }
+  if (dropped_tombstones > 0 && !full_sync) {
+    ESP_LOGW(TAG, "Task store full, %u deletions did not fit", (unsigned) dropped_tombstones);
+    store_full_ = true;
+    error_message = "Task store full";
+    return false;
+  }
   return true;
 }
 
-// Forward-facing method that doesn't throw
-std::vector<TodoistTask> TodoistApi::parse_tasks_json(const std::string &json) {
-    std::vector<TodoistTask> tasks;
-    std::string error_message;
-    if (!parse_tasks_json_internal(json, tasks, error_message)) {
-        // Log the error but return an empty vector instead of throwing
-        ESP_LOGE(TAG, "parse_tasks_json failed: %s", error_message.c_str());
-    }
-    return tasks;
-}
-
 }  // namespace todoist
 }  // namespace esphome
@@ -2,10 +2,18 @@
 
 #include "esphome/core/component.h"
 #include "todoist_task.h"
+#include "todoist_task_store.h"
+#include "todoist_spsc_ring.h"
+#include "todoist_outbox.h"
 #include <vector>
+#include <map>
 #include <functional>
 #include <string>
 #include <HTTPClient.h> // ESP32 HTTPClient library
+#include <WiFiClientSecure.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
 
 namespace esphome {
 namespace todoist {
@@ -15,33 +23,194 @@ class TodoistApi {
   TodoistApi();
   
   void set_api_key(const std::string &api_key) { api_key_ = api_key; }
+  // Basis URL van de API, bijv. een lokale stand-in; host en poort van de verbinding komen hieruit.
+  // Voor start() aanroepen. false (en de vorige URL blijft) als het geen https:// URL is.
+  bool set_base_url(const std::string &url);
   
-  // Fetch all active tasks, with success and error callbacks
+  // Start de netwerktaak; zonder start() worden requests synchroon uitgevoerd
+  bool start();
+  // Roept de callbacks van afgeronde requests aan; hoort in de main loop
+  void loop();
+  
+  // Fetch all active tasks, with success and error callbacks. De store wordt per fetch
+  // volledig opnieuw opgebouwd en pas bij succes aan de callback overgedragen; bij een
+  // 304 Not Modified is modified false en de store leeg.
+  // Callbacks komen altijd vanuit loop(), dus op de UI thread. Loopt er al een fetch of sync,
+  // dan wordt de aanroep daarmee samengevoegd en komen er geen callbacks; staat de circuit
+  // breaker open, dan volgt direct de error callback zonder request.
   void fetch_tasks(
-    std::function<void(std::vector<TodoistTask>)> success_callback,
+    std::function<void(TaskStore &&, bool)> success_callback,
     std::function<void(std::string)> error_callback = nullptr
   );
   
-  // Mark a task as completed, with success and error callbacks
-  void complete_task(
-    const std::string &task_id, 
-    std::function<void(bool)> success_callback,
+  // Incrementele sync via de Sync API: de callback krijgt alleen gewijzigde items (verwijderde en
+  // voltooide als tombstone), of bij full_sync de volledige set. Zie TaskStore::apply_changes
+  void sync_tasks(
+    std::function<void(TaskStore &&, bool)> success_callback,
     std::function<void(std::string)> error_callback = nullptr
   );
   
+  // De volgende sync_tasks wordt een volledige sync, bijvoorbeeld als een delta niet toegepast kon worden
+  void request_full_sync() { full_sync_requested_ = true; }
+  
+  // Seconden tot de circuit breaker weer een fetch of sync doorlaat (inclusief een Retry-After
+  // van de server), of 0
+  uint32_t get_retry_after() const;
+  
+  // 304 hits versus volledige fetches sinds boot
+  uint32_t get_not_modified_count() const { return not_modified_count_; }
+  uint32_t get_full_fetch_count() const { return full_fetch_count_; }
+  
+  // Mark a task as completed. De completion gaat via de outbox en wordt in batches met één Sync API
+  // request verstuurd, met backoff bij fouten; false als de outbox vol is
+  bool complete_task(const std::string &task_id);
+  
+  // Aangeroepen (vanuit loop()) als Todoist een batch completions bevestigd heeft
+  void set_on_tasks_closed(std::function<void()> callback) { on_tasks_closed_ = std::move(callback); }
+  
+  // Aangeroepen (vanuit loop()) na elke request, met een vaste naam per soort request en de duur in ms
+  void set_on_request(std::function<void(const char *, uint32_t)> callback) { on_request_ = std::move(callback); }
+  
+  // Completions die nog niet bevestigd zijn; deze taken horen niet terug te komen na een fetch
+  const Outbox &outbox() const { return outbox_; }
+  
  protected:
+  // Timing van één request in ms; dns en connect blijven 0 als de verbinding hergebruikt werd
+  struct RequestTiming {
+    uint32_t dns_ms = 0;
+    uint32_t connect_ms = 0;  // TCP + TLS handshake, WiFiClientSecure splitst die niet
+    uint32_t first_byte_ms = 0;
+    uint32_t body_ms = 0;  // Lezen en parsen van de body
+    uint32_t body_bytes = 0;
+    // Laagste vrije interne heap sinds boot, na deze request; zakt hij, dan was dit de piek
+    uint32_t heap_min_free = 0;
+    bool reused = false;
+  };
+  
+  enum JobType { JOB_FETCH_TASKS, JOB_SYNC_TASKS, JOB_COMPLETE_TASK };
+  
+  // Circuit breaker voor fetch en sync: na een reeks fouten gaat hij open en worden requests
+  // zonder netwerk geweigerd; na de wachttijd mag er één probe door (half open)
+  enum CircuitState : uint8_t { CIRCUIT_CLOSED, CIRCUIT_OPEN, CIRCUIT_HALF_OPEN };
+  
+  // Eén request plus zijn resultaat; gaat via queue_ naar de netwerktaak en via results_ terug
+  struct Job {
+    JobType type;
+    std::function<void(TaskStore &&, bool)> fetch_callback;
+    std::function<void(TaskStore &&, bool)> sync_callback;
+    std::function<void(std::string)> error_callback;
+    
+    // Batch item_close commands en per command of Todoist hem verwerkt heeft
+    std::vector<Outbox::Entry> commands;
+    std::vector<bool> commands_done;
+    
+    bool ok = false;
+    std::string error_message;
+    TaskStore tasks;
+    bool full_sync = false;
+    bool not_modified = false;
+    uint32_t duration_ms = 0;
+    uint32_t retry_after_s = 0;
+    RequestTiming timing;
+  };
+  
+  static const size_t QUEUE_SIZE = 8;
+  // Leesbuffer tussen de TLS client en de parser
+  static const size_t READ_BUFFER_SIZE = 1024;
+  
   std::string api_key_;
+  std::string base_url_ = "https://api.todoist.com";
+  std::string host_ = "api.todoist.com";
+  uint16_t port_ = 443;
+  
+  // Alleen gebruikt vanuit de netwerktaak
   HTTPClient http_; // Use the ESP32 HTTPClient
+  WiFiClientSecure client_; // Keep-alive verbinding die tussen requests open blijft
+  uint32_t last_used_ = 0;
+  RequestTiming timing_;
+  uint8_t read_buffer_[READ_BUFFER_SIZE];
+  int32_t last_status_code_ = 0;
+  bool not_modified_ = false;
+  // De laatste fetch of sync paste niet in de TaskStore
+  bool store_full_ = false;
+  uint32_t retry_after_s_ = 0;
+  
+  // Validators van de laatste 200 response per GET endpoint, voor If-None-Match / If-Modified-Since
+  struct Validator {
+    std::string etag;
+    std::string last_modified;
+  };
+  std::map<std::string, Validator> validators_;
+  // Validators van de lopende request; pas naar validators_ na een geslaagde body_handler
+  Validator response_validator_;
+  std::string sync_token_ = "*";
+  uint32_t requests_total_ = 0;
+  uint32_t connections_opened_ = 0;
+  
+  QueueHandle_t queue_ = nullptr;
+  TaskHandle_t worker_ = nullptr;
+  // Eén slot blijft leeg (zie SpscRing) en de netwerktaak kan nog een job onder handen hebben,
+  // dus + 2: een volle queue plus de lopende job passen altijd
+  SpscRing<Job *, QUEUE_SIZE + 2> results_;
+  
+  // Alleen bijgewerkt in dispatch_, dus op de main loop
+  bool full_sync_requested_ = false;
+  uint32_t not_modified_count_ = 0;
+  uint32_t full_fetch_count_ = 0;
+  
+  // Circuit breaker en single flight voor fetch/sync; alleen op de main loop
+  CircuitState circuit_ = CIRCUIT_CLOSED;
+  uint8_t read_failures_ = 0;
+  uint32_t circuit_open_ms_ = 0;
+  uint32_t circuit_open_until_ = 0;
+  bool read_in_flight_ = false;
+  // false als de request niet verstuurd moet worden (samengevoegd of circuit open)
+  bool begin_read_(const std::function<void(std::string)> &error_callback);
+  void end_read_(const Job *job);
   
-  // Verbeter decodering door een expliciete content length aan te geven
-  bool do_http_request(const std::string& url, 
-                       const std::string& method, 
-                       std::string& response, 
+  // Outbox met backoff; alleen op de main loop
+  Outbox outbox_;
+  bool flush_in_flight_ = false;
+  uint32_t flush_failures_ = 0;
+  uint32_t next_flush_ = 0;
+  std::function<void()> on_tasks_closed_;
+  std::function<void(const char *, uint32_t)> on_request_;
+  void flush_outbox_();
+  
+  static void worker_task_(void *param);
+  void submit_(Job *job);
+  // Blokkerend deel van een job, draait op de netwerktaak
+  void run_job_(Job *job);
+  // Callbacks van een afgeronde job, draait op de main loop
+  void dispatch_(Job *job);
+  
+  bool fetch_tasks_blocking_(TaskStore &tasks, std::string &error_message);
+  bool close_tasks_blocking_(const std::vector<Outbox::Entry> &commands, std::vector<bool> &done,
+                             std::string &error_message);
+  bool sync_tasks_blocking_(TaskStore &changes, bool &full_sync, std::string &error_message);
+  
+  // Krijgt de response stream i.p.v. een gebufferde string, zodat de body nooit volledig in het geheugen staat
+  using BodyHandler = std::function<bool(Stream &stream, std::string &error_message)>;
+  
+  bool do_http_request(const std::string& url,
+                       const std::string& method,
+                       const std::string& body,
+                       const BodyHandler &body_handler,
                        std::string& error_message);
   
-  // Optimaliseer JSON parsing
-  std::vector<TodoistTask> parse_tasks_json(const std::string &json);
-  bool parse_tasks_json_internal(const std::string &json, std::vector<TodoistTask>& tasks, std::string& error_message);
+  // Hergebruikt de open verbinding of maakt een nieuwe (met timing van DNS en connect)
+  bool ensure_connected_(std::string& error_message);
+  // Opens the connection and checks the status code; the caller reads the body and calls http_.end()
+  bool send_request_(const std::string& url, const std::string& method, const std::string& body,
+                     int32_t &status_code, std::string& error_message);
+  
+  // Streaming parser: leest de array element voor element, peak memory is één taak
+  bool parse_tasks_stream(Stream &stream, TaskStore& tasks, std::string& error_message);
+  // Idem voor een Sync API response; items zonder deadline, voltooid of verwijderd worden tombstones.
+  // full_sync gaat erin als de aangevraagde soort sync en komt eruit zoals de server hem meldt.
+  // Past niet alles in changes, dan is dat een fout, zodat het sync token niet opschuift.
+  bool parse_sync_stream(Stream &stream, TaskStore& changes, bool &full_sync, std::string &sync_token,
+                         std::string& error_message);
 };
 
 }  // namespace todoist
@@ -0,0 +1,159 @@
+#include "todoist_body_stream.h"
+
+namespace esphome {
+namespace todoist {
+
+BodyStream::BodyStream(Client &client, int32_t content_length, bool chunked, uint8_t *buffer, size_t buffer_size)
+    : client_(client),
+      chunked_(chunked),
+      remaining_(chunked ? 0 : content_length),
+      buffer_(buffer),
+      buffer_size_(buffer_size) {
+  setTimeout(client.getTimeout());
+}
+
+int BodyStream::read_blocking_() {
+  uint32_t start = millis();
+  do {
+    int c = client_.read();
+    if (c >= 0)
+      return c;
+    yield();
+  } while (millis() - start < getTimeout());
+  return -1;
+}
+
+bool BodyStream::next_chunk_() {
+  // Na de data van een chunk volgt nog een CRLF
+  if (!first_chunk_) {
+    int c;
+    while ((c = read_blocking_()) != '\n') {
+      if (c < 0)
+        return false;
+    }
+  }
+  first_chunk_ = false;
+
+  // Chunk header: hex lengte, optioneel ";extensies", dan CRLF
+  int32_t size = 0;
+  bool digits = false;
+  bool extension = false;
+  while (true) {
+    int c = read_blocking_();
+    if (c < 0)
+      return false;
+    if (c == '\n')
+      break;
+    if (c == ';')
+      extension = true;
+    if (extension || !isxdigit(c))
+      continue;
+    size = size * 16 + (isdigit(c) ? c - '0' : (tolower(c) - 'a' + 10));
+    digits = true;
+  }
+  if (!digits)
+    return false;
+
+  if (size == 0) {
+    // Laatste chunk: trailers overslaan tot de lege regel
+    size_t line_length = 0;
+    while (true) {
+      int c = read_blocking_();
+      if (c < 0)
+        return false;
+      if (c == '\n') {
+        if (line_length == 0)
+          break;
+        line_length = 0;
+      } else if (c != '\r') {
+        line_length++;
+      }
+    }
+    finished_ = true;
+    return false;
+  }
+
+  remaining_ = size;
+  return true;
+}
+
+bool BodyStream::ensure_data_() {
+  if (finished_)
+    return false;
+  if (remaining_ == 0) {
+    if (!chunked_) {
+      finished_ = true;
+      return false;
+    }
+    return next_chunk_();
+  }
+  return true;
+}
+
+bool BodyStream::fill_() {
+  if (pos_ < len_)
+    return true;
+  if (!ensure_data_())
+    return false;
+
+  size_t want = buffer_size_;
+  if (remaining_ > 0 && (size_t) remaining_ < want)
+    want = remaining_;
+  int n = client_.read(buffer_, want);
+  if (n <= 0)
+    return false;  // Data is nog onderweg
+  pos_ = 0;
+  len_ = n;
+  bytes_read_ += n;
+  if (remaining_ > 0)
+    remaining_ -= n;
+  return true;
+}
+
+int BodyStream::available() {
+  if (pos_ < len_)
+    return len_ - pos_;
+  if (finished_)
+    return 0;
+  int available = client_.available();
+  if (remaining_ > 0 && available > remaining_)
+    return remaining_;
+  // Op een chunk grens is dit een schatting: er staat in elk geval een header klaar
+  return remaining_ == 0 ? (available > 0 ? 1 : 0) : available;
+}
+
+int BodyStream::read() {
+  if (!fill_())
+    return -1;
+  return buffer_[pos_++];
+}
+
+int BodyStream::peek() {
+  if (!fill_())
+    return -1;
+  return buffer_[pos_];
+}
+
+bool BodyStream::drain(size_t max_bytes) {
+  if (remaining_ < 0)
+    return false;  // Body loopt tot de verbinding sluit
+  size_t drained = 0;
+  uint32_t start = millis();
+  while (!finished_) {
+    if (fill_()) {
+      drained += len_ - pos_;
+      pos_ = len_;
+      if (drained > max_bytes)
+        return false;
+      start = millis();
+    } else if (finished_ || millis() - start >= getTimeout()) {
+      break;
+    } else {
+      yield();
+    }
+  }
+  return finished_;
+}
+
+}  // namespace todoist
+}  // namespace esphome
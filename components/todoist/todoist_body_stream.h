@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace esphome {
+namespace todoist {
+
+// Leest precies één HTTP/1.1 response body van een keep-alive verbinding: stopt bij Content-Length
+// of decodeert chunked transfer encoding, zodat de parser nooit voorbij de body leest. De data
+// komt in blokken uit de (TLS) client in een buffer van de aanroeper, zodat de parser per teken
+// alleen uit het geheugen leest en de body nooit in zijn geheel op de heap staat.
+class BodyStream : public Stream {
+ public:
+  // content_length < 0 betekent onbekend (alleen geldig met chunked)
+  BodyStream(Client &client, int32_t content_length, bool chunked, uint8_t *buffer, size_t buffer_size);
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t) override { return 0; }
+  void flush() override {}
+
+  // Body bytes die tot nu toe van de verbinding gelezen zijn
+  size_t bytes_read() const { return bytes_read_; }
+
+  // Leest de rest van de body weg (maximaal max_bytes); false als de verbinding niet meer
+  // herbruikbaar is omdat er nog data van deze response op staat
+  bool drain(size_t max_bytes);
+
+ protected:
+  // Zorgt dat er body data klaarstaat; leest zo nodig de volgende chunk header
+  bool ensure_data_();
+  bool next_chunk_();
+  int read_blocking_();
+  // Vult de buffer als hij leeg is, met hooguit de rest van de body of chunk; false als er nu
+  // (nog) niets te lezen is
+  bool fill_();
+
+  Client &client_;
+  bool chunked_;
+  bool first_chunk_ = true;
+  bool finished_ = false;
+  int32_t remaining_;  // Bytes over in de body of de huidige chunk (nog niet in de buffer), -1 = tot de verbinding sluit
+  uint8_t *buffer_;
+  size_t buffer_size_;
+  size_t pos_ = 0;
+  size_t len_ = 0;
+  size_t bytes_read_ = 0;
+};
+
+}  // namespace todoist
+}  // namespace esphome
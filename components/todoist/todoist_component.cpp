@@ -2,12 +2,25 @@
 #include "esphome/core/log.h"
 #include "esphome/core/application.h"
 #include <ctime>
+#include <cstring>
+#include <algorithm>
 
 namespace esphome {
 namespace todoist {
 
 static const char *const TAG = "todoist";
 
+// Snapshot pas wegschrijven als de lijst zo lang niet veranderd is
+static const uint32_t SNAPSHOT_DELAY_MS = 30000;
+// Verversen nadat Todoist completions bevestigd heeft (bijv. voor de nieuwe datum van een
+// terugkerende taak); completions binnen dit venster leveren samen één fetch op
+static const uint32_t COMPLETION_REFRESH_DELAY_MS = 5000;
+
+static void *handle_to_user_data(TaskHandle handle) { return reinterpret_cast<void *>(static_cast<uintptr_t>(handle)); }
+static TaskHandle handle_from_event(lv_event_t *e) {
+  return static_cast<TaskHandle>(reinterpret_cast<uintptr_t>(lv_obj_get_user_data(lv_event_get_current_target(e))));
+}
+
 TodoistComponent::TodoistComponent() {
   // Check if API object creation is successful
   api_ = std::unique_ptr<TodoistApi>(new TodoistApi());
@@ -63,7 +76,9 @@ void TodoistComponent::setup() {
   lv_obj_set_size(task_list_, LV_PCT(100), LV_PCT(100));
   lv_obj_set_pos(task_list_, 0, 0); // Start vanaf bovenkant
   lv_obj_set_style_bg_color(task_list_, lv_color_hex(0x303030), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-  lv_obj_set_style_pad_row(task_list_, 8, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT)); // Verhoog ruimte tussen items
+  // Geen flex layout: rijen krijgen een vaste y positie, zodat alleen het zichtbare deel
+  // van de lijst als LVGL objecten hoeft te bestaan (ROW_GAP is de ruimte tussen items)
+  lv_obj_set_layout(task_list_, 0);
   lv_obj_set_style_pad_column(task_list_, 0, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
   lv_obj_set_style_pad_all(task_list_, 10, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
   
@@ -72,6 +87,22 @@ void TodoistComponent::setup() {
   lv_obj_clear_flag(task_list_, LV_OBJ_FLAG_SCROLL_ELASTIC); // Verwijder elastisch scrollen
   lv_obj_set_style_bg_opa(lv_scr_act(), LV_OPA_COVER, 0); // Achtergrond volledig ondoorzichtig
 
+  // Onzichtbare spacer aan het einde van de lijst houdt het scrollbereik op de volledige lengte
+  spacer_ = lv_obj_create(task_list_);
+  if (spacer_ != nullptr) {
+    lv_obj_remove_style_all(spacer_);
+    lv_obj_set_size(spacer_, 1, 1);
+    lv_obj_clear_flag(spacer_, LV_OBJ_FLAG_CLICKABLE);
+  }
+
+  // Bij scrollen worden rijen buiten beeld gerecycled voor de rijen die in beeld komen
+  lv_obj_add_event_cb(task_list_, [](lv_event_t *e) {
+    TodoistComponent *component = static_cast<TodoistComponent*>(lv_event_get_user_data(e));
+    if (component) {
+      component->sync_window_();
+    }
+  }, LV_EVENT_SCROLL, this);
+
   // Create loading indicator
   loading_label_ = lv_label_create(main_container_);
   if (loading_label_ == nullptr) {
@@ -131,70 +162,254 @@ void TodoistComponent::setup() {
   // Log geheugengebruik
   ESP_LOGI(TAG, "Free heap after UI setup: %d", esp_get_free_heap_size());
 
-  // Vertraag de eerste fetch om systeem tijd te geven om op te starten 
-  last_update_ = millis() / 1000; // Stel de laatste update in op nu
+  // HTTP requests draaien op een eigen taak, zodat lv_timer_handler() niet blokkeert
+  api_->start();
+  api_->set_on_tasks_closed([this]() { this->request_fetch_(COMPLETION_REFRESH_DELAY_MS); });
+
+  // Laatste bekende lijst direct tonen; de fetch hieronder ververst hem op de achtergrond
+  if (snapshot_enabled_ && snapshot_.setup() && snapshot_.load(tasks_)) {
+    drop_pending_completions_();
+    render_tasks_();
+    show_loading_(false);
+  }
+
+  // Boot telt als activiteit: de eerste polls volgen het korte interval
+  scheduler_.on_activity(millis());
   fetch_tasks_(); // Start de eerste fetch
 }
 
 void TodoistComponent::loop() {
-  // No try-catch block here
-  uint32_t now = millis() / 1000; // current time in seconds
+  // Resultaten van de netwerktaak afhandelen; de callbacks raken LVGL dus moeten hier draaien
+  api_->loop();
+
+  // Taken lokaal opnieuw indelen bij middernacht of als een due tijd verstrijkt, zonder fetch
+  update_due_classes_();
+
+  save_snapshot_();
 
   // Check if it's time to update tasks
-  // Use subtraction to handle potential millis() overflow
-  if (now - last_update_ >= update_interval_) {
+  update_activity_();
+  if (scheduler_.should_poll(millis())) {
     fetch_tasks_();
-    last_update_ = now;
+  } else if (fetch_pending_ && !fetch_in_flight_ && (int32_t) (millis() - fetch_pending_at_) >= 0) {
+    execute_fetch_();
+  }
+}
+
+void TodoistComponent::update_activity_() {
+  // LVGL zet de inactieve tijd terug bij elke touch; ook als ha_deck het scherm dimt na inactivity
+  uint32_t inactive_ms = lv_disp_get_inactive_time(nullptr);
+  if (inactive_ms < last_inactive_ms_) {
+    scheduler_.on_activity(millis());
   }
-  // No catch blocks
+  last_inactive_ms_ = inactive_ms;
 }
 
 float TodoistComponent::get_setup_priority() const { 
   return setup_priority::LATE; 
 }
 
+void TodoistComponent::update_due_classes_() {
+  if (time_ == nullptr) return;
+  time_t now = ::time(nullptr);
+  if (now < next_transition_) return;
+
+  ESPTime local = time_->now();
+  if (!local.is_valid()) {
+    next_transition_ = now + 1;  // Nog geen tijd via SNTP, over een seconde opnieuw
+    return;
+  }
+
+  // Begin van de lokale dag; bij een DST wissel klopt dit een uur niet, dan rekenen we gewoon
+  // bij de volgende overgang opnieuw
+  uint16_t minute = local.hour * 60 + local.minute;
+  time_t day_start = local.timestamp - (minute * 60 + local.second);
+  today_ = days_from_civil(local.year, local.month, local.day_of_month);
+  minute_ = minute;
+
+  size_t changed = tasks_.reclassify(today_, minute_);
+  if (changed > 0) {
+    ESP_LOGI(TAG, "%u tasks changed due status, updating rows", (unsigned) changed);
+    render_tasks_();
+  }
+
+  // Volgende overgang: de eerstvolgende due tijd van vandaag of anders middernacht
+  int32_t next_minute = tasks_.next_due_minute();
+  next_transition_ = day_start + (next_minute >= 0 ? next_minute * 60 : 24 * 60 * 60);
+  ESP_LOGD(TAG, "Next due status change in %d s", (int) (next_transition_ - now));
+}
+
 void TodoistComponent::set_api_key(const std::string &api_key) {
   api_->set_api_key(api_key);
   ESP_LOGI(TAG, "Todoist API key set %s", !api_key.empty() ? "(valid)" : "(empty)");
 }
 
-void TodoistComponent::fetch_tasks_() {
-  ESP_LOGI(TAG, "Fetching Todoist tasks...");
-  show_loading_(true);
+void TodoistComponent::set_api_url(const std::string &api_url) {
+  if (!api_->set_base_url(api_url)) {
+    ESP_LOGE(TAG, "Ignoring invalid API URL %s", api_url.c_str());
+  }
+}
+
+void TodoistComponent::fetch_tasks_() { request_fetch_(0); }
+
+void TodoistComponent::request_fetch_(uint32_t delay_ms) {
+  fetches_triggered_++;
+  if (fetch_in_flight_) {
+    // Het resultaat van de lopende fetch kan al ouder zijn dan deze trigger
+    fetch_follow_up_ = true;
+    return;
+  }
+  if (delay_ms == 0) {
+    execute_fetch_();
+    return;
+  }
+  // Debounce: elke nieuwe trigger schuift de fetch op
+  fetch_pending_ = true;
+  fetch_pending_at_ = millis() + delay_ms;
+}
+
+void TodoistComponent::fetch_done_(bool ok) {
+  fetch_in_flight_ = false;
+  publish_counters_();
+  // Na een fout beslissen de scheduler en de circuit breaker over de volgende poging
+  if (ok && fetch_follow_up_) {
+    ESP_LOGD(TAG, "Running follow-up fetch for triggers during the previous one");
+    execute_fetch_();
+  }
+  fetch_follow_up_ = false;
+}
+
+void TodoistComponent::publish_counters_() {
+  const uint32_t values[COUNTER_COUNT] = {
+      api_->get_not_modified_count(),
+      api_->get_full_fetch_count(),
+      fetches_triggered_,
+      fetches_executed_,
+  };
+  for (uint8_t i = 0; i < COUNTER_COUNT; i++) {
+    sensor::Sensor *sensor = counter_sensors_[i];
+    // Alleen bij een nieuwe waarde, anders gaat er na elke poll een identieke state naar HA
+    if (sensor != nullptr && (!sensor->has_state() || sensor->state != values[i])) {
+      sensor->publish_state(values[i]);
+    }
+  }
+}
+
+void TodoistComponent::execute_fetch_() {
+  fetch_pending_ = false;
+  fetch_follow_up_ = false;
+  fetch_in_flight_ = true;
+  fetches_executed_++;
+  ESP_LOGI(TAG, "Fetching Todoist tasks (%u fetches for %u triggers)...", (unsigned) fetches_executed_,
+           (unsigned) fetches_triggered_);
+  scheduler_.on_poll(millis());
+  // Alleen de laadmelding tonen als er nog geen lijst zichtbaar is; een achtergrondverversing
+  // laat de bestaande rijen staan
+  if (rows_.empty() || lv_obj_has_flag(task_list_, LV_OBJ_FLAG_HIDDEN)) {
+    show_loading_(true);
+  }
   
-  // Tijdelijke label om aan te geven dat een taak wordt voltooid
-  static bool completing_task = false;
+  auto on_error = [this](std::string error) {
+    ESP_LOGE(TAG, "Failed to fetch tasks: %s", error.c_str());
+    this->scheduler_.on_failure(millis(), this->api_->get_retry_after() * 1000);
+    // Offline-first: een lijst die al op het scherm staat (bijv. uit de snapshot) blijft staan
+    if (this->rows_.empty() || lv_obj_has_flag(this->task_list_, LV_OBJ_FLAG_HIDDEN)) {
+      this->show_error_("Connection error: " + error);
+    }
+    this->fetch_done_(false);
+  };
   
-  // Voeg abort mechanisme toe om multiple requests te voorkomen
-  if (completing_task) {
-    ESP_LOGI(TAG, "Task completion still in progress, waiting...");
+  if (incremental_sync_) {
+    // Alleen wijzigingen sinds de vorige sync; een lege delta hoeft niet opnieuw gerenderd te worden
+    api_->sync_tasks([this](TaskStore &&changes, bool full_sync) {
+      if (full_sync || !changes.empty()) {
+        if (!this->tasks_.apply_changes(changes, full_sync)) {
+          // De lijst op het scherm blijft staan; een volledige sync kan wel weer passen
+          ESP_LOGE(TAG, "Task store full, %u changes not applied", (unsigned) changes.size());
+          this->api_->request_full_sync();
+          this->scheduler_.on_failure(millis(), 0);
+          this->fetch_done_(false);
+          return;
+        }
+        this->drop_pending_completions_();
+        this->next_transition_ = 0;  // Nieuwe taken kunnen een eerdere due tijd hebben
+        ESP_LOGI(TAG, "Task sync complete, %u changes, %u tasks", (unsigned) changes.size(), (unsigned) this->tasks_.size());
+        this->tasks_changed_();
+        this->render_tasks_();
+      }
+      this->scheduler_.on_success(millis(), full_sync || !changes.empty());
+      this->show_loading_(false);
+      this->fetch_done_(true);
+    }, on_error);
     return;
   }
   
-  api_->fetch_tasks([this](std::vector<TodoistTask> tasks) {
-    ESP_LOGI(TAG, "Task fetch complete with %d tasks", tasks.size());
-    this->tasks_ = tasks;
-    this->render_tasks_();
+  api_->fetch_tasks([this](TaskStore &&tasks, bool modified) {
+    // Bij 304 Not Modified staat de huidige lijst al goed op het scherm
+    if (modified) {
+      ESP_LOGI(TAG, "Task fetch complete with %u tasks", (unsigned) tasks.size());
+      this->tasks_ = std::move(tasks);
+      this->drop_pending_completions_();
+      this->tasks_.reclassify(this->today_, this->minute_);
+      this->next_transition_ = 0;  // Nieuwe taken kunnen een eerdere due tijd hebben
+      this->tasks_changed_();
+      this->render_tasks_();
+    }
+    this->scheduler_.on_success(millis(), modified);
     this->show_loading_(false);
-    completing_task = false; // Reset de flag
-  }, [this](std::string error) {
-    ESP_LOGE(TAG, "Failed to fetch tasks: %s", error.c_str());
-    this->show_error_("Connection error: " + error);
-    completing_task = false; // Reset de flag ook in geval van fouten
-  });
+    this->fetch_done_(true);
+  }, on_error);
+}
+
+void TodoistComponent::complete_task_(const std::string &task_id) {
+  if (!api_->complete_task(task_id)) {
+    ESP_LOGW(TAG, "Could not queue completion of task %s", task_id.c_str());
+    return;
+  }
+
+  // Optimistisch: de rij verdwijnt meteen, de outbox zorgt dat Todoist het ook te horen krijgt
+  int index = tasks_.find(task_id.c_str());
+  if (index >= 0) {
+    tasks_.remove(index);
+    tasks_changed_();
+    render_tasks_();
+  }
+}
+
+void TodoistComponent::tasks_changed_() {
+  task_handles_.rebind(tasks_);
+  snapshot_dirty_ = true;
+  snapshot_changed_ = millis();
+}
+
+void TodoistComponent::save_snapshot_() {
+  if (!snapshot_dirty_ || !snapshot_enabled_) return;
+  // Wissen en schrijven blokkeert de loop even; wachten tot een reeks wijzigingen voorbij is
+  if (millis() - snapshot_changed_ < SNAPSHOT_DELAY_MS) return;
+  snapshot_dirty_ = false;
+  snapshot_.save(tasks_);
+}
+
+void TodoistComponent::drop_pending_completions_() {
+  // Een fetch of sync kan ouder zijn dan een completion die nog in de outbox staat
+  const Outbox &outbox = api_->outbox();
+  for (size_t i = 0; i < outbox.size(); i++) {
+    int index = tasks_.find(outbox[i].task_id);
+    if (index >= 0) {
+      tasks_.remove(index);
+    }
+  }
 }
 
 void TodoistComponent::show_loading_(bool show) {
   if (loading_label_ == nullptr) return;
   
+  // Via set_hidden_, zodat een verversing die niets verandert ook niets opnieuw tekent
+  set_hidden_(loading_label_, !show);
+  set_hidden_(task_list_, show);
   if (show) {
-    lv_obj_clear_flag(loading_label_, LV_OBJ_FLAG_HIDDEN);
-    if (task_list_ != nullptr) lv_obj_add_flag(task_list_, LV_OBJ_FLAG_HIDDEN);
-    if (error_label_ != nullptr) lv_obj_add_flag(error_label_, LV_OBJ_FLAG_HIDDEN);
-    if (retry_btn_ != nullptr) lv_obj_add_flag(retry_btn_, LV_OBJ_FLAG_HIDDEN);
-  } else {
-    lv_obj_add_flag(loading_label_, LV_OBJ_FLAG_HIDDEN);
-    if (task_list_ != nullptr) lv_obj_clear_flag(task_list_, LV_OBJ_FLAG_HIDDEN);
+    set_hidden_(error_label_, true);
+    set_hidden_(retry_btn_, true);
   }
 }
 
@@ -205,14 +420,60 @@ void TodoistComponent::show_error_(const std::string &message) {
   
   // Show error message
   lv_label_set_text(error_label_, message.c_str());
-  lv_obj_clear_flag(error_label_, LV_OBJ_FLAG_HIDDEN);
+  set_hidden_(error_label_, false);
   
   // Show retry button
-  if (retry_btn_ != nullptr) lv_obj_clear_flag(retry_btn_, LV_OBJ_FLAG_HIDDEN);
+  set_hidden_(retry_btn_, false);
   
   // Hide other elements
-  if (loading_label_ != nullptr) lv_obj_add_flag(loading_label_, LV_OBJ_FLAG_HIDDEN);
-  if (task_list_ != nullptr) lv_obj_add_flag(task_list_, LV_OBJ_FLAG_HIDDEN);
+  set_hidden_(loading_label_, true);
+  set_hidden_(task_list_, true);
+}
+
+// FNV-1a, genoeg om te zien of de zichtbare inhoud van een rij veranderd is
+static uint32_t hash_str(const char *s, uint32_t hash = 2166136261u) {
+  while (*s) {
+    hash = (hash ^ (uint8_t) *s++) * 16777619u;
+  }
+  return hash;
+}
+
+static uint32_t hash_int(uint32_t value, uint32_t hash) {
+  return (hash ^ value) * 16777619u;
+}
+
+// Tekst rechts in een taakrij: de tijd voor taken van vandaag, de due string voor latere taken
+static TodoistComponent::AuxKind task_aux(TaskStore::TaskRef task, std::string &text) {
+  if (*task.due_string() == '\0')
+    return TodoistComponent::AUX_NONE;
+  if (task.is_due_today()) {
+    text = task.get_due_time();
+    return text.empty() ? TodoistComponent::AUX_NONE : TodoistComponent::AUX_TIME;
+  }
+  if (!task.is_overdue()) {
+    text = task.due_string();
+    return TodoistComponent::AUX_DUE;
+  }
+  return TodoistComponent::AUX_NONE;
+}
+
+static uint32_t task_hash(TaskStore::TaskRef task, bool is_overdue) {
+  std::string aux_text;
+  TodoistComponent::AuxKind aux = task_aux(task, aux_text);
+  uint32_t hash = hash_str(task.content());
+  hash = hash_str(aux_text.c_str(), hash_int(aux, hash));
+  hash = hash_int(task.priority(), hash);
+  return hash_int(is_overdue, hash);
+}
+
+void TodoistComponent::set_hidden_(lv_obj_t *obj, bool hidden) {
+  // Alleen de flag aanraken als die verandert; lv_obj_clear_flag invalideert altijd
+  if (obj == nullptr || lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN) == hidden) return;
+  if (hidden) {
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+  } else {
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+  }
 }
 
 void TodoistComponent::render_tasks_() {
@@ -220,95 +481,217 @@ void TodoistComponent::render_tasks_() {
     ESP_LOGE(TAG, "Cannot render tasks: task_list_ is null");
     return;
   }
+  uint32_t start = micros();
+
+  // Filter voor overdue en today taken, als indices in de store
+  std::vector<uint16_t> overdue_tasks;
+  std::vector<uint16_t> today_tasks;
+
+  for (size_t i = 0; i < tasks_.size(); i++) {
+    TaskStore::TaskRef task = tasks_[i];
+    if (task.is_overdue()) {
+      overdue_tasks.push_back(i);
+    } else if (task.is_due_today()) {
+      today_tasks.push_back(i);
+    }
+  }
 
-  // Clear current task list
-  lv_obj_clean(task_list_);
-
-  // Beperk het aantal taken dat we tegelijk tonen
-  const size_t MAX_TASKS_PER_SECTION = 5;
-
-  // Filter voor overdue en today taken
-  std::vector<TodoistTask> overdue_tasks;
-  std::vector<TodoistTask> today_tasks;
+  // Het model bevat alle rijen met een vaste y positie; alleen het zichtbare deel krijgt
+  // LVGL objecten (zie sync_window_)
+  model_.clear();
+  model_.reserve(overdue_tasks.size() + today_tasks.size() + 2);
+  lv_coord_t y = 0;
+  auto add = [this, &y](RowKind kind, int16_t index, uint32_t hash, bool is_overdue) {
+    model_.push_back({kind, index, hash, is_overdue, y});
+    y += row_height_(kind) + ROW_GAP;
+  };
 
-  for (const auto &task : tasks_) {
-    if (task.is_overdue() && overdue_tasks.size() < MAX_TASKS_PER_SECTION) {
-      overdue_tasks.push_back(task);
-    } else if (task.is_due_today() && today_tasks.size() < MAX_TASKS_PER_SECTION) {
-      today_tasks.push_back(task);
+  if (overdue_tasks.empty() && today_tasks.empty()) {
+    add(ROW_EMPTY, -1, 0, false);
+  }
+  if (!overdue_tasks.empty()) {
+    add(ROW_OVERDUE_HEADER, -1, 0, false);
+    for (uint16_t index : overdue_tasks) {
+      add(ROW_TASK, (int16_t) index, task_hash(tasks_[index], true), true);
+    }
+  }
+  if (!today_tasks.empty()) {
+    add(ROW_TODAY_HEADER, -1, 0, false);
+    for (uint16_t index : today_tasks) {
+      add(ROW_TASK, (int16_t) index, task_hash(tasks_[index], false), false);
     }
   }
 
-  // Toon waarschuwingen als we taken hebben weggelaten
-  if (overdue_tasks.size() == MAX_TASKS_PER_SECTION) {
-    ESP_LOGW(TAG, "Limiting overdue tasks display to %d items", MAX_TASKS_PER_SECTION);
+  // De spacer onderaan bepaalt het scrollbereik, er staan immers niet altijd rijen onderaan
+  lv_coord_t content_height = y > 0 ? y - ROW_GAP : 0;
+  if (spacer_ != nullptr && lv_obj_get_y(spacer_) != content_height - 1) {
+    lv_obj_set_y(spacer_, content_height - 1);
   }
-  if (today_tasks.size() == MAX_TASKS_PER_SECTION) {
-    ESP_LOGW(TAG, "Limiting today's tasks display to %d items", MAX_TASKS_PER_SECTION);
+
+  // Is de lijst korter geworden, dan niet voorbij het einde blijven staan
+  lv_obj_update_layout(task_list_);
+  lv_coord_t scroll_bottom = lv_obj_get_scroll_bottom(task_list_);
+  if (scroll_bottom < 0) {
+    lv_coord_t scroll_y = lv_obj_get_scroll_y(task_list_) + scroll_bottom;
+    lv_obj_scroll_to_y(task_list_, scroll_y > 0 ? scroll_y : 0, LV_ANIM_OFF);
   }
 
-  // Als er geen taken zijn, toon een lege melding
-  if (overdue_tasks.empty() && today_tasks.empty()) {
-    lv_obj_t *no_tasks = lv_label_create(task_list_);
-    if (no_tasks) {
-      lv_label_set_text(no_tasks, "Geen taken voor vandaag of over de tijd!");
-      lv_obj_set_style_text_color(no_tasks, lv_color_hex(0xCCCCCC), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-      lv_obj_set_style_text_font(no_tasks, &lv_font_montserrat_16, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-      lv_obj_center(no_tasks);
+  sync_window_();
+
+  ESP_LOGI(TAG, "Tasks rendered in %u us: %u overdue, %u today (%u live rows, %u pooled, %u created in total)",
+           (unsigned) (micros() - start), (unsigned) overdue_tasks.size(), (unsigned) today_tasks.size(),
+           (unsigned) rows_.size(), (unsigned) free_rows_.size(), (unsigned) rows_created_);
+}
+
+lv_coord_t TodoistComponent::row_height_(RowKind kind) {
+  return kind == ROW_TASK ? TASK_ROW_HEIGHT : HEADER_ROW_HEIGHT;
+}
+
+void TodoistComponent::sync_window_() {
+  if (task_list_ == nullptr) return;
+
+  // Zichtbaar deel van de lijst plus overscan, in content coördinaten
+  const lv_coord_t overscan = OVERSCAN_ROWS * (TASK_ROW_HEIGHT + ROW_GAP);
+  lv_coord_t top = lv_obj_get_scroll_y(task_list_) - overscan;
+  lv_coord_t bottom = lv_obj_get_scroll_y(task_list_) + lv_obj_get_content_height(task_list_) + overscan;
+
+  // Het model is op y gesorteerd
+  auto first = std::lower_bound(model_.begin(), model_.end(), top, [](const RowSpec &spec, lv_coord_t value) {
+    return spec.y + row_height_(spec.kind) < value;
+  });
+  auto last = first;
+  while (last != model_.end() && last->y <= bottom) {
+    ++last;
+  }
+
+  // Bestaande rijen worden op sleutel (taak id of rijsoort) gematcht; alleen wat echt
+  // verandert wordt bijgewerkt. Rijen buiten het venster gaan terug naar de pool.
+  auto matches = [this](const RenderedRow &row, const RowSpec &spec) {
+    if (row.obj == nullptr || row.kind != spec.kind) return false;
+    return spec.kind != ROW_TASK || row.id == tasks_[spec.index].id();
+  };
+
+  for (auto it = rows_.begin(); it != rows_.end();) {
+    if (std::any_of(first, last, [&](const RowSpec &spec) { return matches(*it, spec); })) {
+      ++it;
+    } else {
+      set_hidden_(it->obj, true);
+      task_handles_.release(it->handle);
+      it->handle = TASK_HANDLE_NONE;
+      free_rows_.push_back(*it);
+      it = rows_.erase(it);
     }
-    return;
   }
 
-  // Voeg een sectieheader toe voor overdue taken
-  if (!overdue_tasks.empty()) {
-    lv_obj_t *header = lv_label_create(task_list_);
-    if (header) {
-      lv_label_set_text(header, "OVER DE TIJD");
-      lv_obj_set_style_text_color(header, lv_color_hex(0xFF5555), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-      lv_obj_set_style_text_font(header, &lv_font_montserrat_16, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-      lv_obj_set_width(header, LV_PCT(100));
-      lv_obj_set_style_pad_top(header, 5, 0);
-      lv_obj_set_style_pad_bottom(header, 5, 0);
+  std::vector<RenderedRow> rows;
+  rows.reserve(last - first);
+  for (auto spec = first; spec != last; ++spec) {
+    RenderedRow row;
+    auto existing = std::find_if(rows_.begin(), rows_.end(), [&](const RenderedRow &r) { return matches(r, *spec); });
+    auto recycled = std::find_if(free_rows_.begin(), free_rows_.end(), [&](const RenderedRow &r) { return r.kind == spec->kind; });
+    if (existing != rows_.end()) {
+      row = *existing;
+      existing->obj = nullptr;  // Niet nog een keer matchen
+      if (row.hash != spec->hash) {
+        update_row_(row, *spec);
+      }
+    } else if (recycled != free_rows_.end()) {
+      // Rij uit de pool opnieuw binden aan een andere taak
+      row = *recycled;
+      free_rows_.erase(recycled);
+      if (row.hash != spec->hash || spec->kind == ROW_TASK) {
+        update_row_(row, *spec);
+      }
+      set_hidden_(row.obj, false);
+    } else if (create_row_(row, *spec)) {
+      rows_created_++;
+    } else {
+      continue;
     }
 
-    for (const auto &task : overdue_tasks) {
-      add_task_item_(task, true); // overdue = true
+    // Een handle volgt zijn taak via rebind; alleen een rij die aan een andere taak gebonden
+    // wordt krijgt een nieuwe
+    if (spec->kind == ROW_TASK && task_handles_.resolve(row.handle) != spec->index) {
+      task_handles_.release(row.handle);
+      row.handle = task_handles_.acquire(tasks_, spec->index);
+      lv_obj_set_user_data(row.obj, handle_to_user_data(row.handle));
+      if (row.complete_btn != nullptr) lv_obj_set_user_data(row.complete_btn, handle_to_user_data(row.handle));
     }
-  }
 
-  // Voeg een sectieheader toe voor taken van vandaag
-  if (!today_tasks.empty()) {
-    lv_obj_t *header = lv_label_create(task_list_);
-    if (header) {
-      lv_label_set_text(header, "VANDAAG");
-      lv_obj_set_style_text_color(header, lv_color_hex(0x55FF55), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-      lv_obj_set_style_text_font(header, &lv_font_montserrat_16, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-      lv_obj_set_width(header, LV_PCT(100));
-      lv_obj_set_style_pad_top(header, 10, 0);
-      lv_obj_set_style_pad_bottom(header, 5, 0);
+    if (row.y != spec->y) {
+      lv_obj_set_y(row.obj, spec->y);
+      row.y = spec->y;
     }
+    rows.push_back(std::move(row));
+  }
+  rows_ = std::move(rows);
+}
+
+bool TodoistComponent::create_row_(RenderedRow &row, const RowSpec &spec) {
+  row.kind = spec.kind;
+  row.hash = spec.hash;
+  row.y = spec.y;
+
+  switch (spec.kind) {
+    case ROW_TASK:
+      row.id = tasks_[spec.index].id();
+      if (!add_task_item_(row, tasks_[spec.index], spec.is_overdue)) return false;
+      break;
+
+    case ROW_EMPTY:
+      // Als er geen taken zijn, toon een lege melding
+      row.obj = lv_label_create(task_list_);
+      if (row.obj == nullptr) return false;
+      lv_label_set_text(row.obj, "Geen taken voor vandaag of over de tijd!");
+      lv_obj_set_style_text_color(row.obj, lv_color_hex(0xCCCCCC), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
+      lv_obj_set_style_text_font(row.obj, &lv_font_montserrat_16, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
+      lv_obj_set_width(row.obj, LV_PCT(100));
+      lv_obj_set_style_text_align(row.obj, LV_TEXT_ALIGN_CENTER, 0);
+      break;
 
-    for (const auto &task : today_tasks) {
-      add_task_item_(task, false); // overdue = false
+    case ROW_OVERDUE_HEADER:
+    case ROW_TODAY_HEADER: {
+      // Sectieheader voor overdue taken of taken van vandaag
+      bool overdue = spec.kind == ROW_OVERDUE_HEADER;
+      row.obj = lv_label_create(task_list_);
+      if (row.obj == nullptr) return false;
+      lv_label_set_text(row.obj, overdue ? "OVER DE TIJD" : "VANDAAG");
+      lv_obj_set_style_text_color(row.obj, lv_color_hex(overdue ? 0xFF5555 : 0x55FF55), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
+      lv_obj_set_style_text_font(row.obj, &lv_font_montserrat_16, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
+      lv_obj_set_width(row.obj, LV_PCT(100));
+      lv_obj_set_style_pad_top(row.obj, overdue ? 5 : 10, 0);
+      lv_obj_set_style_pad_bottom(row.obj, 5, 0);
+      break;
     }
   }
 
-  ESP_LOGI(TAG, "Tasks rendered successfully: %d overdue, %d today", overdue_tasks.size(), today_tasks.size());
+  // Vaste hoogte, zodat de y positie van elke rij vooraf bekend is
+  lv_obj_set_height(row.obj, row_height_(spec.kind));
+  lv_obj_set_y(row.obj, spec.y);
+  return true;
+}
+
+void TodoistComponent::update_row_(RenderedRow &row, const RowSpec &spec) {
+  row.hash = spec.hash;
+  if (spec.kind == ROW_TASK) {
+    if (row.id != tasks_[spec.index].id()) row.id = tasks_[spec.index].id();
+    update_task_item_(row, tasks_[spec.index], spec.is_overdue);
+  }
 }
 
 // Nieuwe helper methode om taak items toe te voegen met consistente styling en complete knop
-void TodoistComponent::add_task_item_(const TodoistTask &task, bool is_overdue) {
+bool TodoistComponent::add_task_item_(RenderedRow &row, TaskStore::TaskRef task, bool is_overdue) {
   // Create list item for task
-  lv_obj_t *list_btn = lv_list_add_btn(task_list_, nullptr, task.content.c_str());
+  lv_obj_t *list_btn = lv_list_add_btn(task_list_, nullptr, task.content());
   if (list_btn == nullptr) {
-    ESP_LOGE(TAG, "Failed to create list button for task %s", task.id.c_str());
-    return;
+    ESP_LOGE(TAG, "Failed to create list button for task %s", task.id());
+    return false;
   }
+  row.obj = list_btn;
 
   // Verbeter de opmaak van taakitems
   lv_obj_set_style_bg_color(list_btn, lv_color_hex(0x404040), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
   lv_obj_set_style_bg_opa(list_btn, LV_OPA_COVER, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-  lv_obj_set_height(list_btn, LV_SIZE_CONTENT);  // Automatische hoogte op basis van inhoud
   lv_obj_set_width(list_btn, LV_PCT(98));  // Bijna volledige breedte
 
   // Prioriteitsindicator links
@@ -318,6 +701,7 @@ void TodoistComponent::add_task_item_(const TodoistTask &task, bool is_overdue)
 
   // Vergroot de tekstgrootte van de taaknaam
   lv_obj_t *label = lv_obj_get_child(list_btn, 0);
+  row.label = label;
   if (label != nullptr) {
     lv_obj_set_style_text_color(label, lv_color_hex(0xFFFFFF), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
     
@@ -335,36 +719,11 @@ void TodoistComponent::add_task_item_(const TodoistTask &task, bool is_overdue)
   }
 
   // Als de taak een deadline heeft, voeg dan een label toe
-  if (!task.due_string.empty()) {
-    // Toon tijd voor taken van vandaag
-    if (task.is_due_today()) {
-      // Haal tijd-informatie uit de due_date (als beschikbaar)
-      std::string time_str = task.get_due_time();
-      if (!time_str.empty()) {
-        lv_obj_t *time_label = lv_label_create(list_btn);
-        if (time_label != nullptr) {
-          lv_label_set_text(time_label, time_str.c_str());
-          lv_obj_set_style_text_color(time_label, lv_color_hex(0x55FF55), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-          lv_obj_set_style_text_font(time_label, &lv_font_montserrat_14, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-          // Positie links van de complete knop
-          lv_obj_align(time_label, LV_ALIGN_RIGHT_MID, -45, 0);
-        }
-      }
-    } 
-    // Toon due_string voor taken van morgen of later (zoals voorheen)
-    else if (!task.is_overdue()) {
-      lv_obj_t *due_label = lv_label_create(list_btn);
-      if (due_label != nullptr) {
-        lv_label_set_text(due_label, task.due_string.c_str());
-        lv_obj_set_style_text_color(due_label, lv_color_hex(0xAAAAAA), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-        lv_obj_set_style_text_font(due_label, &lv_font_montserrat_14, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
-        lv_obj_align(due_label, LV_ALIGN_BOTTOM_RIGHT, -45, -5);
-      }
-    }
-  }
+  set_aux_label_(row, task);
 
   // Voeg voltooien knop toe aan rechter kant - Fix vinkje symbool
   lv_obj_t *complete_btn = lv_btn_create(list_btn);
+  row.complete_btn = complete_btn;
   if (complete_btn) {
     lv_obj_set_size(complete_btn, 24, 24); // Kleinere knop
     lv_obj_align(complete_btn, LV_ALIGN_RIGHT_MID, -8, 0);
@@ -383,77 +742,85 @@ void TodoistComponent::add_task_item_(const TodoistTask &task, bool is_overdue)
     // Verbeter visuele feedback bij aanraking
     lv_obj_set_style_bg_color(complete_btn, lv_color_hex(0x1976D2), (lv_part_t)(LV_PART_MAIN | LV_STATE_PRESSED));
     
-    // Find original task for user data pointer
-    const TodoistTask* original_task_ptr = nullptr;
-    for(const auto& original_task : tasks_) {
-      if (original_task.id == task.id) {
-        original_task_ptr = &original_task;
-        break;
-      }
-    }
+    // De task handle wordt door sync_window_ in de user data gezet
     
-    if (original_task_ptr) {
-      // Opslaan van taak pointer in complete button data
-      lv_obj_set_user_data(complete_btn, (void*)original_task_ptr);
+    // Event handler toevoegen voor de voltooien knop
+    lv_obj_add_event_cb(complete_btn, [](lv_event_t *e) {
+      TodoistComponent *component = static_cast<TodoistComponent*>(lv_event_get_user_data(e));
+      int index = component ? component->task_handles_.resolve(handle_from_event(e)) : -1;
       
-      // Event handler toevoegen voor de voltooien knop
-      lv_obj_add_event_cb(complete_btn, [](lv_event_t *e) {
-        TodoistComponent *component = static_cast<TodoistComponent*>(lv_event_get_user_data(e));
-        const TodoistTask *task_ptr = static_cast<const TodoistTask*>(lv_obj_get_user_data(lv_event_get_current_target(e)));
-        
-        if (component && task_ptr) {
-          ESP_LOGI(TAG, "Complete button clicked for task: %s", task_ptr->id.c_str());
-          component->api_->complete_task(task_ptr->id, [component](bool success) {
-            if (success) {
-              ESP_LOGI(TAG, "Task completion successful, refreshing list.");
-              component->fetch_tasks_();
-            } else {
-              ESP_LOGW(TAG, "Task completion failed.");
-            }
-          });
-        }
-      }, LV_EVENT_CLICKED, this);
-      
-      // Stop propagation van click events, anders opent de taak ook de detailweergave
-      lv_obj_add_event_cb(complete_btn, [](lv_event_t *e) {
-        lv_event_stop_bubbling(e); // Voorkom dat de klik doorbubbelt naar de parent
-      }, LV_EVENT_CLICKED, nullptr);
-    }
+      if (index >= 0) {
+        std::string task_id = component->tasks_[index].id();
+        ESP_LOGI(TAG, "Complete button clicked for task: %s", task_id.c_str());
+        component->complete_task_(task_id);
+      }
+    }, LV_EVENT_CLICKED, this);
+    
+    // Stop propagation van click events, anders opent de taak ook de detailweergave
+    lv_obj_add_event_cb(complete_btn, [](lv_event_t *e) {
+      lv_event_stop_bubbling(e); // Voorkom dat de klik doorbubbelt naar de parent
+    }, LV_EVENT_CLICKED, nullptr);
   }
 
   // Event handlers voor het openen van details
   lv_obj_add_event_cb(list_btn, task_event_cb_, LV_EVENT_CLICKED, this);
-  
-  // Find original task for user data pointer
-  const TodoistTask* original_task_ptr = nullptr;
-  for(const auto& original_task : tasks_) {
-    if (original_task.id == task.id) {
-      original_task_ptr = &original_task;
-      break;
-    }
+  return true;
+}
+
+void TodoistComponent::update_task_item_(RenderedRow &row, TaskStore::TaskRef task, bool is_overdue) {
+  // Alleen wat zichtbaar anders is bijwerken; elke setter invalideert de rij
+  if (row.label != nullptr && strcmp(lv_label_get_text(row.label), task.content()) != 0) {
+    lv_label_set_text(row.label, task.content());
   }
-  
-  if (original_task_ptr) {
-    lv_obj_set_user_data(list_btn, (void*)original_task_ptr);
-  } else {
-    ESP_LOGW(TAG, "Could not find original task pointer for ID: %s", task.id.c_str());
+  lv_obj_set_style_border_color(row.obj, lv_color_hex(task.get_priority_color()), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
+  set_aux_label_(row, task);
+}
+
+void TodoistComponent::set_aux_label_(RenderedRow &row, TaskStore::TaskRef task) {
+  std::string text;
+  TodoistComponent::AuxKind aux = task_aux(task, text);
+
+  // Een ander soort label staat anders uitgelijnd; dat label vervangen we
+  if (row.aux_label != nullptr && row.aux != aux) {
+    lv_obj_del(row.aux_label);
+    row.aux_label = nullptr;
+  }
+  row.aux = aux;
+  if (aux == AUX_NONE) return;
+
+  if (row.aux_label == nullptr) {
+    row.aux_label = lv_label_create(row.obj);
+    if (row.aux_label == nullptr) return;
+    lv_obj_set_style_text_font(row.aux_label, &lv_font_montserrat_14, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
+    if (aux == AUX_TIME) {
+      // Tijd voor taken van vandaag, links van de complete knop
+      lv_obj_set_style_text_color(row.aux_label, lv_color_hex(0x55FF55), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
+      lv_obj_align(row.aux_label, LV_ALIGN_RIGHT_MID, -45, 0);
+    } else {
+      // Due string voor taken van morgen of later
+      lv_obj_set_style_text_color(row.aux_label, lv_color_hex(0xAAAAAA), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
+      lv_obj_align(row.aux_label, LV_ALIGN_BOTTOM_RIGHT, -45, -5);
+    }
+  } else if (strcmp(lv_label_get_text(row.aux_label), text.c_str()) == 0) {
+    return;
   }
+  lv_label_set_text(row.aux_label, text.c_str());
 }
 
 void TodoistComponent::task_event_cb_(lv_event_t *e) {
   TodoistComponent *component = static_cast<TodoistComponent*>(lv_event_get_user_data(e));
-  lv_obj_t *btn = lv_event_get_target(e);
   
-  // Get task from user data
-  TodoistTask *task = static_cast<TodoistTask*>(lv_obj_get_user_data(btn));
-  
-  if (component && task) {
-    component->on_task_click_(*task);
+  // Get task handle from user data
+  if (component) {
+    component->on_task_click_(handle_from_event(e));
   }
 }
 
-void TodoistComponent::on_task_click_(const TodoistTask &task) {
-  ESP_LOGI(TAG, "Task clicked: %s (%s)", task.content.c_str(), task.id.c_str());
+void TodoistComponent::on_task_click_(TaskHandle handle) {
+  int index = task_handles_.resolve(handle);
+  if (index < 0) return;
+  TaskStore::TaskRef task = tasks_[index];
+  ESP_LOGI(TAG, "Task clicked: %s (%s)", task.content(), task.id());
 
   // Create a modal popup for the task
   lv_obj_t *modal = lv_obj_create(lv_layer_top());
@@ -468,7 +835,7 @@ void TodoistComponent::on_task_click_(const TodoistTask &task) {
   // Task title - aangepast lettertype
   lv_obj_t *title = lv_label_create(modal);
   if (!title) { ESP_LOGE(TAG, "Failed to create modal title"); lv_obj_del(modal); return; }
-  lv_label_set_text(title, task.content.c_str());
+  lv_label_set_text(title, task.content());
   lv_obj_set_style_text_font(title, &lv_font_montserrat_16, (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT)); // Aangepast naar 16
   lv_obj_set_style_text_color(title, lv_color_hex(0xFFFFFF), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
   lv_obj_set_width(title, LV_PCT(90));
@@ -476,17 +843,17 @@ void TodoistComponent::on_task_click_(const TodoistTask &task) {
 
   // Due date if present
   lv_obj_t *due = nullptr; // Declare outside if block
-  if (!task.due_date.empty()) {
+  if (task.has_due_date()) {
     due = lv_label_create(modal);
     if (!due) { ESP_LOGE(TAG, "Failed to create modal due date"); /* Continue without due date */ }
     else {
       // Format due date
-      std::string due_text = "Due: " + task.due_string;
+      std::string due_text = std::string("Due: ") + task.due_string();
       if (task.is_overdue()) {
-        due_text = "OVERDUE: " + task.due_string;
+        due_text = std::string("OVERDUE: ") + task.due_string();
         lv_obj_set_style_text_color(due, lv_color_hex(0xFF5555), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
       } else if (task.is_due_today()) {
-        due_text = "Due Today: " + task.due_string;
+        due_text = std::string("Due Today: ") + task.due_string();
         lv_obj_set_style_text_color(due, lv_color_hex(0x55FF55), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
       } else {
         lv_obj_set_style_text_color(due, lv_color_hex(0xCCCCCC), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
@@ -499,11 +866,11 @@ void TodoistComponent::on_task_click_(const TodoistTask &task) {
 
   // Description if present
   lv_obj_t *desc = nullptr; // Declare outside if block
-  if (!task.description.empty()) {
+  if (*task.description() != '\0') {
     desc = lv_label_create(modal);
      if (!desc) { ESP_LOGE(TAG, "Failed to create modal description"); /* Continue without description */ }
      else {
-        lv_label_set_text(desc, task.description.c_str());
+        lv_label_set_text(desc, task.description());
         lv_obj_set_style_text_color(desc, lv_color_hex(0xCCCCCC), (lv_part_t)(LV_PART_MAIN | LV_STATE_DEFAULT));
         // Align description relative to title or due date
         lv_obj_align_to(desc, due ? due : title, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 10);
@@ -548,23 +915,15 @@ void TodoistComponent::on_task_click_(const TodoistTask &task) {
     TodoistComponent *component = static_cast<TodoistComponent*>(lv_event_get_user_data(e));
     // Get the task from the button's user data, NOT the event's user data
     lv_obj_t *btn = lv_event_get_current_target(e);
-    const TodoistTask *task_ptr = static_cast<const TodoistTask*>(lv_obj_get_user_data(btn));
-
-    if (component && task_ptr) {
-      ESP_LOGI(TAG, "Complete button clicked for task: %s", task_ptr->id.c_str());
-      // Mark task as complete using the pointer
-      component->api_->complete_task(task_ptr->id, [component](bool success) {
-        if (success) {
-          ESP_LOGI(TAG, "Task completion successful, refreshing list.");
-          // Refresh tasks list
-          component->fetch_tasks_();
-        } else {
-          ESP_LOGW(TAG, "Task completion failed.");
-          // Optionally show an error to the user
-        }
-      });
+    int index = component ? component->task_handles_.resolve(handle_from_event(e)) : -1;
+
+    if (index >= 0) {
+      std::string task_id = component->tasks_[index].id();
+      ESP_LOGI(TAG, "Complete button clicked for task: %s", task_id.c_str());
+      // Mark task as complete using the record
+      component->complete_task_(task_id);
     } else {
-        ESP_LOGE(TAG, "Component or task pointer invalid in complete button callback.");
+        ESP_LOGE(TAG, "Task is no longer in the list in complete button callback.");
     }
 
     // Close the modal
@@ -574,9 +933,15 @@ void TodoistComponent::on_task_click_(const TodoistTask &task) {
     }
   }, LV_EVENT_CLICKED, this); // Pass 'this' here
 
-  // Set task pointer as user data for the complete button
-  // Ensure the task object pointed to remains valid
-  lv_obj_set_user_data(complete_btn, (void*)(&task));
+  // Eigen handle voor de modal, zodat hij geldig blijft als de rij intussen gerecycled wordt;
+  // vrijgegeven zodra de modal verdwijnt
+  TaskHandle modal_handle = task_handles_.acquire(tasks_, index);
+  lv_obj_set_user_data(complete_btn, handle_to_user_data(modal_handle));
+  lv_obj_set_user_data(modal, handle_to_user_data(modal_handle));
+  lv_obj_add_event_cb(modal, [](lv_event_t *e) {
+    TodoistComponent *component = static_cast<TodoistComponent*>(lv_event_get_user_data(e));
+    component->task_handles_.release(handle_from_event(e));
+  }, LV_EVENT_DELETE, this);
 }
 
 }  // namespace todoist
@@ -3,15 +3,29 @@
 #include "esphome/core/component.h"
 #include "esphome/core/helpers.h"
 #include "esphome/components/time/real_time_clock.h"
-#include "../hd_device_sc01_plus/hd_device_sc01_plus.h"
+#include "esphome/components/sensor/sensor.h"
+#include "lvgl.h"
 #include "todoist_api.h"
 #include "todoist_task.h"
+#include "todoist_task_store.h"
+#include "todoist_snapshot.h"
+#include "todoist_task_handles.h"
+#include "todoist_poll_scheduler.h"
 #include <vector>
 #include <memory>
 
 namespace esphome {
 namespace todoist {
 
+// Tellers sinds boot die optioneel als sensor gepubliceerd worden
+enum Counter : uint8_t {
+  COUNTER_NOT_MODIFIED,  // 304 antwoorden op een fetch
+  COUNTER_FULL_FETCH,    // Fetches met een volledige body
+  COUNTER_FETCHES_TRIGGERED,
+  COUNTER_FETCHES_EXECUTED,  // Na samenvoegen van triggers tijdens een lopende fetch
+  COUNTER_COUNT,
+};
+
 class TodoistComponent : public Component {
  public:
   TodoistComponent();
@@ -23,23 +37,73 @@ class TodoistComponent : public Component {
   // Set API key from ESPHome config
   void set_api_key(const std::string &api_key);
   
+  // Basis URL van de Todoist API (standaard https://api.todoist.com)
+  void set_api_url(const std::string &api_url);
+  
   // Set time component reference for date calculations
   void set_time(time::RealTimeClock *time) { time_ = time; }
   
-  // Set update interval in seconds
-  void set_update_interval(uint32_t interval) { update_interval_ = interval; }
+  // Set update interval in seconds; the poll interval while nobody uses the screen
+  void set_update_interval(uint32_t interval) { scheduler_.set_idle_interval(interval * 1000); }
+  
+  // Adaptive polling: sneller kort na aanraking of een wijziging, langzamer in rust (ms)
+  void set_active_interval(uint32_t interval) { scheduler_.set_active_interval(interval); }
+  void set_max_interval(uint32_t interval) { scheduler_.set_max_interval(interval); }
+  void set_idle_timeout(uint32_t timeout) { scheduler_.set_idle_timeout(timeout); }
+  void set_poll_jitter(float jitter) { scheduler_.set_jitter(jitter); }
+  
+  // Duur van elke API request, bijvoorbeeld naar de display metrics (zie __init__.py)
+  void set_on_request(std::function<void(const char *, uint32_t)> callback) { api_->set_on_request(std::move(callback)); }
+  
+  // Sensor voor een van de tellers; bijgewerkt na elke afgeronde fetch
+  void set_counter_sensor(Counter counter, sensor::Sensor *sensor) { counter_sensors_[counter] = sensor; }
+  
+  // Use the Sync API and only fetch changes since the previous sync
+  void set_incremental_sync(bool incremental_sync) { incremental_sync_ = incremental_sync; }
+  
+  // Keep the last task list on flash and show it at boot, before the first fetch
+  void set_snapshot(bool snapshot) { snapshot_enabled_ = snapshot; }
   
-  // Fetch tasks (exposed for retry button)
+  // Fetch tasks (exposed for retry button). Single flight: tijdens een lopende fetch wordt een
+  // nieuwe trigger één vervolg-fetch
   void fetch_tasks_();
   
+  // Aantal fetch triggers versus echt uitgevoerde fetches sinds boot
+  uint32_t get_fetches_triggered() const { return fetches_triggered_; }
+  uint32_t get_fetches_executed() const { return fetches_executed_; }
+  
+  // Soorten rijen in de takenlijst en het label rechts in een taakrij
+  enum RowKind : uint8_t { ROW_TASK, ROW_OVERDUE_HEADER, ROW_TODAY_HEADER, ROW_EMPTY };
+  enum AuxKind : uint8_t { AUX_NONE, AUX_TIME, AUX_DUE };
+  
  protected:
   // API handling
   std::unique_ptr<TodoistApi> api_;
-  uint32_t update_interval_ = 300; // 5 minutes default
-  uint32_t last_update_ = 0;
+  PollScheduler scheduler_;
+  
+  // Single flight: hooguit één fetch tegelijk, triggers daarna worden één vervolg-fetch.
+  // Een uitgestelde fetch (na completions) schuift bij elke nieuwe trigger op.
+  bool fetch_in_flight_ = false;
+  bool fetch_follow_up_ = false;
+  bool fetch_pending_ = false;
+  uint32_t fetch_pending_at_ = 0;
+  uint32_t fetches_triggered_ = 0;
+  uint32_t fetches_executed_ = 0;
+  // Vorige lv_disp_get_inactive_time, om nieuwe aanrakingen te zien
+  uint32_t last_inactive_ms_ = 0;
+  bool incremental_sync_ = false;
+  sensor::Sensor *counter_sensors_[COUNTER_COUNT] = {};
   
   // Data storage
-  std::vector<TodoistTask> tasks_;
+  TaskStore tasks_;
+  // Handles in LVGL user data i.p.v. pointers in de store
+  TaskHandles task_handles_;
+  
+  // Snapshot op flash; pas een tijd na de laatste wijziging opgeslagen, om de flash te sparen
+  TaskSnapshot snapshot_;
+  bool snapshot_enabled_ = true;
+  bool snapshot_dirty_ = false;
+  uint32_t snapshot_changed_ = 0;
   
   // UI elements
   lv_obj_t *main_container_ = nullptr;
@@ -49,14 +113,72 @@ class TodoistComponent : public Component {
   lv_obj_t *header_label_ = nullptr;
   lv_obj_t *retry_btn_ = nullptr;
   
+  // Vaste rijhoogtes, zodat de lijst gevirtualiseerd kan worden
+  static const lv_coord_t TASK_ROW_HEIGHT = 40;
+  static const lv_coord_t HEADER_ROW_HEIGHT = 34;
+  static const lv_coord_t ROW_GAP = 8;
+  // Aantal extra rijen boven en onder beeld die al klaarstaan
+  static const lv_coord_t OVERSCAN_ROWS = 2;
+  
+  // Gewenste rij: taak index (of -1), een hash van alles wat zichtbaar is en de y positie
+  struct RowSpec {
+    RowKind kind;
+    int16_t index;
+    uint32_t hash;
+    bool is_overdue;
+    lv_coord_t y;
+  };
+  std::vector<RowSpec> model_;
+  
+  // Wat er nu in task_list_ staat, in dezelfde volgorde als de children
+  struct RenderedRow {
+    RowKind kind = ROW_TASK;
+    AuxKind aux = AUX_NONE;
+    std::string id;  // Sleutel voor taakrijen
+    TaskHandle handle = TASK_HANDLE_NONE;
+    uint32_t hash = 0;
+    lv_coord_t y = 0;
+    lv_obj_t *obj = nullptr;
+    lv_obj_t *label = nullptr;
+    lv_obj_t *aux_label = nullptr;
+    lv_obj_t *complete_btn = nullptr;
+  };
+  std::vector<RenderedRow> rows_;
+  // Verborgen rijen die hergebruikt worden als er een rij in beeld scrolt
+  std::vector<RenderedRow> free_rows_;
+  uint32_t rows_created_ = 0;
+  lv_obj_t *spacer_ = nullptr;
+  
   // Time component for date calculations
   time::RealTimeClock *time_ = nullptr;
+  // Lokale datum (dagen sinds 1970-01-01) en minuut van de dag, alleen herberekend bij de
+  // volgende overgang: middernacht of de eerstvolgende due tijd
+  int32_t today_ = 0;
+  uint16_t minute_ = 0;
+  time_t next_transition_ = 0;
   
   // Methods
   void render_ui_();
+  void update_due_classes_();
+  void update_activity_();
+  void request_fetch_(uint32_t delay_ms);
+  void execute_fetch_();
+  void fetch_done_(bool ok);
+  void publish_counters_();
+  void tasks_changed_();
+  void save_snapshot_();
   void render_tasks_();
-  void add_task_item_(const TodoistTask &task, bool is_overdue); // Nieuwe helper methode
-  void on_task_click_(const TodoistTask &task);
+  void sync_window_();
+  static lv_coord_t row_height_(RowKind kind);
+  bool create_row_(RenderedRow &row, const RowSpec &spec);
+  void update_row_(RenderedRow &row, const RowSpec &spec);
+  bool add_task_item_(RenderedRow &row, TaskStore::TaskRef task, bool is_overdue); // Nieuwe helper methode
+  void update_task_item_(RenderedRow &row, TaskStore::TaskRef task, bool is_overdue);
+  void set_aux_label_(RenderedRow &row, TaskStore::TaskRef task);
+  void set_hidden_(lv_obj_t *obj, bool hidden);
+  void on_task_click_(TaskHandle handle);
+  void complete_task_(const std::string &task_id);
+  void drop_pending_completions_();
   void show_loading_(bool show);
   void show_error_(const std::string &message);
   
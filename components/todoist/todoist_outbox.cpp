@@ -0,0 +1,80 @@
+#include "todoist_outbox.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include <Arduino.h>
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+namespace todoist {
+
+static const char *const TAG = "todoist.outbox";
+
+// Willekeurige UUID v4 als command uuid voor de Sync API
+static void make_uuid(char *out, size_t len) {
+  uint8_t b[16];
+  for (size_t i = 0; i < sizeof(b); i += 4) {
+    uint32_t r = esp_random();
+    memcpy(b + i, &r, 4);
+  }
+  b[6] = (b[6] & 0x0F) | 0x40;
+  b[8] = (b[8] & 0x3F) | 0x80;
+  snprintf(out, len, "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x", b[0], b[1], b[2], b[3],
+           b[4], b[5], b[6], b[7], b[8], b[9], b[10], b[11], b[12], b[13], b[14], b[15]);
+}
+
+void Outbox::load() {
+  pref_ = global_preferences->make_preference<Data>(fnv1_hash("todoist_outbox"), true);
+  if (!pref_.load(&data_) || data_.count > MAX_ENTRIES) {
+    data_ = Data{};
+    return;
+  }
+  if (data_.count > 0) {
+    ESP_LOGI(TAG, "Restored %u pending task completions", (unsigned) data_.count);
+  }
+}
+
+bool Outbox::add(const char *task_id) {
+  if (contains_task(task_id))
+    return true;
+  if (data_.count >= MAX_ENTRIES || strlen(task_id) >= sizeof(Entry::task_id)) {
+    ESP_LOGW(TAG, "Cannot queue completion of task %s (%u pending)", task_id, (unsigned) data_.count);
+    return false;
+  }
+
+  Entry &entry = data_.entries[data_.count++];
+  strncpy(entry.task_id, task_id, sizeof(entry.task_id));
+  make_uuid(entry.uuid, sizeof(entry.uuid));
+  save_();
+  return true;
+}
+
+void Outbox::remove(const char *uuid) {
+  for (size_t i = 0; i < data_.count; i++) {
+    if (strcmp(data_.entries[i].uuid, uuid) != 0)
+      continue;
+    // Volgorde behouden, zodat de oudste completions als eerste verstuurd worden
+    memmove(&data_.entries[i], &data_.entries[i + 1], (data_.count - i - 1) * sizeof(Entry));
+    data_.count--;
+    save_();
+    return;
+  }
+}
+
+bool Outbox::contains_task(const char *task_id) const {
+  for (size_t i = 0; i < data_.count; i++) {
+    if (strcmp(data_.entries[i].task_id, task_id) == 0)
+      return true;
+  }
+  return false;
+}
+
+void Outbox::save_() {
+  // Direct naar flash, anders gaat een completion bij een stroomonderbreking alsnog verloren
+  if (!pref_.save(&data_) || !global_preferences->sync()) {
+    ESP_LOGW(TAG, "Failed to persist outbox");
+  }
+}
+
+}  // namespace todoist
+}  // namespace esphome
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "esphome/core/preferences.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace todoist {
+
+// Voltooide taken die nog naar Todoist moeten. Overleeft een herstart of een WiFi storing via de
+// ESPHome preferences (NVS). Elke entry krijgt een eigen command uuid, zodat Todoist een herhaalde
+// batch na een timeout niet dubbel uitvoert. Alleen gebruikt vanuit de main loop.
+class Outbox {
+ public:
+  static const size_t MAX_ENTRIES = 16;
+
+  struct Entry {
+    char task_id[24];
+    char uuid[37];  // 8-4-4-4-12 + nul-terminator
+  };
+
+  // Leest de outbox van de vorige sessie; na het opzetten van global_preferences
+  void load();
+
+  // false als de outbox vol is of het id niet past
+  bool add(const char *task_id);
+  void remove(const char *uuid);
+  bool contains_task(const char *task_id) const;
+
+  size_t size() const { return data_.count; }
+  bool empty() const { return data_.count == 0; }
+  const Entry &operator[](size_t index) const { return data_.entries[index]; }
+
+ protected:
+  void save_();
+
+  struct Data {
+    uint8_t count;
+    Entry entries[MAX_ENTRIES];
+  };
+
+  Data data_{};
+  ESPPreferenceObject pref_;
+};
+
+}  // namespace todoist
+}  // namespace esphome
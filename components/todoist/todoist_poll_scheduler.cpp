@@ -0,0 +1,89 @@
+#include "todoist_poll_scheduler.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace todoist {
+
+static const char *const TAG = "todoist.poll";
+
+// Bovengrens voor de verdubbelingen, ruim genoeg om elk max_interval te halen
+static const uint8_t MAX_DOUBLINGS = 16;
+
+static uint32_t backoff(uint32_t base, uint8_t doublings, uint32_t max) {
+  uint64_t delay = (uint64_t) base << doublings;
+  return delay < max ? delay : max;
+}
+
+void PollScheduler::on_activity(uint32_t now) {
+  bool was_active = is_active(now);
+  active_until_ = now + idle_timeout_;
+  idle_polls_ = 0;
+  // Bij fouten geldt de backoff, ook als iemand naar het scherm kijkt
+  if (was_active || in_flight_ || failures_ > 0)
+    return;
+
+  // Terug bij het scherm: een verse lijst als de vorige poll langer dan active_interval geleden was
+  uint32_t target = last_poll_ + active_interval_;
+  if ((int32_t) (target - now) < 0)
+    target = now;
+  if ((int32_t) (not_before_ - target) > 0)
+    target = not_before_;
+  if ((int32_t) (next_poll_ - target) > 0) {
+    next_poll_ = target;
+    ESP_LOGD(TAG, "Activity, next poll in %u s", (unsigned) ((next_poll_ - now) / 1000));
+  }
+}
+
+void PollScheduler::on_poll(uint32_t now) {
+  in_flight_ = true;
+  last_poll_ = now;
+}
+
+void PollScheduler::on_success(uint32_t now, bool changed) {
+  in_flight_ = false;
+  failures_ = 0;
+  not_before_ = now;
+
+  // Een wijziging komt zelden alleen; een tijdje sneller blijven pollen
+  if (changed) {
+    if ((int32_t) (now + idle_timeout_ - active_until_) > 0)
+      active_until_ = now + idle_timeout_;
+    idle_polls_ = 0;
+  }
+
+  if (is_active(now)) {
+    schedule_(now, active_interval_);
+    return;
+  }
+  schedule_(now, backoff(idle_interval_, idle_polls_, max_interval_));
+  if (idle_polls_ < MAX_DOUBLINGS)
+    idle_polls_++;
+}
+
+void PollScheduler::on_failure(uint32_t now, uint32_t retry_after_ms) {
+  in_flight_ = false;
+  if (failures_ < MAX_DOUBLINGS)
+    failures_++;
+
+  uint32_t base = is_active(now) ? active_interval_ : idle_interval_;
+  uint32_t delay = backoff(base, failures_ - 1, max_interval_);
+  // Retry-After gaat boven max_interval; de server weet beter wanneer het weer mag
+  not_before_ = now + retry_after_ms;
+  if (retry_after_ms > delay)
+    delay = retry_after_ms;
+  schedule_(now, delay);
+}
+
+void PollScheduler::schedule_(uint32_t now, uint32_t delay) {
+  // Jitter, zodat apparaten die tegelijk opstartten niet in de pas blijven lopen
+  float factor = 1.0f + jitter_ * (2.0f * random_float() - 1.0f);
+  next_poll_ = now + (uint32_t) (delay * factor);
+  if ((int32_t) (not_before_ - next_poll_) > 0)
+    next_poll_ = not_before_;
+  ESP_LOGD(TAG, "Next poll in %u s (%s, %u idle polls, %u failures)", (unsigned) ((next_poll_ - now) / 1000),
+           is_active(now) ? "active" : "idle", (unsigned) idle_polls_, (unsigned) failures_);
+}
+
+}  // namespace todoist
+}  // namespace esphome
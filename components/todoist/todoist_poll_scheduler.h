@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace todoist {
+
+// Bepaalt wanneer de volgende fetch/sync gedaan wordt. Kort na een aanraking of een wijziging
+// in de lijst wordt vaak gepolld (active_interval); daarna geldt het gewone interval en elke
+// poll zonder wijzigingen terwijl het scherm ongebruikt is verdubbelt dat, tot max_interval. Een
+// Retry-After van de server is een ondergrens en op elke wachttijd komt wat jitter.
+//
+// Alle tijden zijn millis() waarden die de aanroeper meegeeft, zodat de policy zonder echte
+// klok te testen is. Alleen gebruikt vanuit de main loop.
+class PollScheduler {
+ public:
+  void set_active_interval(uint32_t ms) { active_interval_ = ms; }
+  void set_idle_interval(uint32_t ms) { idle_interval_ = ms; }
+  void set_max_interval(uint32_t ms) { max_interval_ = ms; }
+  void set_idle_timeout(uint32_t ms) { idle_timeout_ = ms; }
+  // Fractie van de wachttijd, bijv. 0.1 voor +/- 10%
+  void set_jitter(float jitter) { jitter_ = jitter; }
+
+  // Aanraking op het scherm; haalt een ver weg geplande poll naar voren
+  void on_activity(uint32_t now);
+  // Poll gestart; tot het resultaat er is wordt er geen nieuwe gepland
+  void on_poll(uint32_t now);
+  void on_success(uint32_t now, bool changed);
+  // retry_after_ms is 0 als de server geen Retry-After meegaf
+  void on_failure(uint32_t now, uint32_t retry_after_ms);
+
+  bool should_poll(uint32_t now) const { return !in_flight_ && (int32_t) (now - next_poll_) >= 0; }
+  bool is_active(uint32_t now) const { return (int32_t) (active_until_ - now) > 0; }
+
+ protected:
+  void schedule_(uint32_t now, uint32_t delay);
+
+  uint32_t active_interval_ = 30000;
+  uint32_t idle_interval_ = 300000;
+  uint32_t max_interval_ = 30 * 60000;
+  uint32_t idle_timeout_ = 120000;
+  float jitter_ = 0.1f;
+
+  bool in_flight_ = false;
+  uint32_t next_poll_ = 0;
+  uint32_t last_poll_ = 0;
+  uint32_t active_until_ = 0;
+  // Ondergrens door Retry-After
+  uint32_t not_before_ = 0;
+  // Opeenvolgende polls zonder wijzigingen in rust, en opeenvolgende fouten
+  uint8_t idle_polls_ = 0;
+  uint8_t failures_ = 0;
+};
+
+}  // namespace todoist
+}  // namespace esphome
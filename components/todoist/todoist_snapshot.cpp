@@ -0,0 +1,152 @@
+#include "todoist_snapshot.h"
+#include "esphome/core/log.h"
+#include <Arduino.h>
+#include <esp_rom_crc.h>
+#include <esp_spi_flash.h>
+#include <cstring>
+
+namespace esphome {
+namespace todoist {
+
+static const char *const TAG = "todoist.snapshot";
+
+static const uint32_t SECTOR_SIZE = 4096;
+
+static uint32_t snapshot_crc(const TaskStore::Record *records, size_t count, const char *arena, size_t arena_size) {
+  uint32_t crc = esp_rom_crc32_le(0, reinterpret_cast<const uint8_t *>(records), count * sizeof(TaskStore::Record));
+  return esp_rom_crc32_le(crc, reinterpret_cast<const uint8_t *>(arena), arena_size);
+}
+
+bool TaskSnapshot::setup() {
+  partition_ = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, "spiffs");
+  if (partition_ == nullptr) {
+    ESP_LOGW(TAG, "No spiffs partition, task snapshot disabled");
+    return false;
+  }
+  ESP_LOGD(TAG, "Using partition at 0x%X (%u bytes)", (unsigned) partition_->address, (unsigned) partition_->size);
+  return true;
+}
+
+bool TaskSnapshot::load(TaskStore &store) {
+  if (partition_ == nullptr)
+    return false;
+
+  // Hele partitie mappen: records en arena komen zonder tussenbuffer uit de flash cache
+  const void *ptr;
+  spi_flash_mmap_handle_t handle;
+  if (esp_partition_mmap(partition_, 0, partition_->size, SPI_FLASH_MMAP_DATA, &ptr, &handle) != ESP_OK) {
+    ESP_LOGW(TAG, "Failed to map snapshot partition");
+    return false;
+  }
+
+  const uint8_t *data = static_cast<const uint8_t *>(ptr);
+  Header header;
+  memcpy(&header, data, sizeof(header));
+
+  bool ok = false;
+  size_t records_size = header.count * sizeof(TaskStore::Record);
+  if (header.magic != MAGIC) {
+    ESP_LOGD(TAG, "No snapshot stored");
+  } else if (header.version != VERSION || header.record_size != sizeof(TaskStore::Record)) {
+    ESP_LOGI(TAG, "Ignoring snapshot with version %u", header.version);
+  } else if (header.count > TaskStore::MAX_TASKS || header.arena_size > TaskStore::MAX_ARENA_SIZE ||
+             sizeof(Header) + records_size + header.arena_size > partition_->size) {
+    ESP_LOGW(TAG, "Snapshot header is corrupt");
+  } else {
+    const TaskStore::Record *records = reinterpret_cast<const TaskStore::Record *>(data + sizeof(Header));
+    const char *arena = reinterpret_cast<const char *>(data + sizeof(Header) + records_size);
+    if (snapshot_crc(records, header.count, arena, header.arena_size) != header.crc) {
+      ESP_LOGW(TAG, "Snapshot checksum mismatch");
+    } else if (restore_(store, header, records, arena)) {
+      stored_ = true;
+      last_crc_ = header.crc;
+      ok = true;
+    } else {
+      ESP_LOGW(TAG, "Snapshot contents are invalid");
+    }
+  }
+
+  spi_flash_munmap(handle);
+  if (ok) {
+    ESP_LOGI(TAG, "Restored %u tasks from snapshot", (unsigned) store.size());
+  }
+  return ok;
+}
+
+bool TaskSnapshot::restore_(TaskStore &store, const Header &header, const TaskStore::Record *records,
+                            const char *arena) {
+  // De CRC klopt, maar een offset buiten de arena mag nooit een TaskRef opleveren
+  if (header.count > 0 && (header.arena_size == 0 || arena[0] != '\0' || arena[header.arena_size - 1] != '\0'))
+    return false;
+  for (size_t i = 0; i < header.count; i++) {
+    const TaskStore::Record &record = records[i];
+    if (record.id >= header.arena_size || record.content >= header.arena_size ||
+        record.description >= header.arena_size || record.project_id >= header.arena_size ||
+        record.due_string >= header.arena_size)
+      return false;
+  }
+
+  TaskStore restored;
+  if (!restored.reserve_(header.arena_size))
+    return false;
+  memcpy(restored.arena_, arena, header.arena_size);
+  restored.arena_size_ = header.arena_size;
+  restored.records_.assign(records, records + header.count);
+  restored.today_ = header.today;
+  restored.minute_ = header.minute;
+  restored.rebuild_index_();
+  store = std::move(restored);
+  return true;
+}
+
+bool TaskSnapshot::save(const TaskStore &store) {
+  if (partition_ == nullptr)
+    return false;
+
+  const TaskStore::Record *records = store.records_.data();
+  size_t records_size = store.records_.size() * sizeof(TaskStore::Record);
+  size_t total = sizeof(Header) + records_size + store.arena_size_;
+  if (total > partition_->size) {
+    ESP_LOGW(TAG, "Task list too large for snapshot (%u of %u bytes)", (unsigned) total, (unsigned) partition_->size);
+    return false;
+  }
+
+  Header header{};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.record_size = sizeof(TaskStore::Record);
+  header.count = store.records_.size();
+  header.arena_size = store.arena_size_;
+  header.today = store.today_;
+  header.minute = store.minute_;
+  header.crc = snapshot_crc(records, header.count, store.arena_, store.arena_size_);
+
+  // Niets veranderd sinds de vorige save of de snapshot waarmee we opstartten: flash sparen
+  if (stored_ && header.crc == last_crc_)
+    return true;
+
+  uint32_t start = millis();
+  size_t erase_size = (total + SECTOR_SIZE - 1) / SECTOR_SIZE * SECTOR_SIZE;
+  esp_err_t err = esp_partition_erase_range(partition_, 0, erase_size);
+  if (err == ESP_OK && records_size > 0)
+    err = esp_partition_write(partition_, sizeof(Header), records, records_size);
+  if (err == ESP_OK && store.arena_size_ > 0)
+    err = esp_partition_write(partition_, sizeof(Header) + records_size, store.arena_, store.arena_size_);
+  // Header als laatste: tot dit punt is de magic nog gewist en de snapshot ongeldig
+  if (err == ESP_OK)
+    err = esp_partition_write(partition_, 0, &header, sizeof(header));
+  if (err != ESP_OK) {
+    ESP_LOGW(TAG, "Failed to write snapshot: %s", esp_err_to_name(err));
+    stored_ = false;
+    return false;
+  }
+
+  stored_ = true;
+  last_crc_ = header.crc;
+  ESP_LOGI(TAG, "Saved %u tasks (%u bytes) in %u ms", (unsigned) header.count, (unsigned) total,
+           (unsigned) (millis() - start));
+  return true;
+}
+
+}  // namespace todoist
+}  // namespace esphome
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "todoist_task_store.h"
+#include <esp_partition.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace todoist {
+
+// Laatste goede takenlijst op de spiffs partitie (zie other/custom_partitions_*.csv), zodat de
+// lijst bij het opstarten meteen op het scherm staat en de eerste fetch hem op de achtergrond
+// ververst. Het formaat is een header plus de records en de arena van de TaskStore zoals ze in
+// het geheugen staan; de header wordt als laatste geschreven, zodat een onderbroken save nooit
+// als geldige snapshot gelezen wordt.
+class TaskSnapshot {
+ public:
+  static const uint32_t MAGIC = 0x4E534454;  // "TDSN"
+  // Ophogen bij elke wijziging van Header of TaskStore::Record
+  static const uint16_t VERSION = 1;
+
+  struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;  // sizeof(TaskStore::Record), vangt een andere layout af
+    uint32_t count;
+    uint32_t arena_size;
+    int32_t today;         // Indeling van de records bij het opslaan
+    uint16_t minute;
+    uint16_t reserved;
+    uint32_t crc;          // CRC32 over records en arena
+  };
+
+  // Zoekt de partitie; false als de partitietabel geen spiffs partitie heeft
+  bool setup();
+
+  // Leest de snapshot via een memory mapped view op de flash. false bij een ontbrekende, oude of
+  // beschadigde snapshot; store blijft dan ongewijzigd.
+  bool load(TaskStore &store);
+  // Schrijft store weg, tenzij de snapshot op flash al dezelfde inhoud heeft
+  bool save(const TaskStore &store);
+
+ protected:
+  // Controleert de offsets en kopieert records en arena naar store
+  static bool restore_(TaskStore &store, const Header &header, const TaskStore::Record *records,
+                       const char *arena);
+
+  const esp_partition_t *partition_ = nullptr;
+  // CRC van wat er op flash staat; alleen geldig met stored_ (een lege lijst heeft CRC 0)
+  bool stored_ = false;
+  uint32_t last_crc_ = 0;
+};
+
+}  // namespace todoist
+}  // namespace esphome
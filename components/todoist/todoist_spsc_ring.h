@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace esphome {
+namespace todoist {
+
+// Lock-free ring voor precies één producer (de netwerktaak) en één consumer (de main loop).
+// Eén slot blijft leeg om vol en leeg van elkaar te onderscheiden.
+template<typename T, size_t N> class SpscRing {
+ public:
+  bool push(const T &item) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t next = (head + 1) % N;
+    if (next == tail_.load(std::memory_order_acquire))
+      return false;  // Vol
+    items_[head] = item;
+    head_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T &item) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire))
+      return false;  // Leeg
+    item = items_[tail];
+    tail_.store((tail + 1) % N, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+ protected:
+  T items_[N];
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+};
+
+}  // namespace todoist
+}  // namespace esphome
@@ -1,5 +1,7 @@
 #include "todoist_task.h"
 #include "esphome/core/log.h"
+#include <cstring>
+#include <cstdio>
 #include <ctime>
 
 namespace esphome {
@@ -7,67 +9,85 @@ namespace todoist {
 
 static const char *const TAG = "todoist.task";
 
-bool TodoistTask::is_due_today() const {
-  if (due_date.empty())
-    return false;
-    
-  time_t now;
-  time(&now);
-  struct tm timeinfo;
-  localtime_r(&now, &timeinfo);
-  
-  char today[11]; // YYYY-MM-DD\0
-  strftime(today, sizeof(today), "%Y-%m-%d", &timeinfo);
-  
-  return due_date.substr(0, 10) == today;
+int32_t days_from_civil(int32_t year, uint32_t month, uint32_t day) {
+  // Algoritme van Howard Hinnant, met maart als eerste maand van het jaar
+  year -= month <= 2;
+  const int32_t era = (year >= 0 ? year : year - 399) / 400;
+  const uint32_t yoe = static_cast<uint32_t>(year - era * 400);
+  const uint32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<int32_t>(doe) - 719468;
 }
 
-bool TodoistTask::is_overdue() const {
-  if (due_date.empty())
-    return false;
-    
-  time_t now;
-  time(&now);
-  struct tm timeinfo;
-  localtime_r(&now, &timeinfo);
-  
-  char today[11]; // YYYY-MM-DD\0
-  strftime(today, sizeof(today), "%Y-%m-%d", &timeinfo);
-  
-  return due_date.substr(0, 10) < today;
+// Leest precies count cijfers; -1 als er iets anders staat
+static int parse_digits(const char *s, int count) {
+  int value = 0;
+  for (int i = 0; i < count; i++) {
+    if (s[i] < '0' || s[i] > '9')
+      return -1;
+    value = value * 10 + (s[i] - '0');
+  }
+  return value;
 }
 
-bool TodoistTask::is_due_tomorrow() const {
-  if (due_date.empty())
-    return false;
-    
-  time_t now;
-  time(&now);
-  now += 24*60*60; // Voeg één dag toe aan huidige tijd
-  struct tm tomorrow;
-  localtime_r(&now, &tomorrow);
-  
-  char tomorrow_date[11]; // YYYY-MM-DD\0
-  strftime(tomorrow_date, sizeof(tomorrow_date), "%Y-%m-%d", &tomorrow);
-  
-  return due_date.substr(0, 10) == tomorrow_date;
-}
+DueDate parse_due_date(const char *due_date) {
+  if (due_date == nullptr || strlen(due_date) < 10 || due_date[4] != '-' || due_date[7] != '-')
+    return DUE_NONE;
+
+  int year = parse_digits(due_date, 4);
+  int month = parse_digits(due_date + 5, 2);
+  int day = parse_digits(due_date + 8, 2);
+  if (year < 1970 || month < 1 || month > 12 || day < 1 || day > 31) {
+    ESP_LOGW(TAG, "Invalid due date: %s", due_date);
+    return DUE_NONE;
+  }
 
-std::string TodoistTask::get_due_time() const {
-  if (due_date.empty() || due_date.length() <= 10)
-    return "";
-    
   // De due_date in Todoist API heeft doorgaans het formaat "YYYY-MM-DDThh:mm:ss"
-  // We willen alleen het "hh:mm" deel extraheren
-  size_t pos = due_date.find('T');
-  if (pos != std::string::npos && pos + 6 <= due_date.length()) {
-    return due_date.substr(pos + 1, 5); // Alleen "hh:mm" pakken
+  int32_t days = days_from_civil(year, month, day);
+  uint16_t minute = DUE_NO_TIME;
+  if (due_date[10] == 'T') {
+    int hh = parse_digits(due_date + 11, 2);
+    // Bij een afgekapte tijd ("...T1") staat de NUL al voor index 13
+    int mm = hh >= 0 && due_date[13] == ':' ? parse_digits(due_date + 14, 2) : -1;
+    if (hh >= 0 && hh < 24 && mm >= 0 && mm < 60)
+      minute = hh * 60 + mm;
+  }
+
+  // Taken met een vaste tijdzone (en datetime van de REST API) staan in UTC, bijv.
+  // "2024-03-01T13:00:00Z" of "...T13:00:00.000000Z". Omrekenen naar lokale tijd met de TZ die
+  // de ESPHome time component instelt; zonder Z is het al de lokale ("floating") tijd.
+  if (minute != DUE_NO_TIME) {
+    const char *p = due_date + 16;
+    if (*p == ':' && parse_digits(p + 1, 2) >= 0)
+      p += 3;
+    if (*p == '.') {
+      do {
+        p++;
+      } while (*p >= '0' && *p <= '9');
+    }
+    if (*p == 'Z') {
+      time_t utc = static_cast<time_t>(days) * 86400 + minute * 60;
+      struct tm local;
+      localtime_r(&utc, &local);
+      days = days_from_civil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+      minute = local.tm_hour * 60 + local.tm_min;
+    }
   }
-  
-  return "";
+
+  return (static_cast<DueDate>(days + 1) << 11) | minute;
+}
+
+std::string due_time_string(DueDate due) {
+  uint16_t minute = due_minute(due);
+  if (due == DUE_NONE || minute == DUE_NO_TIME)
+    return "";
+
+  char buf[6];  // hh:mm\0
+  snprintf(buf, sizeof(buf), "%02u:%02u", (unsigned) (minute / 60), (unsigned) (minute % 60));
+  return buf;
 }
 
-uint32_t TodoistTask::get_priority_color() const {
+uint32_t priority_color(TaskPriority priority) {
   // Todoist colors in LVGL format (0xRRGGBB)
   switch (priority) {
     case PRIORITY_1: return 0xFF2B2B; // Red (p1)
@@ -78,5 +98,7 @@ uint32_t TodoistTask::get_priority_color() const {
   }
 }
 
+uint32_t TodoistTask::get_priority_color() const { return priority_color(priority); }
+
 }  // namespace todoist
 }  // namespace esphome
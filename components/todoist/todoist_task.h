@@ -13,6 +13,47 @@ enum TaskPriority {
   PRIORITY_4 = 4   // Lowest priority (p4)
 };
 
+// Due datum als één getal, eenmalig geparsed bij binnenkomst:
+// (dagen sinds 1970-01-01 + 1) << 11 | minuut van de dag, of DUE_NO_TIME zonder tijd. 0 = geen due datum.
+typedef uint32_t DueDate;
+static const DueDate DUE_NONE = 0;
+static const uint16_t DUE_NO_TIME = 0x7FF;
+
+// Indeling ten opzichte van "vandaag", zie classify_due
+enum DueClass : uint8_t {
+  DUE_CLASS_NONE,
+  DUE_CLASS_OVERDUE,
+  DUE_CLASS_TODAY,
+  DUE_CLASS_TOMORROW,
+  DUE_CLASS_LATER,
+};
+
+// Dagen sinds 1970-01-01 voor een kalenderdatum (proleptisch Gregoriaans)
+int32_t days_from_civil(int32_t year, uint32_t month, uint32_t day);
+// Parset "YYYY-MM-DD[Thh:mm[:ss[.ffffff]][Z]]"; een tijd met Z wordt naar de lokale tijdzone
+// omgerekend. DUE_NONE bij een lege of ongeldige string
+DueDate parse_due_date(const char *due_date);
+
+inline int32_t due_day(DueDate due) { return static_cast<int32_t>(due >> 11) - 1; }
+inline uint16_t due_minute(DueDate due) { return due & 0x7FF; }
+
+// Eén integer vergelijking tegen het huidige moment (dag + minuut): een taak met een tijd is
+// over de tijd zodra die minuut begint, een taak zonder tijd pas de dag erna
+inline DueClass classify_due(DueDate due, int32_t today, uint16_t minute) {
+  if (due == DUE_NONE)
+    return DUE_CLASS_NONE;
+  if (due <= ((static_cast<DueDate>(today + 1) << 11) | minute))
+    return DUE_CLASS_OVERDUE;
+  int32_t day = due_day(due);
+  if (day == today)
+    return DUE_CLASS_TODAY;
+  return day == today + 1 ? DUE_CLASS_TOMORROW : DUE_CLASS_LATER;
+}
+
+// "hh:mm" als de due datum een tijd heeft, anders leeg
+std::string due_time_string(DueDate due);
+uint32_t priority_color(TaskPriority priority);
+
 class TodoistTask {
  public:
   std::string id;
@@ -27,14 +68,6 @@ class TodoistTask {
   bool is_completed = false;
   bool is_deleted = false;
   
-  // Helper methods to check due status
-  bool is_due_today() const;
-  bool is_overdue() const;
-  bool is_due_tomorrow() const;
-  
-  // Get time part from due_date (if available)
-  std::string get_due_time() const;
-  
   // Get color based on priority
   uint32_t get_priority_color() const;
 };
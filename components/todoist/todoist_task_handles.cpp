@@ -0,0 +1,76 @@
+#include "todoist_task_handles.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace todoist {
+
+static const char *const TAG = "todoist.handles";
+
+static const size_t MAX_SLOTS = 0xFFFF;
+
+TaskHandle TaskHandles::acquire(const TaskStore &store, size_t index) {
+  uint16_t slot_index;
+  if (!free_.empty()) {
+    slot_index = free_.back();
+    free_.pop_back();
+  } else if (slots_.size() < MAX_SLOTS) {
+    slot_index = slots_.size();
+    slots_.emplace_back();
+  } else {
+    ESP_LOGE(TAG, "Out of task handles");
+    return TASK_HANDLE_NONE;
+  }
+
+  Slot &slot = slots_[slot_index];
+  slot.used = true;
+  slot.index = index;
+  slot.id = store[index].id();
+  return (TaskHandle(slot.generation) << 16) | slot_index;
+}
+
+void TaskHandles::release(TaskHandle handle) {
+  const Slot *found = slot_(handle);
+  if (found == nullptr)
+    return;
+
+  uint16_t slot_index = handle & 0xFFFF;
+  Slot &slot = slots_[slot_index];
+  slot.used = false;
+  slot.index = -1;
+  slot.id.clear();
+  // Generatie 0 overslaan, zodat een handle nooit 0 kan zijn
+  if (++slot.generation == 0)
+    slot.generation = 1;
+  free_.push_back(slot_index);
+}
+
+int TaskHandles::resolve(TaskHandle handle) const {
+  const Slot *slot = slot_(handle);
+  if (slot == nullptr) {
+    if (handle != TASK_HANDLE_NONE)
+      ESP_LOGW(TAG, "Stale task handle 0x%08X", (unsigned) handle);
+    return -1;
+  }
+  return slot->index;
+}
+
+void TaskHandles::rebind(const TaskStore &store) {
+  for (Slot &slot : slots_) {
+    if (slot.used)
+      slot.index = store.find(slot.id.c_str());
+  }
+}
+
+const TaskHandles::Slot *TaskHandles::slot_(TaskHandle handle) const {
+  uint16_t slot_index = handle & 0xFFFF;
+  uint16_t generation = handle >> 16;
+  if (slot_index >= slots_.size())
+    return nullptr;
+  const Slot &slot = slots_[slot_index];
+  if (!slot.used || slot.generation != generation)
+    return nullptr;
+  return &slot;
+}
+
+}  // namespace todoist
+}  // namespace esphome
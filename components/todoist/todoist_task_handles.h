@@ -0,0 +1,50 @@
+#pragma once
+
+#include "todoist_task_store.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace todoist {
+
+// Verwijzing naar een taak die in LVGL user data past: slot index in de lage 16 bits, generatie
+// in de hoge 16 bits. 0 is nooit een geldige handle.
+typedef uint32_t TaskHandle;
+static const TaskHandle TASK_HANDLE_NONE = 0;
+
+// Tabel van handles naar taken in een TaskStore. Een handle blijft naar dezelfde taak (op id)
+// wijzen als de store vervangen of opnieuw opgebouwd wordt, zolang rebind() daarna aangeroepen
+// wordt. Na release() hoort een handle bij een oude generatie en levert resolve() -1 op, ook als
+// het slot inmiddels hergebruikt is. Alleen gebruikt vanuit de main loop.
+class TaskHandles {
+ public:
+  // Nieuwe handle voor de taak op index in store
+  TaskHandle acquire(const TaskStore &store, size_t index);
+  // Geeft het slot vrij; TASK_HANDLE_NONE en verlopen handles worden genegeerd
+  void release(TaskHandle handle);
+
+  // Index in de store in O(1), of -1 als de handle verlopen is of de taak niet meer bestaat
+  int resolve(TaskHandle handle) const;
+
+  // Zoekt de taken van alle levende handles op in de (nieuwe) store
+  void rebind(const TaskStore &store);
+
+  size_t live() const { return slots_.size() - free_.size(); }
+
+ protected:
+  struct Slot {
+    uint16_t generation = 1;
+    bool used = false;
+    int16_t index = -1;
+    std::string id;
+  };
+
+  const Slot *slot_(TaskHandle handle) const;
+
+  std::vector<Slot> slots_;
+  std::vector<uint16_t> free_;
+};
+
+}  // namespace todoist
+}  // namespace esphome
@@ -0,0 +1,346 @@
+#include "todoist_task_store.h"
+#include "esphome/core/log.h"
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <esp_heap_caps.h>
+
+namespace esphome {
+namespace todoist {
+
+static const char *const TAG = "todoist.store";
+
+// Eerste blok van de arena; groeit daarna telkens met de helft
+static const size_t ARENA_INITIAL_SIZE = 1024;
+// Kleinste grootte van de hash indexen
+static const size_t INDEX_INITIAL_SIZE = 16;
+
+// FNV-1a over de nul-getermineerde string
+static uint32_t hash_str(const char *s) {
+  uint32_t hash = 2166136261u;
+  while (*s) {
+    hash = (hash ^ (uint8_t) *s++) * 16777619u;
+  }
+  return hash;
+}
+
+static void *arena_realloc(void *ptr, size_t size) {
+  // Liever PSRAM, val terug op intern geheugen als er geen PSRAM is
+  void *new_ptr = heap_caps_realloc(ptr, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (new_ptr != nullptr)
+    return new_ptr;
+  return realloc(ptr, size);
+}
+
+TaskStore::~TaskStore() { free(arena_); }
+
+TaskStore::TaskStore(TaskStore &&other) noexcept
+    : records_(std::move(other.records_)),
+      arena_(other.arena_),
+      arena_size_(other.arena_size_),
+      arena_capacity_(other.arena_capacity_),
+      id_index_(std::move(other.id_index_)),
+      project_index_(std::move(other.project_index_)),
+      project_count_(other.project_count_),
+      today_(other.today_),
+      minute_(other.minute_) {
+  other.arena_ = nullptr;
+  other.arena_size_ = 0;
+  other.arena_capacity_ = 0;
+  other.project_count_ = 0;
+}
+
+TaskStore &TaskStore::operator=(TaskStore &&other) noexcept {
+  if (this != &other) {
+    free(arena_);
+    records_ = std::move(other.records_);
+    arena_ = other.arena_;
+    arena_size_ = other.arena_size_;
+    arena_capacity_ = other.arena_capacity_;
+    id_index_ = std::move(other.id_index_);
+    project_index_ = std::move(other.project_index_);
+    project_count_ = other.project_count_;
+    today_ = other.today_;
+    minute_ = other.minute_;
+    other.arena_ = nullptr;
+    other.arena_size_ = 0;
+    other.arena_capacity_ = 0;
+    other.project_count_ = 0;
+  }
+  return *this;
+}
+
+void TaskStore::clear() {
+  // Buffer blijft staan, zodat een rebuild niet opnieuw hoeft te alloceren
+  records_.clear();
+  arena_size_ = 0;
+  std::fill(id_index_.begin(), id_index_.end(), 0);
+  std::fill(project_index_.begin(), project_index_.end(), 0);
+  project_count_ = 0;
+}
+
+void TaskStore::remove(size_t index) {
+  if (index >= records_.size())
+    return;
+  // Alle indices erachter schuiven op; bij een paar honderd taken is opnieuw opbouwen goedkoop
+  records_.erase(records_.begin() + index);
+  rebuild_index_();
+}
+
+bool TaskStore::reserve_(size_t size) {
+  if (size <= arena_capacity_)
+    return true;
+  if (size > MAX_ARENA_SIZE)
+    return false;
+
+  size_t new_capacity = arena_capacity_ == 0 ? ARENA_INITIAL_SIZE : arena_capacity_ + arena_capacity_ / 2;
+  if (new_capacity < size)
+    new_capacity = size;
+  if (new_capacity > MAX_ARENA_SIZE)
+    new_capacity = MAX_ARENA_SIZE;
+
+  char *new_arena = static_cast<char *>(arena_realloc(arena_, new_capacity));
+  if (new_arena == nullptr) {
+    ESP_LOGE(TAG, "Failed to grow task arena to %u bytes", (unsigned) new_capacity);
+    return false;
+  }
+  arena_ = new_arena;
+  arena_capacity_ = new_capacity;
+  return true;
+}
+
+bool TaskStore::append_(const char *s, uint32_t &offset) {
+  // Lege strings wijzen allemaal naar de nul-byte op offset 0
+  size_t len = strlen(s);
+  if (len == 0) {
+    offset = 0;
+    return true;
+  }
+  if (!reserve_(arena_size_ + len + 1))
+    return false;
+  offset = arena_size_;
+  memcpy(arena_ + arena_size_, s, len + 1);
+  arena_size_ += len + 1;
+  return true;
+}
+
+void TaskStore::grow_project_index_() {
+  if ((project_count_ + 1) * 2 <= project_index_.size())
+    return;
+  // Groeien en alle geïnterneerde strings opnieuw verdelen
+  std::vector<uint32_t> old = std::move(project_index_);
+  project_index_.assign(old.empty() ? INDEX_INITIAL_SIZE : old.size() * 2, 0);
+  size_t mask = project_index_.size() - 1;
+  for (uint32_t entry : old) {
+    if (entry == 0)
+      continue;
+    size_t slot = hash_str(str_(entry)) & mask;
+    while (project_index_[slot] != 0)
+      slot = (slot + 1) & mask;
+    project_index_[slot] = entry;
+  }
+}
+
+bool TaskStore::intern_(const char *s, uint32_t &offset) {
+  if (*s == '\0') {
+    offset = 0;
+    return true;
+  }
+
+  grow_project_index_();
+  size_t mask = project_index_.size() - 1;
+  size_t slot = hash_str(s) & mask;
+  for (; project_index_[slot] != 0; slot = (slot + 1) & mask) {
+    if (strcmp(str_(project_index_[slot]), s) == 0) {
+      offset = project_index_[slot];
+      return true;
+    }
+  }
+  // Pas na een geslaagde append opnemen, zodat een rollback in add_ de index niet raakt
+  if (!append_(s, offset))
+    return false;
+  project_index_[slot] = offset;
+  project_count_++;
+  return true;
+}
+
+void TaskStore::index_project_(uint32_t offset) {
+  if (offset == 0)
+    return;
+
+  grow_project_index_();
+  size_t mask = project_index_.size() - 1;
+  size_t slot = hash_str(str_(offset)) & mask;
+  for (; project_index_[slot] != 0; slot = (slot + 1) & mask) {
+    if (strcmp(str_(project_index_[slot]), str_(offset)) == 0)
+      return;
+  }
+  project_index_[slot] = offset;
+  project_count_++;
+}
+
+void TaskStore::index_id_(size_t index) {
+  if (records_.size() * 2 > id_index_.size()) {
+    size_t size = id_index_.empty() ? INDEX_INITIAL_SIZE : id_index_.size();
+    while (records_.size() * 2 > size)
+      size *= 2;
+    id_index_.assign(size, 0);
+    // Inclusief index zelf, die al in records_ staat
+    size_t mask = size - 1;
+    for (size_t i = 0; i < records_.size(); i++) {
+      size_t slot = hash_str(str_(records_[i].id)) & mask;
+      while (id_index_[slot] != 0)
+        slot = (slot + 1) & mask;
+      id_index_[slot] = i + 1;
+    }
+    return;
+  }
+
+  size_t mask = id_index_.size() - 1;
+  size_t slot = hash_str(str_(records_[index].id)) & mask;
+  while (id_index_[slot] != 0)
+    slot = (slot + 1) & mask;
+  id_index_[slot] = index + 1;
+}
+
+void TaskStore::rebuild_index_() {
+  // Vooraf groot genoeg, zodat index_id_ onderweg niet zelf gaat groeien
+  size_t size = std::max(id_index_.size(), INDEX_INITIAL_SIZE);
+  while (records_.size() * 2 > size)
+    size *= 2;
+  id_index_.assign(size, 0);
+  for (size_t i = 0; i < records_.size(); i++) {
+    index_id_(i);
+  }
+
+  // De strings staan al in de arena; alleen hun offsets opnieuw opnemen, nooit iets toevoegen
+  std::fill(project_index_.begin(), project_index_.end(), 0);
+  project_count_ = 0;
+  for (const Record &record : records_) {
+    index_project_(record.project_id);
+  }
+}
+
+bool TaskStore::add_(const char *id, const char *content, const char *description, const char *project_id,
+                     DueDate due, const char *due_string, TaskPriority priority, bool is_completed,
+                     bool is_deleted) {
+  if (records_.size() >= MAX_TASKS)
+    return false;
+
+  if (arena_size_ == 0) {
+    if (!reserve_(1))
+      return false;
+    arena_[0] = '\0';
+    arena_size_ = 1;
+  }
+
+  // Bij een volle arena wordt de gedeeltelijk toegevoegde taak teruggedraaid
+  size_t rollback = arena_size_;
+  Record record{};
+  if (!append_(id, record.id) || !append_(content, record.content) || !append_(description, record.description) ||
+      !append_(due_string, record.due_string) || !intern_(project_id, record.project_id)) {
+    arena_size_ = rollback;
+    return false;
+  }
+  record.due = due;
+  record.due_class = classify_due(due, today_, minute_);
+  record.priority = priority;
+  record.is_completed = is_completed;
+  record.is_deleted = is_deleted;
+
+  records_.push_back(record);
+  index_id_(records_.size() - 1);
+  return true;
+}
+
+bool TaskStore::add(const TodoistTask &task) {
+  return add_(task.id.c_str(), task.content.c_str(), task.description.c_str(), task.project_id.c_str(),
+              parse_due_date(task.due_date.c_str()), task.due_string.c_str(), task.priority, task.is_completed,
+              task.is_deleted);
+}
+
+bool TaskStore::add(const TaskRef &task) {
+  return add_(task.id(), task.content(), task.description(), task.project_id(), task.due(), task.due_string(),
+              task.priority(), task.is_completed(), task.is_deleted());
+}
+
+size_t TaskStore::reclassify(int32_t today, uint16_t minute) {
+  today_ = today;
+  minute_ = minute;
+  size_t changed = 0;
+  for (Record &record : records_) {
+    uint8_t due_class = classify_due(record.due, today, minute);
+    if (record.due_class != due_class) {
+      record.due_class = due_class;
+      changed++;
+    }
+  }
+  return changed;
+}
+
+int32_t TaskStore::next_due_minute() const {
+  int32_t next = -1;
+  for (const Record &record : records_) {
+    uint16_t minute = due_minute(record.due);
+    if (record.due_class != DUE_CLASS_TODAY || minute == DUE_NO_TIME || minute <= minute_)
+      continue;
+    if (next < 0 || minute < next)
+      next = minute;
+  }
+  return next;
+}
+
+int TaskStore::find(const char *id) const {
+  if (id_index_.empty())
+    return -1;
+  size_t mask = id_index_.size() - 1;
+  for (size_t slot = hash_str(id) & mask; id_index_[slot] != 0; slot = (slot + 1) & mask) {
+    uint16_t index = id_index_[slot] - 1;
+    if (strcmp(str_(records_[index].id), id) == 0)
+      return index;
+  }
+  return -1;
+}
+
+bool TaskStore::apply_changes(const TaskStore &changes, bool replace) {
+  TaskStore merged;
+  merged.today_ = today_;
+  merged.minute_ = minute_;
+  std::vector<bool> applied(changes.size(), false);
+
+  if (!replace) {
+    for (size_t i = 0; i < records_.size(); i++) {
+      TaskRef task = (*this)[i];
+      int changed = changes.find(task.id());
+      if (changed < 0) {
+        if (!merged.add(task))
+          return false;
+        continue;
+      }
+      // Gewijzigd item op dezelfde plek houden, tenzij het is weggevallen
+      applied[changed] = true;
+      TaskRef update = changes[changed];
+      if (!update.is_completed() && !update.is_deleted() && !merged.add(update))
+        return false;
+    }
+  }
+
+  // Nieuwe items achteraan
+  for (size_t i = 0; i < changes.size(); i++) {
+    TaskRef update = changes[i];
+    if (!applied[i] && !update.is_completed() && !update.is_deleted() && !merged.add(update))
+      return false;
+  }
+
+  *this = std::move(merged);
+  return true;
+}
+
+size_t TaskStore::memory_usage() const {
+  return records_.capacity() * sizeof(Record) + arena_capacity_ + id_index_.capacity() * sizeof(uint16_t) +
+         project_index_.capacity() * sizeof(uint32_t);
+}
+
+}  // namespace todoist
+}  // namespace esphome
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "todoist_task.h"
+#include <vector>
+#include <string>
+
+#ifndef TODOIST_MAX_TASKS
+#define TODOIST_MAX_TASKS 500
+#endif
+#ifndef TODOIST_MAX_ARENA_SIZE
+#define TODOIST_MAX_ARENA_SIZE (64 * 1024)
+#endif
+
+namespace esphome {
+namespace todoist {
+
+// Compacte opslag voor alle taken. Alle strings staan achter elkaar (nul-getermineerd) in één
+// arena, bij voorkeur in PSRAM; per taak blijft alleen een klein record met offsets over. Ids
+// zijn via een open addressing hash index in O(1) te vinden en project ids worden geïnterneerd,
+// zodat taken uit hetzelfde project één kopie in de arena delen.
+class TaskStore {
+ public:
+  // Harde bovengrens, ruim boven wat op het scherm past. Alleen de host benchmarks verhogen ze.
+  static const size_t MAX_TASKS = TODOIST_MAX_TASKS;
+  static const size_t MAX_ARENA_SIZE = TODOIST_MAX_ARENA_SIZE;
+
+  struct Record {
+    uint32_t id;           // Offsets in de arena
+    uint32_t content;
+    uint32_t description;
+    uint32_t project_id;   // Gedeeld tussen taken met hetzelfde project
+    uint32_t due_string;
+    DueDate due;           // Packed, zie parse_due_date
+    uint8_t priority : 3;  // TaskPriority
+    uint8_t is_completed : 1;
+    uint8_t is_deleted : 1;
+    uint8_t due_class : 3;  // DueClass ten opzichte van today_ van de store
+  };
+
+  // Lichtgewicht view op één taak, geldig zolang de store niet wordt vervangen
+  class TaskRef {
+   public:
+    TaskRef(const TaskStore *store, const Record *record) : store_(store), record_(record) {}
+
+    const char *id() const { return store_->str_(record_->id); }
+    const char *content() const { return store_->str_(record_->content); }
+    const char *description() const { return store_->str_(record_->description); }
+    const char *project_id() const { return store_->str_(record_->project_id); }
+    const char *due_string() const { return store_->str_(record_->due_string); }
+    DueDate due() const { return record_->due; }
+    bool has_due_date() const { return record_->due != DUE_NONE; }
+    TaskPriority priority() const { return static_cast<TaskPriority>(record_->priority); }
+    bool is_completed() const { return record_->is_completed; }
+    bool is_deleted() const { return record_->is_deleted; }
+
+    // Voorberekend bij toevoegen en bij reclassify
+    DueClass due_class() const { return static_cast<DueClass>(record_->due_class); }
+    bool is_due_today() const { return due_class() == DUE_CLASS_TODAY; }
+    bool is_overdue() const { return due_class() == DUE_CLASS_OVERDUE; }
+    bool is_due_tomorrow() const { return due_class() == DUE_CLASS_TOMORROW; }
+    std::string get_due_time() const { return due_time_string(record_->due); }
+    uint32_t get_priority_color() const { return priority_color(priority()); }
+
+   protected:
+    const TaskStore *store_;
+    const Record *record_;
+  };
+
+  TaskStore() = default;
+  ~TaskStore();
+  TaskStore(TaskStore &&other) noexcept;
+  TaskStore &operator=(TaskStore &&other) noexcept;
+  TaskStore(const TaskStore &) = delete;
+  TaskStore &operator=(const TaskStore &) = delete;
+
+  // Kopieert de velden van task naar de arena; false als de store vol is
+  bool add(const TodoistTask &task);
+  bool add(const TaskRef &task);
+  void clear();
+  // Haalt één taak weg; de strings blijven in de arena tot de volgende rebuild
+  void remove(size_t index);
+
+  // Past een set wijzigingen van de Sync API toe: items met hetzelfde id worden vervangen (op
+  // dezelfde plek), voltooide/verwijderde items vallen weg. Met replace vervangt changes alles.
+  // De store wordt daarbij compact opnieuw opgebouwd. false als het resultaat niet past; de store
+  // blijft dan ongewijzigd.
+  bool apply_changes(const TaskStore &changes, bool replace);
+
+  // Deelt alle taken opnieuw in ten opzichte van today (dagen sinds 1970-01-01, lokale datum) en
+  // minute (minuut van de dag). Geeft het aantal taken terug waarvan de indeling veranderde.
+  size_t reclassify(int32_t today, uint16_t minute);
+  int32_t today() const { return today_; }
+  // Eerste minuut van vandaag na de huidige waarop een taak met een tijd over de tijd raakt, of -1
+  int32_t next_due_minute() const;
+
+  // Index van de taak met dit id, of -1; O(1) en zonder allocaties
+  int find(const char *id) const;
+
+  size_t size() const { return records_.size(); }
+  bool empty() const { return records_.empty(); }
+  TaskRef operator[](size_t index) const { return TaskRef(this, &records_[index]); }
+
+  // Totaal aantal bytes (records + arena + hash indexen) voor logging
+  size_t memory_usage() const;
+
+ protected:
+  // Leest en schrijft records_ en de arena rechtstreeks
+  friend class TaskSnapshot;
+
+  const char *str_(uint32_t offset) const { return arena_ + offset; }
+  // Voegt s (inclusief nul-terminator) toe en geeft de offset terug
+  bool append_(const char *s, uint32_t &offset);
+  // Als append_, maar hergebruikt een eerder geïnterneerde kopie van s
+  bool intern_(const char *s, uint32_t &offset);
+  // Neemt een string die al in de arena staat op in project_index_, zonder te appenden
+  void index_project_(uint32_t offset);
+  // Verdubbelt project_index_ als er geen ruimte is voor nog een string
+  void grow_project_index_();
+  // Neemt records_[index] op in id_index_; groeit de tabel als hij halfvol raakt
+  void index_id_(size_t index);
+  // Bouwt beide hash indexen opnieuw op uit records_, na remove of een restore
+  void rebuild_index_();
+  bool add_(const char *id, const char *content, const char *description, const char *project_id,
+            DueDate due, const char *due_string, TaskPriority priority, bool is_completed, bool is_deleted);
+  bool reserve_(size_t size);
+
+  std::vector<Record> records_;
+  char *arena_ = nullptr;
+  size_t arena_size_ = 0;
+  size_t arena_capacity_ = 0;
+  // Open addressing met linear probing, grootte een macht van twee en hooguit half vol.
+  // id_index_ bevat record index + 1, project_index_ een arena offset; 0 is een leeg slot.
+  std::vector<uint16_t> id_index_;
+  static_assert(TODOIST_MAX_TASKS < 0xFFFF, "id_index_ stores record index + 1 in 16 bits");
+  std::vector<uint32_t> project_index_;
+  size_t project_count_ = 0;
+  int32_t today_ = 0;
+  uint16_t minute_ = 0;
+};
+
+}  // namespace todoist
+}  // namespace esphome
@@ -0,0 +1,221 @@
+// Piek heap en doorvoer van het response pad: BodyStream met de vaste leesbuffer van TodoistApi
+// tegenover de oude getString() route (Arduino String, dan een kopie in een std::string), voor
+// grote REST en Sync payloads met Content-Length en chunked framing. De verbinding serveert een
+// vooraf opgebouwde buffer, zodat alleen de client kant gemeten wordt; de parser zelf staat in
+// bench_parser.
+//
+//   ./bench_body_stream            alle payloads, piek heap via de malloc teller
+//   ./bench_body_stream string     alleen de grootste payload via getString, met de piek RSS (Linux)
+//   ./bench_body_stream stream     idem via BodyStream
+#include "todoist_body_stream.h"
+#include "alloc_counter.h"
+#include "payloads.h"
+
+#include <malloc.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace esphome::todoist;
+
+// Zoals TodoistApi::READ_BUFFER_SIZE
+static const size_t READ_BUFFER_SIZE = 1024;
+// Een TCP segment per read, zoals de TLS client het ongeveer aanlevert
+static const size_t READ_SLICE = 1460;
+static const size_t CHUNK_SIZE = 4096;
+
+class WireClient : public Client {
+ public:
+  explicit WireClient(const std::string &data) : data_(data) {}
+  int connect(const char *, uint16_t) override { return 1; }
+  uint8_t connected() override { return 1; }
+  void stop() override {}
+  int available() override { return (int) (data_.size() - pos_); }
+  int read() override { return pos_ < data_.size() ? (uint8_t) data_[pos_++] : -1; }
+  int read(uint8_t *buffer, size_t size) override {
+    size_t n = std::min({size, READ_SLICE, data_.size() - pos_});
+    memcpy(buffer, data_.data() + pos_, n);
+    pos_ += n;
+    return n > 0 ? (int) n : -1;
+  }
+  int peek() override { return pos_ < data_.size() ? (uint8_t) data_[pos_] : -1; }
+  size_t write(uint8_t) override { return 1; }
+
+ protected:
+  const std::string &data_;
+  size_t pos_ = 0;
+};
+
+struct Payload {
+  const char *name;
+  std::string body;
+  bool chunked;
+  std::string wire;
+};
+
+static std::string chunked(const std::string &body) {
+  std::string out;
+  for (size_t pos = 0; pos < body.size(); pos += CHUNK_SIZE) {
+    size_t n = std::min(CHUNK_SIZE, body.size() - pos);
+    char header[16];
+    snprintf(header, sizeof(header), "%zx\r\n", n);
+    out += header;
+    out.append(body, pos, n);
+    out += "\r\n";
+  }
+  return out + "0\r\n\r\n";
+}
+
+struct Result {
+  size_t bytes;
+  size_t peak;
+  double ms;
+  uint32_t check;
+};
+
+// De parser leest per teken; een hash houdt de reads zichtbaar voor de compiler
+static uint32_t consume(Stream &stream) {
+  uint32_t hash = 2166136261UL;
+  int c;
+  while ((c = stream.read()) >= 0)
+    hash = (hash ^ (uint8_t) c) * 16777619UL;
+  return hash;
+}
+
+static uint32_t consume(const std::string &body) {
+  uint32_t hash = 2166136261UL;
+  for (char c : body)
+    hash = (hash ^ (uint8_t) c) * 16777619UL;
+  return hash;
+}
+
+static Result run_stream(const Payload &payload) {
+  WireClient client(payload.wire);
+  host::reset_alloc_peak();
+  size_t before = host::alloc_stats().current;
+  auto start = std::chrono::steady_clock::now();
+
+  uint8_t buffer[READ_BUFFER_SIZE];
+  BodyStream body(client, payload.chunked ? -1 : (int32_t) payload.body.size(), payload.chunked, buffer,
+                  sizeof(buffer));
+  uint32_t check = consume(body);
+
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return Result{body.bytes_read(), host::alloc_stats().peak - before, ms, check};
+}
+
+// Wat do_http_request deed: response = http_.getString().c_str(). HTTPClient::getString decodeert
+// de framing in een String die per blok groeit; de chunk headers komen hier uit BodyStream zodat
+// beide routes dezelfde bytes zien.
+static Result run_string(const Payload &payload) {
+  WireClient client(payload.wire);
+  host::reset_alloc_peak();
+  size_t before = host::alloc_stats().current;
+  auto start = std::chrono::steady_clock::now();
+
+  uint32_t check;
+  size_t bytes;
+  {
+    uint8_t buffer[READ_BUFFER_SIZE];
+    BodyStream body(client, payload.chunked ? -1 : (int32_t) payload.body.size(), payload.chunked, buffer,
+                    sizeof(buffer));
+    // Geen wachttijd aan het einde van de body, zoals getString() met bekende lengte
+    body.setTimeout(0);
+    // De String van getString(), die groeit zoals een std::string
+    std::string arduino_string;
+    char block[READ_BUFFER_SIZE];
+    size_t n;
+    while ((n = body.readBytes(block, sizeof(block))) > 0)
+      arduino_string.append(block, n);
+    std::string response = arduino_string.c_str();
+    bytes = response.size();
+    check = consume(response);
+  }
+
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return Result{bytes, host::alloc_stats().peak - before, ms, check};
+}
+
+static std::vector<Payload> payloads(bool largest_only) {
+  host::PayloadOptions small;
+  host::PayloadOptions large;
+  large.description_length = 2000;
+  large.unicode = true;
+
+  std::vector<Payload> out;
+  if (largest_only) {
+    out.push_back({"sync 2000 long", host::sync_items_json(2000, true, "tok", 0, 0, large), true, ""});
+    out.back().wire = chunked(out.back().body);
+    // Alleen de wire bytes blijven, de body is daarna niet meer nodig
+    std::string().swap(out.back().body);
+    return out;
+  }
+  out.push_back({"rest 5", host::rest_tasks_json(5, small), false, ""});
+  out.push_back({"rest 500", host::rest_tasks_json(500, small), false, ""});
+  out.push_back({"rest 500 long", host::rest_tasks_json(500, large), false, ""});
+  out.push_back({"sync 500 long", host::sync_items_json(500, true, "tok", 0, 0, large), true, ""});
+  out.push_back({"sync 2000 long", host::sync_items_json(2000, true, "tok", 0, 0, large), true, ""});
+  for (Payload &payload : out)
+    payload.wire = payload.chunked ? chunked(payload.body) : payload.body;
+  return out;
+}
+
+// Piek RSS (VmHWM) van het proces in kB; Linux
+static long peak_rss_kb() {
+  FILE *f = fopen("/proc/self/status", "r");
+  if (f == nullptr)
+    return -1;
+  char line[128];
+  long kb = -1;
+  while (fgets(line, sizeof(line), f) != nullptr) {
+    if (sscanf(line, "VmHWM: %ld kB", &kb) == 1)
+      break;
+  }
+  fclose(f);
+  return kb;
+}
+
+// Zet VmHWM terug op de huidige RSS, zodat het opbouwen van de payload niet meetelt
+static void reset_peak_rss() {
+  malloc_trim(0);
+  FILE *f = fopen("/proc/self/clear_refs", "w");
+  if (f != nullptr) {
+    fputs("5", f);
+    fclose(f);
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1) {
+    // Eén route in een eigen proces: max RSS telt dan alleen die route (plus de payload zelf)
+    std::vector<Payload> all = payloads(true);
+    const Payload &payload = all.back();
+    bool stream = strcmp(argv[1], "stream") == 0;
+    reset_peak_rss();
+    long rss_before = peak_rss_kb();
+    Result result = stream ? run_stream(payload) : run_string(payload);
+    long rss_after = peak_rss_kb();
+    printf("%s, %s: %zu bytes, heap peak %zu B, peak RSS %ld kB (%+ld kB)\n", payload.name, stream ? "stream" : "string",
+           result.bytes, result.peak, rss_after, rss_after - rss_before);
+    return 0;
+  }
+
+  std::vector<Payload> all = payloads(false);
+  printf("%-16s %10s %14s %14s %12s %12s\n", "payload", "bytes", "string peak B", "stream peak B", "string MB/s",
+         "stream MB/s");
+  for (const Payload &payload : all) {
+    Result string_result = run_string(payload);
+    Result stream_result = run_stream(payload);
+    if (string_result.check != stream_result.check || stream_result.bytes != payload.body.size()) {
+      fprintf(stderr, "%s: routes disagree\n", payload.name);
+      return 1;
+    }
+    printf("%-16s %10zu %14zu %14zu %12.1f %12.1f\n", payload.name, payload.body.size(), string_result.peak,
+           stream_result.peak, payload.body.size() / 1e3 / string_result.ms,
+           payload.body.size() / 1e3 / stream_result.ms);
+  }
+  return 0;
+}
@@ -0,0 +1,83 @@
+// Indeling van taken per render: de oude aanpak (per aanroep time(), localtime_r, strftime en een
+// substr vergelijking, drie keer per taak) tegenover één keer parse_due_date plus classify_due.
+#include "todoist_task.h"
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+
+using namespace esphome::todoist;
+
+// Zoals TodoistTask::is_due_today / is_overdue / is_due_tomorrow voorheen
+static std::string local_date(time_t offset) {
+  time_t now;
+  time(&now);
+  now += offset;
+  struct tm timeinfo;
+  localtime_r(&now, &timeinfo);
+  char date[11];
+  strftime(date, sizeof(date), "%Y-%m-%d", &timeinfo);
+  return date;
+}
+
+static int classify_old(const std::string &due_date) {
+  if (due_date.empty())
+    return DUE_CLASS_NONE;
+  if (due_date.substr(0, 10) < local_date(0))
+    return DUE_CLASS_OVERDUE;
+  if (due_date.substr(0, 10) == local_date(0))
+    return DUE_CLASS_TODAY;
+  return due_date.substr(0, 10) == local_date(24 * 60 * 60) ? DUE_CLASS_TOMORROW : DUE_CLASS_LATER;
+}
+
+int main() {
+  setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+  tzset();
+
+  std::vector<std::string> dates;
+  for (int i = 0; i < 500; i++) {
+    char date[32];
+    snprintf(date, sizeof(date), "2024-%02d-%02dT%02d:%02d:00", 1 + i % 12, 1 + i % 28, i % 24, i % 60);
+    dates.push_back(i % 3 == 0 ? std::string(date, 10) : date);
+  }
+  std::vector<DueDate> parsed;
+  for (const std::string &date : dates)
+    parsed.push_back(parse_due_date(date.c_str()));
+
+  time_t now = time(nullptr);
+  struct tm local;
+  localtime_r(&now, &local);
+  int32_t today = days_from_civil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+  uint16_t minute = local.tm_hour * 60 + local.tm_min;
+
+  static const int ROUNDS = 200;
+  volatile int sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < ROUNDS; round++) {
+    for (const std::string &date : dates)
+      sink += classify_old(date);
+  }
+  double old_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (int round = 0; round < ROUNDS; round++) {
+    for (DueDate due : parsed)
+      sink += classify_due(due, today, minute);
+  }
+  double new_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (int round = 0; round < ROUNDS; round++) {
+    for (const std::string &date : dates)
+      sink += parse_due_date(date.c_str()) != DUE_NONE;
+  }
+  double parse_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  size_t calls = (size_t) ROUNDS * dates.size();
+  printf("old per-call classify:   %8.1f ns/task\n", old_ns / calls);
+  printf("classify_due:            %8.1f ns/task\n", new_ns / calls);
+  printf("parse_due_date (once):   %8.1f ns/task\n", parse_ns / calls);
+  return sink == -1;
+}
@@ -0,0 +1,26 @@
+// Frame tijd van een volledig 480x320 frame volgens het flush model, enkel tegenover dubbel
+// gebufferd, voor een paar buffer hoogtes, bus klokken en render kosten per pixel. De render
+// kosten zijn aannames (vlakken vullen is goedkoop, tekst en anti-aliasing duur); het model laat
+// zien waar de overlap iets oplevert, de echte getallen komen van de FPS counter op het device.
+#include "flush_model.h"
+
+#include <cstdio>
+
+using namespace hd_model;
+
+int main() {
+  printf("%-6s %-8s %-10s %12s %12s %8s %12s\n", "lines", "MHz", "ns/px", "single us", "double us", "gain",
+         "dma wait us");
+  for (uint32_t lines : {10, 20, 40}) {
+    for (uint32_t mhz : {10, 20, 40}) {
+      for (double ns : {10.0, 40.0, 120.0}) {
+        std::vector<Chunk> chunks = full_frame(480, 320, lines, ns, mhz * 1000000);
+        FrameTiming single = single_buffered(chunks);
+        FrameTiming dual = double_buffered(chunks);
+        printf("%-6u %-8u %-10.0f %12u %12u %7.2fx %12u\n", lines, mhz, ns, single.total_us, dual.total_us,
+               (double) single.total_us / dual.total_us, dual.dma_wait_us);
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,92 @@
+// Piek heap en tijd van de streaming parser tegenover de oude aanpak (hele body als string plus
+// één JsonDocument voor de hele array), voor 5, 100 en 2000 taken. De piek is gemeten over het
+// hele proces, dus inclusief de TaskStore en de strings van de taken zelf.
+#include "todoist_api.h"
+#include "alloc_counter.h"
+#include "payloads.h"
+#include "string_stream.h"
+
+#include <ArduinoJson.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace esphome::todoist;
+
+class ParserApi : public TodoistApi {
+ public:
+  using TodoistApi::parse_tasks_stream;
+};
+
+struct Result {
+  size_t tasks;
+  size_t peak;
+  double ms;
+};
+
+static const char *str(JsonVariantConst value) {
+  const char *s = value.as<const char *>();
+  return s != nullptr ? s : "";
+}
+
+// De parse van voor de streaming parser, zonder de cap van 5 taken
+static Result parse_document(const std::string &json) {
+  host::StringStream stream(json);
+  host::reset_alloc_peak();
+  size_t before = host::alloc_stats().current;
+  auto start = std::chrono::steady_clock::now();
+
+  std::string body;
+  while (stream.available() > 0)
+    body += (char) stream.read();
+  std::vector<TodoistTask> tasks;
+  {
+    JsonDocument doc;
+    deserializeJson(doc, body);
+    for (JsonObjectConst obj : doc.as<JsonArrayConst>()) {
+      TodoistTask task;
+      task.id = str(obj["id"]);
+      task.content = str(obj["content"]);
+      const char *description = str(obj["description"]);
+      if (strlen(description) < 100)
+        task.description = description;
+      task.project_id = str(obj["project_id"]);
+      task.due_date = str(obj["due"]["date"]);
+      task.due_string = str(obj["due"]["string"]);
+      tasks.push_back(task);
+    }
+  }
+
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return Result{tasks.size(), host::alloc_stats().peak - before, ms};
+}
+
+static Result parse_stream(ParserApi &api, const std::string &json) {
+  host::StringStream stream(json);
+  TaskStore tasks;
+  std::string error;
+  host::reset_alloc_peak();
+  size_t before = host::alloc_stats().current;
+  auto start = std::chrono::steady_clock::now();
+
+  if (!api.parse_tasks_stream(stream, tasks, error))
+    fprintf(stderr, "parse failed: %s\n", error.c_str());
+
+  double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  return Result{tasks.size(), host::alloc_stats().peak - before, ms};
+}
+
+int main() {
+  ParserApi api;
+  printf("%-8s %-10s %8s %12s %10s\n", "tasks", "parser", "parsed", "peak bytes", "ms");
+  for (size_t count : {5, 100, 2000}) {
+    std::string json = host::rest_tasks_json(count);
+    Result dom = parse_document(json);
+    Result stream = parse_stream(api, json);
+    printf("%-8zu %-10s %8zu %12zu %10.2f\n", count, "document", dom.tasks, dom.peak, dom.ms);
+    printf("%-8zu %-10s %8zu %12zu %10.2f\n", count, "stream", stream.tasks, stream.peak, stream.ms);
+  }
+  printf("body sizes: 5 = %zu, 100 = %zu, 2000 = %zu bytes\n", host::rest_tasks_json(5).size(),
+         host::rest_tasks_json(100).size(), host::rest_tasks_json(2000).size());
+  return 0;
+}
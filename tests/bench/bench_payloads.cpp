@@ -0,0 +1,199 @@
+// Fetch -> parse -> render over het corpus in payloads/: per payload de doorvoer en allocaties
+// van de parser, de tijd van classify_due voor de hele store en (in de simulator) render_tasks_.
+// Elke meting wordt vergeleken met payloads/thresholds.txt; overschrijdt er een, dan eindigt de
+// benchmark met exit code 1, zodat ctest hem als gefaald ziet.
+//
+//   bench_payloads <payloads dir>
+#include "todoist_api.h"
+#include "alloc_counter.h"
+#include "string_stream.h"
+#ifdef BENCH_PAYLOADS_RENDER
+#include "sim_harness.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace esphome::todoist;
+
+class ParserApi : public TodoistApi {
+ public:
+  using TodoistApi::parse_sync_stream;
+  using TodoistApi::parse_tasks_stream;
+};
+
+// metric -> (payload of "*") -> maximum
+using Thresholds = std::map<std::string, std::map<std::string, double>>;
+
+static bool read_file(const std::string &path, std::string &out) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    return false;
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  out = buffer.str();
+  return true;
+}
+
+static bool read_thresholds(const std::string &path, Thresholds &thresholds) {
+  std::ifstream file(path);
+  if (!file)
+    return false;
+  std::string line;
+  while (std::getline(file, line)) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    std::string payload, metric;
+    double max;
+    if (fields >> payload >> metric >> max)
+      thresholds[metric][payload] = max;
+  }
+  return true;
+}
+
+static std::vector<std::string> list_payloads(const std::string &dir) {
+  std::vector<std::string> names;
+  if (DIR *d = opendir(dir.c_str())) {
+    while (dirent *entry = readdir(d)) {
+      std::string name = entry->d_name;
+      if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0)
+        names.push_back(name.substr(0, name.size() - 5));
+    }
+    closedir(d);
+  }
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+static bool parse(ParserApi &api, const std::string &name, const std::string &json, TaskStore &tasks,
+                  std::string &error) {
+  host::StringStream stream(json);
+  if (name.compare(0, 5, "sync_") == 0) {
+    bool full_sync = false;
+    std::string token;
+    return api.parse_sync_stream(stream, tasks, full_sync, token, error);
+  }
+  return api.parse_tasks_stream(stream, tasks, error);
+}
+
+template<typename F> static double ms_of(F &&f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+  std::string dir = argc > 1 ? argv[1] : "payloads";
+  Thresholds thresholds;
+  if (!read_thresholds(dir + "/thresholds.txt", thresholds)) {
+    fprintf(stderr, "Cannot read %s/thresholds.txt\n", dir.c_str());
+    return 2;
+  }
+  std::vector<std::string> payloads = list_payloads(dir);
+  if (payloads.empty()) {
+    fprintf(stderr, "No payloads in %s\n", dir.c_str());
+    return 2;
+  }
+
+  // Vaste dag voor de indeling, dezelfde als de klok van de simulator (2024-03-11 09:00)
+  const int32_t today = days_from_civil(2024, 3, 11);
+  const uint16_t minute = 9 * 60;
+
+  ParserApi api;
+#ifdef BENCH_PAYLOADS_RENDER
+  sim::Harness &harness = sim::Harness::instance();
+  sim::TestComponent &component = harness.boot({});
+#endif
+
+  std::vector<std::string> regressions;
+  auto check = [&](const std::string &payload, const char *metric, double value) {
+    auto limits = thresholds.find(metric);
+    if (limits == thresholds.end())
+      return;
+    auto limit = limits->second.find(payload);
+    if (limit == limits->second.end())
+      limit = limits->second.find("*");
+    if (limit != limits->second.end() && value > limit->second) {
+      char message[160];
+      snprintf(message, sizeof(message), "%s %s = %.1f, threshold %.1f", payload.c_str(), metric, value, limit->second);
+      regressions.push_back(message);
+    }
+  };
+
+  printf("%-24s %6s %8s %8s %9s %9s %10s %10s %10s\n", "payload", "tasks", "kB", "MB/s", "ns/task", "alloc/task",
+         "peak B", "class ns", "render us");
+  for (const std::string &name : payloads) {
+    std::string json;
+    if (!read_file(dir + "/" + name + ".json", json)) {
+      fprintf(stderr, "Cannot read %s\n", name.c_str());
+      return 2;
+    }
+
+    // Eén keer voor de allocaties en de piek, daarna herhaald voor de tijd
+    TaskStore tasks;
+    std::string error;
+    host::reset_alloc_peak();
+    size_t before = host::alloc_stats().current;
+    if (!parse(api, name, json, tasks, error)) {
+      fprintf(stderr, "%s: %s\n", name.c_str(), error.c_str());
+      return 2;
+    }
+    host::AllocStats allocs = host::alloc_stats();
+    size_t parsed = tasks.size();
+    size_t count = std::max<size_t>(parsed, 1);
+
+    size_t rounds = 0;
+    double parse_ms = 0;
+    while (rounds < 5 || (parse_ms < 200 && rounds < 1000)) {
+      parse_ms += ms_of([&] {
+        TaskStore again;
+        parse(api, name, json, again, error);
+      });
+      rounds++;
+    }
+    parse_ms /= rounds;
+
+    // Wisselend tussen twee dagen, zodat elke ronde echt opnieuw indeelt
+    static const int CLASSIFY_ROUNDS = 2000;
+    double classify_ms = ms_of([&] {
+      for (int i = 0; i < CLASSIFY_ROUNDS; i++)
+        tasks.reclassify(today + (i & 1), minute);
+    });
+    tasks.reclassify(today, minute);
+
+    double render_us = 0;
+#ifdef BENCH_PAYLOADS_RENDER
+    component.tasks_ = std::move(tasks);
+    component.tasks_changed_();
+    render_us = ms_of([&] { component.render_tasks_(); }) * 1000;
+    harness.run(100);
+#endif
+
+    double mb_per_s = json.size() / 1e6 / (parse_ms / 1000);
+    double ns_per_task = parse_ms * 1e6 / count;
+    double allocs_per_task = (double) allocs.allocations / count;
+    size_t peak = allocs.peak - before;
+    double classify_ns = classify_ms * 1e6 / CLASSIFY_ROUNDS / count;
+    printf("%-24s %6u %8.1f %8.1f %9.0f %9.1f %10u %10.1f %10.0f\n", name.c_str(), (unsigned) parsed,
+           json.size() / 1024.0, mb_per_s, ns_per_task, allocs_per_task, (unsigned) peak, classify_ns, render_us);
+
+    check(name, "parse_ns_per_byte", parse_ms * 1e6 / json.size());
+    check(name, "allocs_per_task", allocs_per_task);
+    check(name, "peak_bytes", peak);
+    check(name, "classify_ns_per_task", classify_ns);
+#ifdef BENCH_PAYLOADS_RENDER
+    check(name, "render_us", render_us);
+#endif
+  }
+
+  for (const std::string &regression : regressions)
+    printf("REGRESSION: %s\n", regression.c_str());
+  return regressions.empty() ? 0 : 1;
+}
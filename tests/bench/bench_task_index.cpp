@@ -0,0 +1,96 @@
+// Opzoeken op id en geheugen bij 1k en 10k taken: TaskStore (hash index, geïnterneerde project
+// ids) tegenover de oude std::vector<TodoistTask> met lineair zoeken. Gebouwd tegen
+// todoist_core_large, met MAX_TASKS en MAX_ARENA_SIZE verhoogd tot boven de 10k.
+#include "todoist_task_store.h"
+#include "alloc_counter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace esphome::todoist;
+
+static TodoistTask make_task(size_t index) {
+  TodoistTask task;
+  task.id = std::to_string(7000000000ULL + index * 7919);
+  task.content = "Taak " + std::to_string(index) + " boodschappen doen";
+  task.description = index % 3 == 0 ? "Melk, brood en kaas" : "";
+  task.project_id = std::to_string(2300000000ULL + (index % 20) * 104729);
+  task.due_date = "2024-03-01T10:00:00";
+  task.due_string = "elke dag om 10:00";
+  task.priority = static_cast<TaskPriority>(1 + index % 4);
+  return task;
+}
+
+static int find_linear(const std::vector<TodoistTask> &tasks, const char *id) {
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (strcmp(tasks[i].id.c_str(), id) == 0)
+      return i;
+  }
+  return -1;
+}
+
+template<typename F> static double ns_per_call(size_t calls, F &&f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / calls;
+}
+
+int main() {
+  static const size_t LOOKUPS = 200000;
+  volatile int sink = 0;
+
+  printf("%-7s %14s %14s %14s %14s %14s\n", "tasks", "vector B/task", "store B/task", "vector ns/hit",
+         "store ns/hit", "store ns/miss");
+  for (size_t count : {1000, 10000}) {
+    std::vector<TodoistTask> input;
+    for (size_t i = 0; i < count; i++)
+      input.push_back(make_task(i));
+    // Willekeurige volgorde, zodat de lineaire zoektocht gemiddeld de halve lijst afloopt
+    std::vector<std::string> hits;
+    std::vector<std::string> misses;
+    std::mt19937 rng(12345);
+    for (size_t i = 0; i < 1024; i++) {
+      hits.push_back(input[rng() % count].id);
+      misses.push_back(std::to_string(8000000000ULL + rng()));
+    }
+
+    size_t before = host::alloc_stats().current;
+    std::vector<TodoistTask> tasks(input.begin(), input.end());
+    size_t vector_bytes = host::alloc_stats().current - before;
+
+    before = host::alloc_stats().current;
+    TaskStore store;
+    for (const TodoistTask &task : input) {
+      if (!store.add(task)) {
+        fprintf(stderr, "TaskStore full at %zu tasks\n", store.size());
+        return 1;
+      }
+    }
+    size_t store_bytes = host::alloc_stats().current - before;
+
+    // Lineair zoeken is bij 10k te traag voor evenveel lookups
+    size_t linear_lookups = LOOKUPS / (count / 100);
+    double vector_hit = ns_per_call(linear_lookups, [&] {
+      for (size_t i = 0; i < linear_lookups; i++)
+        sink = sink + find_linear(tasks, hits[i % hits.size()].c_str());
+    });
+    double store_hit = ns_per_call(LOOKUPS, [&] {
+      for (size_t i = 0; i < LOOKUPS; i++)
+        sink = sink + store.find(hits[i % hits.size()].c_str());
+    });
+    double store_miss = ns_per_call(LOOKUPS, [&] {
+      for (size_t i = 0; i < LOOKUPS; i++)
+        sink = sink + store.find(misses[i % misses.size()].c_str());
+    });
+
+    printf("%-7zu %14.1f %14.1f %14.1f %14.1f %14.1f\n", count, (double) vector_bytes / count,
+           (double) store_bytes / count, vector_hit, store_hit, store_miss);
+  }
+  return 0;
+}
@@ -0,0 +1,44 @@
+// Frame tijd en LVGL heap van de gevirtualiseerde takenlijst bij 10, 200 en 1000 taken, in de
+// simulator (sim/). Per lijstlengte: opstarten tot de eerste sync getekend is, daarna tien keer
+// naar beneden vegen. Tijden zijn wandkloktijd op de host, de heap is de LVGL pool met 64-bit
+// pointers; vergelijk de lijstlengtes onderling, niet met het device.
+#include "sim_harness.h"
+
+#include <cstdio>
+
+using namespace sim;
+
+int main() {
+  Harness &harness = Harness::instance();
+  Display &display = harness.display();
+
+  printf("%-6s %8s %6s %10s %10s %10s %10s %8s %10s %10s\n", "tasks", "objects", "rows", "heap B", "peak B",
+         "boot ms", "boot px", "frames", "scroll ms", "max ms");
+  for (size_t count : {10, 200, 1000}) {
+    std::vector<host::SyncItem> tasks = Harness::make_tasks(count);
+    for (size_t i = 0; i < count; i += 5) {
+      tasks[i].due = YESTERDAY;
+    }
+
+    display.take_stats();
+    display.reset_heap_peak();
+    TestComponent &component = harness.boot(tasks);
+    FrameStats boot = display.take_stats();
+    if (component.tasks_.size() != count) {
+      fprintf(stderr, "Expected %u tasks, got %u\n", (unsigned) count, (unsigned) component.tasks_.size());
+      return 1;
+    }
+
+    for (int i = 0; i < 10; i++) {
+      harness.swipe(-200);
+    }
+    FrameStats scroll = display.take_stats();
+    lv_mem_monitor_t heap = Display::heap();
+
+    printf("%-6u %8u %6u %10u %10u %10.2f %10llu %8u %10.2f %10.2f\n", (unsigned) count,
+           (unsigned) Display::count_objects(), (unsigned) component.rows_created_,
+           (unsigned) (heap.total_size - heap.free_size), (unsigned) display.heap_peak(), boot.frame_ms_total,
+           (unsigned long long) boot.rendered_px, (unsigned) scroll.frames, scroll.frame_ms_avg(), scroll.frame_ms_max);
+  }
+  return 0;
+}
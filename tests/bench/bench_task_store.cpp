@@ -0,0 +1,58 @@
+// Geheugen per taak: TaskStore tegenover de oude std::vector<TodoistTask>, gemeten met de malloc
+// teller (inclusief allocator overhead) en zoals TaskStore::memory_usage() het logt.
+#include "todoist_task_store.h"
+#include "alloc_counter.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace esphome::todoist;
+
+static TodoistTask make_task(size_t index) {
+  TodoistTask task;
+  task.id = std::to_string(7000000000ULL + index * 7919);
+  task.content = "Taak " + std::to_string(index) + " boodschappen doen";
+  task.description = index % 3 == 0 ? "Melk, brood en kaas" : "";
+  task.project_id = std::to_string(2300000000ULL + (index % 5) * 104729);
+  task.due_date = "2024-03-01T10:00:00";
+  task.due_string = "elke dag om 10:00";
+  task.priority = static_cast<TaskPriority>(1 + index % 4);
+  return task;
+}
+
+int main() {
+  // De TodoistTask's zelf vooraf, zodat alleen de opslag gemeten wordt
+  std::vector<TodoistTask> input;
+  for (size_t i = 0; i < TaskStore::MAX_TASKS; i++)
+    input.push_back(make_task(i));
+
+  printf("%-8s %16s %16s %16s\n", "tasks", "vector B/task", "store B/task", "usage B/task");
+  for (size_t count : {5, 100, 500}) {
+    host::reset_alloc_peak();
+    size_t before = host::alloc_stats().current;
+    size_t vector_bytes;
+    {
+      std::vector<TodoistTask> tasks;
+      for (size_t i = 0; i < count; i++)
+        tasks.push_back(input[i]);
+      vector_bytes = host::alloc_stats().current - before;
+    }
+
+    before = host::alloc_stats().current;
+    size_t store_bytes, usage;
+    {
+      TaskStore store;
+      for (size_t i = 0; i < count; i++)
+        store.add(input[i]);
+      store_bytes = host::alloc_stats().current - before;
+      usage = store.memory_usage();
+    }
+
+    printf("%-8zu %16.1f %16.1f %16.1f\n", count, (double) vector_bytes / count, (double) store_bytes / count,
+           (double) usage / count);
+  }
+  printf("sizeof(TodoistTask) = %zu, sizeof(TaskStore::Record) = %zu\n", sizeof(TodoistTask),
+         sizeof(TaskStore::Record));
+  return 0;
+}
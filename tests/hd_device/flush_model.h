@@ -0,0 +1,65 @@
+#pragma once
+
+// Tijdmodel van de flush pipeline van HaDeckDevice, los van LVGL en LovyanGFX. Een frame bestaat uit
+// chunks ter grootte van de draw buffer; LVGL rendert een chunk en roept flush_pixels aan.
+//
+// Enkele buffer: flush_pixels schrijft blokkerend, LVGL rendert pas weer na flush_ready.
+// Dubbele buffer: flush_pixels wacht met waitDMA() op de vorige transfer, start de DMA en roept
+// meteen flush_ready aan, zodat LVGL de volgende chunk in de andere buffer rendert terwijl deze
+// over de bus gaat.
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace hd_model {
+
+struct Chunk {
+  uint32_t render_us;
+  uint32_t transfer_us;
+};
+
+struct FrameTiming {
+  uint32_t total_us;
+  // Tijd die flush_pixels in waitDMA() doorbracht
+  uint32_t dma_wait_us;
+};
+
+inline FrameTiming single_buffered(const std::vector<Chunk> &chunks) {
+  uint32_t t = 0;
+  for (const Chunk &chunk : chunks)
+    t += chunk.render_us + chunk.transfer_us;
+  return FrameTiming{t, 0};
+}
+
+inline FrameTiming double_buffered(const std::vector<Chunk> &chunks) {
+  uint32_t render_start = 0;  // LVGL mag beginnen met renderen
+  uint32_t dma_done = 0;      // Vorige transfer klaar, die buffer is weer vrij
+  uint32_t waited = 0;
+  for (const Chunk &chunk : chunks) {
+    uint32_t flush = render_start + chunk.render_us;
+    uint32_t dma_start = std::max(flush, dma_done);
+    waited += dma_start - flush;
+    dma_done = dma_start + chunk.transfer_us;
+    // flush_ready direct na het starten van de DMA
+    render_start = dma_start;
+  }
+  return FrameTiming{dma_done, waited};
+}
+
+// Een volledig frame van width x height in stukken van buffer_lines regels. De bus is 8 bits
+// breed (één byte per write clock), RGB565 is twee bytes per pixel.
+inline std::vector<Chunk> full_frame(uint32_t width, uint32_t height, uint32_t buffer_lines, double render_ns_per_px,
+                                     uint32_t write_hz) {
+  std::vector<Chunk> chunks;
+  for (uint32_t y = 0; y < height; y += buffer_lines) {
+    uint32_t pixels = width * std::min(buffer_lines, height - y);
+    Chunk chunk;
+    chunk.render_us = (uint32_t) (pixels * render_ns_per_px / 1000.0);
+    chunk.transfer_us = (uint32_t) ((uint64_t) pixels * 2 * 1000000 / write_hz);
+    chunks.push_back(chunk);
+  }
+  return chunks;
+}
+
+}  // namespace hd_model
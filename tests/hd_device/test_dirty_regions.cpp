@@ -0,0 +1,197 @@
+// coalesce_dirty_areas en TileHashes, tegen de minimale LVGL typen in stubs/lvgl_min
+#include "hd_dirty_regions.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace esphome::hd_device;
+
+static lv_area_t area(int x1, int y1, int x2, int y2) {
+  lv_area_t a;
+  a.x1 = x1;
+  a.y1 = y1;
+  a.x2 = x2;
+  a.y2 = y2;
+  return a;
+}
+
+static bool operator==(const lv_area_t &a, const lv_area_t &b) {
+  return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2;
+}
+
+static std::ostream &operator<<(std::ostream &os, const lv_area_t &a) {
+  return os << "(" << a.x1 << "," << a.y1 << ")-(" << a.x2 << "," << a.y2 << ")";
+}
+
+static lv_disp_t display(const std::vector<lv_area_t> &areas) {
+  lv_disp_t disp{};
+  for (const lv_area_t &a : areas) {
+    disp.inv_area_joined[disp.inv_p] = 0;
+    disp.inv_areas[disp.inv_p++] = a;
+  }
+  return disp;
+}
+
+// ---- coalesce_dirty_areas ----
+
+TEST(CoalesceDirtyAreasTest, MergesAdjacentListRows) {
+  lv_disp_t disp = display({area(0, 40, 479, 79), area(0, 80, 479, 119)});
+  coalesce_dirty_areas(&disp);
+  ASSERT_EQ(disp.inv_p, 1);
+  EXPECT_EQ(disp.inv_areas[0], area(0, 40, 479, 119));
+}
+
+TEST(CoalesceDirtyAreasTest, MergesAChainInAnyOrder) {
+  lv_disp_t disp = display({area(0, 120, 479, 159), area(0, 40, 479, 79), area(0, 80, 479, 119)});
+  coalesce_dirty_areas(&disp);
+  ASSERT_EQ(disp.inv_p, 1);
+  EXPECT_EQ(disp.inv_areas[0], area(0, 40, 479, 159));
+}
+
+TEST(CoalesceDirtyAreasTest, KeepsDistantAreasApart) {
+  // Klok rechtsboven en een regel onderaan de lijst
+  lv_disp_t disp = display({area(400, 0, 479, 23), area(0, 280, 479, 319)});
+  coalesce_dirty_areas(&disp);
+  ASSERT_EQ(disp.inv_p, 2);
+  EXPECT_EQ(disp.inv_areas[0], area(400, 0, 479, 23));
+  EXPECT_EQ(disp.inv_areas[1], area(0, 280, 479, 319));
+}
+
+TEST(CoalesceDirtyAreasTest, AllowsAGapOfAboutATile) {
+  // Join 48x16 = 768 px tegenover 2 x 256 px los: binnen de marge van twee tegels
+  lv_disp_t close = display({area(0, 0, 15, 15), area(32, 0, 47, 15)});
+  coalesce_dirty_areas(&close);
+  EXPECT_EQ(close.inv_p, 1);
+
+  lv_disp_t far = display({area(0, 0, 15, 15), area(96, 0, 111, 15)});
+  coalesce_dirty_areas(&far);
+  EXPECT_EQ(far.inv_p, 2);
+}
+
+TEST(CoalesceDirtyAreasTest, AbsorbsNestedAreasAndClearsTheJoinedFlags) {
+  lv_disp_t disp = display({area(10, 10, 20, 20), area(0, 0, 100, 100), area(300, 300, 310, 310)});
+  disp.inv_area_joined[2] = 1;
+  coalesce_dirty_areas(&disp);
+  ASSERT_EQ(disp.inv_p, 2);
+  EXPECT_EQ(disp.inv_areas[0], area(0, 0, 100, 100));
+  EXPECT_EQ(disp.inv_areas[1], area(300, 300, 310, 310));
+  EXPECT_EQ(disp.inv_area_joined[0], 0);
+  EXPECT_EQ(disp.inv_area_joined[1], 0);
+}
+
+TEST(CoalesceDirtyAreasTest, LeavesASingleAreaAlone) {
+  lv_disp_t disp = display({area(5, 6, 7, 8)});
+  coalesce_dirty_areas(&disp);
+  ASSERT_EQ(disp.inv_p, 1);
+  EXPECT_EQ(disp.inv_areas[0], area(5, 6, 7, 8));
+}
+
+// ---- TileHashes ----
+
+class TileHashesTest : public ::testing::Test {
+ protected:
+  static const int WIDTH = 480;
+  static const int HEIGHT = 320;
+  static const int TILE_H = 10;
+
+  void SetUp() override {
+    ASSERT_TRUE(tiles_.setup(WIDTH, HEIGHT, TILE_WIDTH, TILE_H));
+    frame_.assign(WIDTH * HEIGHT, 0x1234);
+  }
+
+  // Kopieert area uit het frame naar een flush buffer zoals LVGL hem aanlevert
+  std::vector<lv_area_t> flush(const lv_area_t &a) {
+    std::vector<uint16_t> pixels;
+    for (int y = a.y1; y <= a.y2; y++)
+      for (int x = a.x1; x <= a.x2; x++)
+        pixels.push_back(frame_[y * WIDTH + x]);
+    return tiles_.diff(&a, pixels.data());
+  }
+
+  void set(int x, int y, uint16_t color) { frame_[y * WIDTH + x] = color; }
+
+  TileHashes tiles_;
+  std::vector<uint16_t> frame_;
+};
+
+TEST_F(TileHashesTest, PushesEverythingTheFirstTime) {
+  std::vector<lv_area_t> runs = flush(area(0, 0, WIDTH - 1, 39));
+  ASSERT_EQ(runs.size(), 1u);
+  EXPECT_EQ(runs[0], area(0, 0, WIDTH - 1, 39));
+}
+
+TEST_F(TileHashesTest, SkipsAnUnchangedArea) {
+  flush(area(0, 0, WIDTH - 1, HEIGHT - 1));
+  EXPECT_TRUE(flush(area(0, 0, WIDTH - 1, HEIGHT - 1)).empty());
+  EXPECT_TRUE(flush(area(32, 20, 95, 59)).empty());
+}
+
+TEST_F(TileHashesTest, PushesOnlyTheChangedTile) {
+  flush(area(0, 0, WIDTH - 1, 59));
+  set(37, 23, 0xFFFF);
+  std::vector<lv_area_t> runs = flush(area(0, 0, WIDTH - 1, 59));
+  ASSERT_EQ(runs.size(), 1u);
+  EXPECT_EQ(runs[0], area(32, 20, 47, 29));
+}
+
+TEST_F(TileHashesTest, MergesNeighbouringTilesIntoRuns) {
+  flush(area(0, 0, WIDTH - 1, 19));
+  // Twee naast elkaar, één verderop in dezelfde tegelrij
+  set(16, 5, 0);
+  set(40, 5, 0);
+  set(200, 5, 0);
+  std::vector<lv_area_t> runs = flush(area(0, 0, WIDTH - 1, 19));
+  ASSERT_EQ(runs.size(), 2u);
+  EXPECT_EQ(runs[0], area(16, 0, 47, 9));
+  EXPECT_EQ(runs[1], area(192, 0, 207, 9));
+}
+
+TEST_F(TileHashesTest, ExtendsARunDownwardsOverTheSameColumns) {
+  flush(area(0, 0, WIDTH - 1, 39));
+  for (int y = 0; y < 40; y++)
+    set(100, y, 0);
+  std::vector<lv_area_t> runs = flush(area(0, 0, WIDTH - 1, 39));
+  ASSERT_EQ(runs.size(), 1u);
+  EXPECT_EQ(runs[0], area(96, 0, 111, 39));
+}
+
+TEST_F(TileHashesTest, AlwaysPushesAndForgetsPartlyCoveredTiles) {
+  flush(area(0, 0, WIDTH - 1, 19));
+  // Begint midden in tegel 0, eindigt midden in tegel 2 en begint halverwege een tegelrij
+  std::vector<lv_area_t> runs = flush(area(8, 5, 39, 19));
+  ASSERT_EQ(runs.size(), 3u);
+  EXPECT_EQ(runs[0], area(8, 5, 39, 9));
+  EXPECT_EQ(runs[1], area(8, 10, 15, 19));
+  EXPECT_EQ(runs[2], area(32, 10, 39, 19));
+
+  // Tegel 0 en 2 zijn vergeten en gaan bij de volgende flush opnieuw mee, tegel 1 niet
+  runs = flush(area(0, 10, WIDTH - 1, 19));
+  ASSERT_EQ(runs.size(), 2u);
+  EXPECT_EQ(runs[0], area(0, 10, 15, 19));
+  EXPECT_EQ(runs[1], area(32, 10, 47, 19));
+}
+
+TEST_F(TileHashesTest, PushesEverythingAfterInvalidate) {
+  flush(area(0, 0, WIDTH - 1, 19));
+  tiles_.invalidate();
+  std::vector<lv_area_t> runs = flush(area(0, 0, WIDTH - 1, 19));
+  ASSERT_EQ(runs.size(), 1u);
+  EXPECT_EQ(runs[0], area(0, 0, WIDTH - 1, 19));
+}
+
+TEST_F(TileHashesTest, DetectsAChangeThatKeepsThePixelSum) {
+  flush(area(0, 0, 15, 9));
+  // Twee pixels wisselen van plaats
+  set(0, 0, 0x0001);
+  set(1, 0, 0x1234 + 0x1234 - 0x0001);
+  EXPECT_EQ(flush(area(0, 0, 15, 9)).size(), 1u);
+}
+
+TEST(TileHashesWithoutSetupTest, PushesTheWholeArea) {
+  TileHashes tiles;
+  std::vector<uint16_t> pixels(100, 0);
+  lv_area_t a = area(0, 0, 9, 9);
+  const std::vector<lv_area_t> &runs = tiles.diff(&a, pixels.data());
+  ASSERT_EQ(runs.size(), 1u);
+  EXPECT_EQ(runs[0], a);
+}
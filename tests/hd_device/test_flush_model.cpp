@@ -0,0 +1,62 @@
+// Overlap van renderen en DMA in het flush model
+#include "flush_model.h"
+
+#include <gtest/gtest.h>
+
+using namespace hd_model;
+
+TEST(FlushModelTest, SingleBufferSerializesRenderAndTransfer) {
+  std::vector<Chunk> chunks(8, Chunk{100, 300});
+  EXPECT_EQ(single_buffered(chunks).total_us, 8u * 400);
+}
+
+TEST(FlushModelTest, BalancedChunksOverlapAllButOneStage) {
+  std::vector<Chunk> chunks(8, Chunk{200, 200});
+  // Eerste render, dan loopt elke transfer parallel aan de volgende render
+  EXPECT_EQ(double_buffered(chunks).total_us, 200u + 8 * 200);
+  EXPECT_EQ(double_buffered(chunks).dma_wait_us, 0u);
+}
+
+TEST(FlushModelTest, TransferBoundFramesWaitOnTheBus) {
+  std::vector<Chunk> chunks(8, Chunk{100, 300});
+  FrameTiming timing = double_buffered(chunks);
+  EXPECT_EQ(timing.total_us, 100u + 8 * 300);
+  // Vanaf de tweede chunk wacht flush_pixels 200 us op de vorige transfer
+  EXPECT_EQ(timing.dma_wait_us, 7u * 200);
+}
+
+TEST(FlushModelTest, RenderBoundFramesNeverWait) {
+  std::vector<Chunk> chunks(8, Chunk{300, 100});
+  FrameTiming timing = double_buffered(chunks);
+  EXPECT_EQ(timing.total_us, 8u * 300 + 100);
+  EXPECT_EQ(timing.dma_wait_us, 0u);
+}
+
+TEST(FlushModelTest, DoubleBufferingIsBoundedByTheSlowestStage) {
+  for (uint32_t lines : {10, 20, 40}) {
+    for (uint32_t hz : {10000000, 20000000, 40000000}) {
+      for (double ns : {10.0, 40.0, 120.0}) {
+        std::vector<Chunk> chunks = full_frame(480, 320, lines, ns, hz);
+        uint32_t render = 0, transfer = 0;
+        for (const Chunk &chunk : chunks) {
+          render += chunk.render_us;
+          transfer += chunk.transfer_us;
+        }
+        uint32_t single = single_buffered(chunks).total_us;
+        uint32_t dual = double_buffered(chunks).total_us;
+        EXPECT_LE(dual, single);
+        EXPECT_GE(dual, std::max(render, transfer));
+        // Nooit meer dan één chunk aan niet-overlappende tijd
+        EXPECT_LE(dual, std::max(render, transfer) + chunks[0].render_us + chunks[0].transfer_us);
+      }
+    }
+  }
+}
+
+TEST(FlushModelTest, FullFrameCoversEveryLine) {
+  std::vector<Chunk> chunks = full_frame(480, 320, 30, 0, 20000000);
+  ASSERT_EQ(chunks.size(), 11u);
+  // 10 volle stukken van 30 regels en een laatste van 20
+  EXPECT_EQ(chunks[0].transfer_us, 480u * 30 * 2 / 20);
+  EXPECT_EQ(chunks[10].transfer_us, 480u * 20 * 2 / 20);
+}
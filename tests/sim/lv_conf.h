@@ -0,0 +1,22 @@
+// LVGL configuratie voor de simulator: die van het device, alleen de tick komt van de host klok
+// (millis() uit de stand-in, maar via een C header), een assert breekt af in plaats van te hangen
+// en de pool is twee keer zo groot, omdat pointers in LVGL objecten op de host 8 bytes zijn
+#ifndef SIM_LV_CONF_H
+#define SIM_LV_CONF_H
+
+#include "../../components/hd_device_sc01_plus/lv_conf.h"
+
+#undef LV_TICK_CUSTOM_INCLUDE
+#undef LV_TICK_CUSTOM_SYS_TIME_EXPR
+#define LV_TICK_CUSTOM_INCLUDE "sim_tick.h"
+#define LV_TICK_CUSTOM_SYS_TIME_EXPR (sim_tick_ms())
+
+#undef LV_MEM_SIZE
+#define LV_MEM_SIZE (64U * 1024U)
+
+#undef LV_ASSERT_HANDLER_INCLUDE
+#undef LV_ASSERT_HANDLER
+#define LV_ASSERT_HANDLER_INCLUDE <stdlib.h>
+#define LV_ASSERT_HANDLER abort();
+
+#endif  // SIM_LV_CONF_H
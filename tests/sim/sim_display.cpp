@@ -0,0 +1,222 @@
+#include "sim_display.h"
+#include "../../components/hd_device_sc01_plus/hd_dirty_regions.h"
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace sim {
+
+using esphome::hd_device::TILE_WIDTH;
+
+// Net als op het device één set hashes voor de flush callback
+static esphome::hd_device::TileHashes tiles;
+static Display *display = nullptr;
+
+Display &Display::instance(uint16_t buffer_lines) {
+  if (display == nullptr) {
+    display = new Display(buffer_lines);
+  }
+  return *display;
+}
+
+Display::Display(uint16_t buffer_lines) {
+  lv_init();
+
+  // Zelfde keuzes als HaDeckDevice::setup(); de flush is hier synchroon, dus één buffer is genoeg
+  size_t buf_pixels = (size_t) WIDTH * buffer_lines;
+  buffer_.resize(buf_pixels);
+  framebuffer_.assign((size_t) WIDTH * HEIGHT, 0);
+  lv_disp_draw_buf_init(&draw_buf_, buffer_.data(), nullptr, buf_pixels);
+
+  while (tile_lines_ * 2 <= TILE_WIDTH && (size_t) WIDTH * tile_lines_ * 2 <= buf_pixels) {
+    tile_lines_ *= 2;
+  }
+  tiles.setup(WIDTH, HEIGHT, TILE_WIDTH, tile_lines_);
+
+  lv_disp_drv_init(&disp_drv_);
+  disp_drv_.hor_res = WIDTH;
+  disp_drv_.ver_res = HEIGHT;
+  disp_drv_.flush_cb = flush_cb_;
+  disp_drv_.rounder_cb = rounder_cb_;
+  disp_drv_.monitor_cb = monitor_cb_;
+  disp_drv_.draw_buf = &draw_buf_;
+  disp_drv_.user_data = this;
+  disp_ = lv_disp_drv_register(&disp_drv_);
+  lv_timer_set_cb(disp_->refr_timer, refr_timer_cb_);
+
+  lv_indev_drv_init(&indev_drv_);
+  indev_drv_.type = LV_INDEV_TYPE_POINTER;
+  indev_drv_.long_press_time = 1000;
+  indev_drv_.long_press_repeat_time = 300;
+  indev_drv_.read_cb = read_cb_;
+  indev_drv_.user_data = this;
+  lv_indev_drv_register(&indev_drv_);
+
+  lv_obj_t *screen = lv_scr_act();
+  lv_obj_set_style_bg_color(screen, lv_color_hex(0x303030), LV_PART_MAIN);
+  lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(screen, 0, LV_PART_MAIN);
+  lv_obj_set_style_border_width(screen, 0, LV_PART_MAIN);
+}
+
+void Display::run(uint32_t ms, const std::function<void()> &loop, uint32_t step_ms) {
+  for (uint32_t elapsed = 0; elapsed < ms; elapsed += step_ms) {
+    host::advance_millis(step_ms);
+    lv_timer_handler();
+    if (loop) {
+      loop();
+    }
+    sample_heap_();
+  }
+}
+
+void Display::press(lv_coord_t x, lv_coord_t y) {
+  touch_.x = x;
+  touch_.y = y;
+  pressed_ = true;
+}
+
+void Display::release() { pressed_ = false; }
+
+void Display::tap(lv_coord_t x, lv_coord_t y, const std::function<void()> &loop) {
+  // Lang genoeg voor een paar indev reads, kort genoeg om geen long press te zijn
+  press(x, y);
+  run(100, loop);
+  release();
+  run(100, loop);
+}
+
+void Display::drag(lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2, uint16_t steps,
+                   const std::function<void()> &loop) {
+  press(x1, y1);
+  run(LV_INDEV_DEF_READ_PERIOD * 2, loop);
+  for (uint16_t i = 1; i <= steps; i++) {
+    press(x1 + (x2 - x1) * i / steps, y1 + (y2 - y1) * i / steps);
+    run(LV_INDEV_DEF_READ_PERIOD, loop);
+  }
+  release();
+  run(LV_INDEV_DEF_READ_PERIOD * 2, loop);
+}
+
+lv_point_t Display::center_of(lv_obj_t *obj) {
+  lv_area_t area;
+  lv_obj_get_coords(obj, &area);
+  lv_point_t point;
+  point.x = (area.x1 + area.x2) / 2;
+  point.y = (area.y1 + area.y2) / 2;
+  return point;
+}
+
+FrameStats Display::take_stats() {
+  FrameStats stats = stats_;
+  stats_ = FrameStats();
+  return stats;
+}
+
+void Display::reset_heap_peak() {
+  heap_peak_ = 0;
+  sample_heap_();
+}
+
+lv_mem_monitor_t Display::heap() {
+  lv_mem_monitor_t monitor;
+  lv_mem_monitor(&monitor);
+  return monitor;
+}
+
+void Display::sample_heap_() {
+  lv_mem_monitor_t monitor = heap();
+  uint32_t used = monitor.total_size - monitor.free_size;
+  heap_peak_ = std::max(heap_peak_, used);
+}
+
+uint32_t Display::framebuffer_hash() const {
+  uint32_t hash = 2166136261UL;
+  for (uint16_t pixel : framebuffer_) {
+    hash = (hash ^ pixel) * 16777619UL;
+  }
+  return hash;
+}
+
+static size_t count_tree(lv_obj_t *obj, bool only_new, bool mark) {
+  size_t count = !only_new || !lv_obj_has_flag(obj, LV_OBJ_FLAG_USER_4) ? 1 : 0;
+  if (mark) {
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_USER_4);
+  }
+  uint32_t children = lv_obj_get_child_cnt(obj);
+  for (uint32_t i = 0; i < children; i++) {
+    count += count_tree(lv_obj_get_child(obj, i), only_new, mark);
+  }
+  return count;
+}
+
+size_t Display::count_objects() { return count_tree(lv_scr_act(), false, false) + count_tree(lv_layer_top(), false, false); }
+
+void Display::mark_objects() {
+  count_tree(lv_scr_act(), false, true);
+  count_tree(lv_layer_top(), false, true);
+}
+
+size_t Display::count_new_objects() { return count_tree(lv_scr_act(), true, false) + count_tree(lv_layer_top(), true, false); }
+
+void Display::flush_cb_(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) {
+  Display *self = static_cast<Display *>(drv->user_data);
+  int32_t w = area->x2 - area->x1 + 1;
+  const uint16_t *pixels = (const uint16_t *) &color_p->full;
+
+  // Wat het device over de bus zou sturen
+  for (const lv_area_t &run : tiles.diff(area, pixels)) {
+    self->stats_.flushed_px += (uint32_t) (run.x2 - run.x1 + 1) * (run.y2 - run.y1 + 1);
+  }
+
+  int32_t x1 = std::max<int32_t>(area->x1, 0);
+  int32_t x2 = std::min<int32_t>(area->x2, WIDTH - 1);
+  for (int32_t y = std::max<int32_t>(area->y1, 0); y <= area->y2 && y < HEIGHT && x1 <= x2; y++) {
+    memcpy(&self->framebuffer_[(size_t) y * WIDTH + x1], pixels + (y - area->y1) * w + (x1 - area->x1),
+           (x2 - x1 + 1) * sizeof(uint16_t));
+  }
+  lv_disp_flush_ready(drv);
+}
+
+void Display::rounder_cb_(lv_disp_drv_t *drv, lv_area_t *area) {
+  // Zelfde uitlijning als rounder_cb op het device
+  uint16_t tile_lines = static_cast<Display *>(drv->user_data)->tile_lines_;
+  area->x1 = area->x1 / TILE_WIDTH * TILE_WIDTH;
+  area->x2 = area->x2 / TILE_WIDTH * TILE_WIDTH + TILE_WIDTH - 1;
+  area->y1 = area->y1 / tile_lines * tile_lines;
+  area->y2 = area->y2 / tile_lines * tile_lines + tile_lines - 1;
+}
+
+void Display::monitor_cb_(lv_disp_drv_t *drv, uint32_t time, uint32_t px) {
+  Display *self = static_cast<Display *>(drv->user_data);
+  self->stats_.frames++;
+  self->stats_.rendered_px += px;
+}
+
+void Display::refr_timer_cb_(lv_timer_t *timer) {
+  lv_disp_t *disp = (lv_disp_t *) timer->user_data;
+  Display *self = static_cast<Display *>(disp->driver->user_data);
+  uint32_t frames = self->stats_.frames;
+
+  auto start = std::chrono::steady_clock::now();
+  esphome::hd_device::coalesce_dirty_areas(disp);
+  _lv_disp_refr_timer(timer);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  // Alleen refreshes die echt getekend hebben tellen als frame
+  if (self->stats_.frames != frames) {
+    double ms = std::chrono::duration<double, std::milli>(elapsed).count();
+    self->stats_.frame_ms_total += ms;
+    self->stats_.frame_ms_max = std::max(self->stats_.frame_ms_max, ms);
+  }
+}
+
+void Display::read_cb_(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+  Display *self = static_cast<Display *>(drv->user_data);
+  data->point = self->touch_;
+  data->state = self->pressed_ ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+}
+
+}  // namespace sim
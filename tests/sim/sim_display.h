@@ -0,0 +1,99 @@
+#pragma once
+
+// Headless display en touch voor LVGL op de host, in plaats van flush_pixels en touchpad_read.
+// De display staat ingesteld zoals HaDeckDevice: dezelfde resolutie, draw buffer, rounder op het
+// tegelraster, samenvoegen van dirty areas en TileHashes in de flush. Geflushte pixels komen in
+// een framebuffer in het geheugen; per frame worden de tijd en de pixels bijgehouden.
+
+#include "lvgl.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace sim {
+
+struct FrameStats {
+  // Refreshes waarin iets getekend is
+  uint32_t frames = 0;
+  // Door LVGL gerenderde pixels (de invalidated gebieden na de rounder)
+  uint64_t rendered_px = 0;
+  // Pixels die na TileHashes naar het paneel zouden gaan
+  uint64_t flushed_px = 0;
+  // Wandkloktijd van de refreshes met een frame, in ms
+  double frame_ms_total = 0;
+  double frame_ms_max = 0;
+
+  double frame_ms_avg() const { return frames > 0 ? frame_ms_total / frames : 0; }
+};
+
+class Display {
+ public:
+  static const lv_coord_t WIDTH = 480;
+  static const lv_coord_t HEIGHT = 320;
+
+  // Eén display per proces: initialiseert LVGL bij de eerste aanroep. buffer_lines zoals de
+  // buffer_lines optie van hd_device_sc01_plus (standaard 10).
+  static Display &instance(uint16_t buffer_lines = 10);
+
+  // Laat ms verstrijken in stappen van step_ms op de host klok; na elke stap lopen de LVGL timers
+  // en daarna loop (de rest van de ESPHome main loop)
+  void run(uint32_t ms, const std::function<void()> &loop = nullptr, uint32_t step_ms = 5);
+
+  // Touch invoer, gelezen door LVGL bij de volgende indev read (elke LV_INDEV_DEF_READ_PERIOD)
+  void press(lv_coord_t x, lv_coord_t y);
+  void release();
+  // Drukken en loslaten op één plek, of slepen van (x1, y1) naar (x2, y2) in steps stappen
+  void tap(lv_coord_t x, lv_coord_t y, const std::function<void()> &loop = nullptr);
+  void drag(lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2, uint16_t steps,
+            const std::function<void()> &loop = nullptr);
+  // Midden van obj in schermcoördinaten, voor tap()
+  static lv_point_t center_of(lv_obj_t *obj);
+
+  // Statistieken sinds de vorige take_stats()
+  FrameStats take_stats();
+  // Hoogste LVGL heap gebruik, gemeten na elke stap van run()
+  uint32_t heap_peak() const { return heap_peak_; }
+  void reset_heap_peak();
+  static lv_mem_monitor_t heap();
+
+  // Hoogte van het tegelraster waarop de rounder invalidated gebieden uitlijnt
+  uint16_t tile_lines() const { return tile_lines_; }
+
+  // Inhoud van het paneel, RGB565 zoals LVGL hem aanlevert (LV_COLOR_16_SWAP)
+  const std::vector<uint16_t> &framebuffer() const { return framebuffer_; }
+  uint32_t framebuffer_hash() const;
+
+  // Aantal LVGL objecten op het actieve scherm en de top layer
+  static size_t count_objects();
+  // Markeert alle bestaande objecten; count_new_objects() telt daarna alleen nieuwe
+  static void mark_objects();
+  static size_t count_new_objects();
+
+ protected:
+  explicit Display(uint16_t buffer_lines);
+  void sample_heap_();
+
+  static void flush_cb_(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p);
+  static void rounder_cb_(lv_disp_drv_t *drv, lv_area_t *area);
+  static void monitor_cb_(lv_disp_drv_t *drv, uint32_t time, uint32_t px);
+  static void refr_timer_cb_(lv_timer_t *timer);
+  static void read_cb_(lv_indev_drv_t *drv, lv_indev_data_t *data);
+
+  std::vector<lv_color_t> buffer_;
+  std::vector<uint16_t> framebuffer_;
+  uint16_t tile_lines_ = 1;
+  lv_disp_draw_buf_t draw_buf_;
+  lv_disp_drv_t disp_drv_;
+  lv_indev_drv_t indev_drv_;
+  lv_disp_t *disp_ = nullptr;
+
+  lv_point_t touch_{0, 0};
+  bool pressed_ = false;
+
+  FrameStats stats_;
+  uint32_t heap_peak_ = 0;
+};
+
+}  // namespace sim
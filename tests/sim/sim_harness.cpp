@@ -0,0 +1,147 @@
+#include "sim_harness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <regex>
+#include <thread>
+
+namespace sim {
+
+static std::string url_decode(const std::string &value) {
+  std::string out;
+  out.reserve(value.size());
+  for (size_t i = 0; i < value.size(); i++) {
+    if (value[i] == '%' && i + 2 < value.size()) {
+      out += (char) strtol(value.substr(i + 1, 2).c_str(), nullptr, 16);
+      i += 2;
+    } else {
+      out += value[i];
+    }
+  }
+  return out;
+}
+
+Harness &Harness::instance() {
+  static Harness *harness = new Harness();
+  return *harness;
+}
+
+Harness::Harness() : display_(Display::instance()) {
+  // Due datums met Z worden naar lokale tijd omgezet; in UTC ziet elke host hetzelfde
+  setenv("TZ", "UTC", 1);
+  tzset();
+  host::set_virtual_clock(true);
+  clock_.set_fixed(NOW);
+}
+
+std::vector<host::SyncItem> Harness::make_tasks(size_t count, const std::string &due) {
+  std::vector<host::SyncItem> tasks(count);
+  for (size_t i = 0; i < count; i++) {
+    tasks[i].id = host::task_id(i);
+    tasks[i].content = "Taak " + std::to_string(i);
+    tasks[i].due = due;
+    tasks[i].priority = 1 + i % 4;
+  }
+  return tasks;
+}
+
+void Harness::set_server_tasks(const std::vector<host::SyncItem> &tasks) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  server_tasks_ = tasks;
+}
+
+std::vector<host::SyncItem> Harness::server_tasks() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return server_tasks_;
+}
+
+std::vector<std::string> Harness::closed_tasks() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return closed_;
+}
+
+host::FakeResponse Harness::handle_(const host::FakeRequest &request) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string body = url_decode(request.body);
+  if (body.compare(0, 9, "commands=") != 0) {
+    // Elke sync is een full sync van de huidige lijst, zoals na een onbekend sync token
+    return host::FakeResponse::json(host::sync_json(server_tasks_, true, "sim-" + std::to_string(++syncs_)));
+  }
+
+  // [{"type":"item_close","uuid":"...","args":{"id":"..."}}, ...] zoals close_tasks_blocking_
+  static const std::regex command("\"uuid\":\"([^\"]+)\",\"args\":\\{\"id\":\"([^\"]+)\"\\}");
+  std::string status;
+  for (auto it = std::sregex_iterator(body.begin(), body.end(), command); it != std::sregex_iterator(); ++it) {
+    std::string id = (*it)[2];
+    closed_.push_back(id);
+    server_tasks_.erase(std::remove_if(server_tasks_.begin(), server_tasks_.end(),
+                                       [&id](const host::SyncItem &item) { return item.id == id; }),
+                        server_tasks_.end());
+    status += (status.empty() ? "\"" : ", \"") + (*it)[1].str() + "\": \"ok\"";
+  }
+  return host::FakeResponse::json("{\"sync_status\": {" + status + "}, \"sync_token\": \"sim-" +
+                                  std::to_string(++syncs_) + "\", \"temp_id_mapping\": {}}");
+}
+
+TestComponent &Harness::boot(const std::vector<host::SyncItem> &tasks) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    server_tasks_ = tasks;
+    closed_.clear();
+  }
+  host::FakeServer::instance().reset();
+  host::FakeServer::instance().set_handler([this](const host::FakeRequest &request) { return handle_(request); });
+
+  // setup() ruimt het scherm zelf op, de top layer niet
+  lv_obj_clean(lv_layer_top());
+
+  component_ = new TestComponent();
+  component_->set_api_key("sim-token");
+  component_->set_snapshot(false);
+  // handle_() spreekt alleen de Sync API
+  component_->set_incremental_sync(true);
+  component_->set_time(&clock_);
+  component_->setup();
+  wait_for_fetch_();
+  run(200);
+  return *component_;
+}
+
+bool Harness::refresh() {
+  component_->fetch_tasks_();
+  bool done = wait_for_fetch_();
+  // Een paar refresh periodes, zodat alles wat de fetch veranderde ook getekend is
+  run(200);
+  return done;
+}
+
+bool Harness::wait_for_fetch_() {
+  // De request loopt op de netwerktaak in echte tijd; de main loop draait ondertussen door
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (component_->fetch_in_flight_) {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    run(5);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+void Harness::run(uint32_t ms) {
+  display_.run(ms, [this] { component_->loop(); });
+}
+
+void Harness::tap(lv_obj_t *obj) {
+  lv_point_t point = Display::center_of(obj);
+  display_.tap(point.x, point.y, [this] { component_->loop(); });
+}
+
+void Harness::swipe(lv_coord_t dy) {
+  lv_coord_t y1 = dy < 0 ? Display::HEIGHT - 40 : 40;
+  display_.drag(Display::WIDTH / 2, y1, Display::WIDTH / 2, y1 + dy, 10, [this] { component_->loop(); });
+  // Uitlopen van het scrollen na het loslaten
+  run(1000);
+}
+
+}  // namespace sim
@@ -0,0 +1,83 @@
+#pragma once
+
+// TodoistComponent in de simulator: de headless display, een vaste klok en de FakeServer als
+// Todoist. De server geeft bij elke sync de volledige lijst van server_tasks() terug en bevestigt
+// item_close commands door de taak uit die lijst te halen.
+
+#include "sim_display.h"
+#include "todoist_component.h"
+#include "host_http.h"
+#include "payloads.h"
+
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+// Geeft tests en benchmarks toegang tot de rijen en de store
+class TestComponent : public esphome::todoist::TodoistComponent {
+ public:
+  using TodoistComponent::fetch_in_flight_;
+  using TodoistComponent::free_rows_;
+  using TodoistComponent::OVERSCAN_ROWS;
+  using TodoistComponent::render_tasks_;
+  using TodoistComponent::TASK_ROW_HEIGHT;
+  using TodoistComponent::rows_;
+  using TodoistComponent::rows_created_;
+  using TodoistComponent::task_list_;
+  using TodoistComponent::tasks_changed_;
+  using TodoistComponent::tasks_;
+};
+
+// Vaste klok voor de component: maandag 11 maart 2024, 09:00 UTC
+static const time_t NOW = 1710147600;
+static const char *const TODAY = "2024-03-11";
+static const char *const YESTERDAY = "2024-03-10";
+
+class Harness {
+ public:
+  // Eén per proces, net als de display en de FakeServer. Zet de host klok op virtueel: de tijd
+  // loopt alleen via Display::run().
+  static Harness &instance();
+
+  // count taken met id host::task_id(i) en de gegeven datum
+  static std::vector<host::SyncItem> make_tasks(size_t count, const std::string &due = TODAY);
+
+  void set_server_tasks(const std::vector<host::SyncItem> &tasks);
+  std::vector<host::SyncItem> server_tasks();
+  // Task ids waarvoor de server een item_close kreeg
+  std::vector<std::string> closed_tasks();
+
+  // Nieuwe component met deze taken op de server: setup(), de eerste sync en de frames erna.
+  // Een vorige component blijft bestaan (zijn netwerktaak stopt niet), alleen zijn scherm is weg.
+  TestComponent &boot(const std::vector<host::SyncItem> &tasks);
+  // Een fetch zoals de poll scheduler hem start; true als hij binnen 5 s (echte tijd) klaar is
+  bool refresh();
+
+  // Laat ms verstrijken met de main loop van de component erbij
+  void run(uint32_t ms);
+  void tap(lv_obj_t *obj);
+  // Veegt over de lijst: dy < 0 scrolt naar beneden
+  void swipe(lv_coord_t dy);
+
+  TestComponent &component() { return *component_; }
+  Display &display() { return display_; }
+
+ protected:
+  Harness();
+  host::FakeResponse handle_(const host::FakeRequest &request);
+  bool wait_for_fetch_();
+
+  Display &display_;
+  esphome::time::RealTimeClock clock_;
+  TestComponent *component_ = nullptr;
+
+  std::mutex mutex_;
+  std::vector<host::SyncItem> server_tasks_;
+  std::vector<std::string> closed_;
+  uint32_t syncs_ = 0;
+};
+
+}  // namespace sim
@@ -0,0 +1,4 @@
+#include "sim_tick.h"
+#include <Arduino.h>
+
+extern "C" uint32_t sim_tick_ms(void) { return millis(); }
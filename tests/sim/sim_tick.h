@@ -0,0 +1,15 @@
+#pragma once
+
+// Tick voor LVGL in de simulator; LVGL zelf is C, de host klok zit achter millis()
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t sim_tick_ms(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,91 @@
+// Reconciliatie van de takenlijst: een verversing raakt alleen de rijen die echt veranderen
+#include "sim_harness.h"
+
+#include <gtest/gtest.h>
+
+namespace sim {
+
+class ReconcileTest : public ::testing::Test {
+ protected:
+  // Verversen met de huidige lijst op de server; telt wat er daarna nieuw of getekend is
+  FrameStats refresh() {
+    sim_.run(500);
+    Display::mark_objects();
+    sim_.display().take_stats();
+    EXPECT_TRUE(sim_.refresh());
+    return sim_.display().take_stats();
+  }
+
+  // Eén taakrij, plus wat de rounder er boven en onder bij kan nemen
+  uint64_t one_row_px() {
+    return (uint64_t) Display::WIDTH * (TestComponent::TASK_ROW_HEIGHT + 2 * sim_.display().tile_lines());
+  }
+
+  Harness &sim_ = Harness::instance();
+};
+
+TEST_F(ReconcileTest, UnchangedRefreshCreatesAndDrawsNothing) {
+  TestComponent &component = sim_.boot(Harness::make_tasks(20));
+  uint32_t created = component.rows_created_;
+
+  FrameStats stats = refresh();
+  EXPECT_EQ(Display::count_new_objects(), 0u);
+  EXPECT_EQ(component.rows_created_, created);
+  EXPECT_EQ(stats.frames, 0u);
+  EXPECT_EQ(stats.rendered_px, 0u);
+}
+
+TEST_F(ReconcileTest, ChangedTaskRedrawsOnlyItsRow) {
+  std::vector<host::SyncItem> tasks = Harness::make_tasks(20);
+  sim_.boot(tasks);
+
+  tasks[1].content = "Taak 1 aangepast";
+  sim_.set_server_tasks(tasks);
+  FrameStats stats = refresh();
+  EXPECT_EQ(Display::count_new_objects(), 0u);
+  EXPECT_GT(stats.rendered_px, 0u);
+  EXPECT_LE(stats.rendered_px, one_row_px());
+  EXPECT_LE(stats.flushed_px, stats.rendered_px);
+}
+
+TEST_F(ReconcileTest, NewPriorityOnlyRedrawsItsRow) {
+  std::vector<host::SyncItem> tasks = Harness::make_tasks(20);
+  sim_.boot(tasks);
+
+  tasks[3].priority = tasks[3].priority % 4 + 1;
+  sim_.set_server_tasks(tasks);
+  FrameStats stats = refresh();
+  EXPECT_EQ(Display::count_new_objects(), 0u);
+  EXPECT_GT(stats.rendered_px, 0u);
+  EXPECT_LE(stats.rendered_px, one_row_px());
+}
+
+TEST_F(ReconcileTest, RemovedTaskCreatesNoObjects) {
+  std::vector<host::SyncItem> tasks = Harness::make_tasks(20);
+  TestComponent &component = sim_.boot(tasks);
+  uint32_t created = component.rows_created_;
+
+  tasks.erase(tasks.begin() + 2);
+  sim_.set_server_tasks(tasks);
+  refresh();
+  EXPECT_EQ(component.tasks_.size(), 19u);
+  EXPECT_LT(component.tasks_.find(host::task_id(2).c_str()), 0);
+  EXPECT_EQ(Display::count_new_objects(), 0u);
+  EXPECT_EQ(component.rows_created_, created);
+}
+
+TEST_F(ReconcileTest, InsertedTaskReusesARowThatLeftTheScreen) {
+  std::vector<host::SyncItem> tasks = Harness::make_tasks(20);
+  TestComponent &component = sim_.boot(tasks);
+  uint32_t created = component.rows_created_;
+
+  tasks.insert(tasks.begin(), {"nieuw-1", "Nieuwe taak", TODAY, 2});
+  sim_.set_server_tasks(tasks);
+  refresh();
+  ASSERT_GE(component.tasks_.find("nieuw-1"), 0);
+  // De onderste rij schoof uit het venster en is opnieuw gebonden aan de nieuwe taak
+  EXPECT_EQ(Display::count_new_objects(), 0u);
+  EXPECT_EQ(component.rows_created_, created);
+}
+
+}  // namespace sim
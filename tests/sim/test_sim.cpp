@@ -0,0 +1,91 @@
+// Scenario's in de simulator: de lijst renderen, scrollen en een taak afvinken
+#include "sim_harness.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace sim {
+
+using esphome::todoist::TodoistComponent;
+
+class SimTest : public ::testing::Test {
+ protected:
+  size_t task_rows() {
+    const auto &rows = sim_.component().rows_;
+    return std::count_if(rows.begin(), rows.end(), [](const auto &row) { return row.kind == TodoistComponent::ROW_TASK; });
+  }
+
+  Harness &sim_ = Harness::instance();
+};
+
+TEST_F(SimTest, RendersOverdueAndTodayTasks) {
+  std::vector<host::SyncItem> tasks = Harness::make_tasks(3);
+  tasks.push_back({"overdue-1", "Te laat", YESTERDAY, 4});
+  sim_.display().take_stats();
+
+  TestComponent &component = sim_.boot(tasks);
+  EXPECT_EQ(component.tasks_.size(), 4u);
+  // Header over de tijd, één taak, header vandaag, drie taken
+  EXPECT_EQ(component.rows_.size(), 6u);
+  EXPECT_EQ(task_rows(), 4u);
+
+  FrameStats stats = sim_.display().take_stats();
+  EXPECT_GT(stats.frames, 0u);
+  EXPECT_GT(stats.rendered_px, 0u);
+  // Er staat meer op het paneel dan alleen de achtergrond
+  const std::vector<uint16_t> &pixels = sim_.display().framebuffer();
+  EXPECT_LT(std::count(pixels.begin(), pixels.end(), pixels[0]), (long) pixels.size());
+}
+
+TEST_F(SimTest, SameTasksGiveTheSameFrame) {
+  sim_.boot(Harness::make_tasks(8));
+  uint32_t first = sim_.display().framebuffer_hash();
+  sim_.boot(Harness::make_tasks(8));
+  EXPECT_EQ(sim_.display().framebuffer_hash(), first);
+
+  std::vector<host::SyncItem> tasks = Harness::make_tasks(8);
+  tasks[0].content = "Iets anders";
+  sim_.boot(tasks);
+  EXPECT_NE(sim_.display().framebuffer_hash(), first);
+}
+
+TEST_F(SimTest, ScrollingRecyclesRows) {
+  TestComponent &component = sim_.boot(Harness::make_tasks(100));
+  ASSERT_EQ(component.tasks_.size(), 100u);
+  uint32_t created = component.rows_created_;
+
+  for (int i = 0; i < 5; i++) {
+    sim_.swipe(-200);
+  }
+  EXPECT_GT(lv_obj_get_scroll_y(component.task_list_), 0);
+  // De rijen die in beeld kwamen komen uit de pool; alleen de overscan boven beeld is erbij
+  EXPECT_LE(component.rows_created_, created + TestComponent::OVERSCAN_ROWS + 1);
+  EXPECT_LT(component.rows_created_, 20u);
+  EXPECT_EQ(component.rows_.size() + component.free_rows_.size(), (size_t) component.rows_created_);
+}
+
+TEST_F(SimTest, CompleteButtonRemovesTheRowAndClosesTheTask) {
+  TestComponent &component = sim_.boot(Harness::make_tasks(5));
+  std::string id = host::task_id(2);
+  auto row = std::find_if(component.rows_.begin(), component.rows_.end(), [&id](const auto &row) { return row.id == id; });
+  ASSERT_NE(row, component.rows_.end());
+  ASSERT_NE(row->complete_btn, nullptr);
+
+  sim_.tap(row->complete_btn);
+  // Optimistisch: de rij is meteen weg, nog voor Todoist antwoordt
+  EXPECT_LT(component.tasks_.find(id.c_str()), 0);
+  EXPECT_EQ(task_rows(), 4u);
+
+  // De outbox stuurt het item_close command vanaf de netwerktaak
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (sim_.closed_tasks().empty() && std::chrono::steady_clock::now() < deadline) {
+    sim_.run(5);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(sim_.closed_tasks(), std::vector<std::string>{id});
+  EXPECT_EQ(sim_.server_tasks().size(), 4u);
+}
+
+}  // namespace sim
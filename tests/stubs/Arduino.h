@@ -0,0 +1,122 @@
+#pragma once
+
+// Host stand-in voor de delen van de Arduino-ESP32 core die de componenten gebruiken: tijd,
+// Stream/Client en String. Stream::readBytes wacht net als op het device tot de timeout.
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "esp_heap_caps.h"
+
+#define IRAM_ATTR
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void yield();
+uint32_t esp_random();
+
+namespace host {
+// Zet de klok van millis()/micros() vooruit, bijv. om backoff of een timeout te laten verlopen
+void advance_millis(uint32_t ms);
+// Virtuele klok: millis() staat stil tot advance_millis() of yield() (1 ms per aanroep), zodat
+// een scenario altijd dezelfde tijden ziet. Standaard loopt de klok met de echte tijd mee.
+void set_virtual_clock(bool virtual_clock);
+}  // namespace host
+
+class String {
+ public:
+  String() = default;
+  String(const char *s) : s_(s != nullptr ? s : "") {}
+  String(const std::string &s) : s_(s) {}
+
+  const char *c_str() const { return s_.c_str(); }
+  size_t length() const { return s_.size(); }
+  bool isEmpty() const { return s_.empty(); }
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+  bool equalsIgnoreCase(const String &other) const {
+    if (s_.size() != other.s_.size())
+      return false;
+    for (size_t i = 0; i < s_.size(); i++) {
+      if (tolower((uint8_t) s_[i]) != tolower((uint8_t) other.s_[i]))
+        return false;
+    }
+    return true;
+  }
+  bool operator==(const String &other) const { return s_ == other.s_; }
+
+ protected:
+  std::string s_;
+};
+
+class Print {
+ public:
+  virtual ~Print() = default;
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (n < size && write(buffer[n]) == 1)
+      n++;
+    return n;
+  }
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual void flush() {}
+
+  void setTimeout(unsigned long timeout) { timeout_ = timeout; }
+  unsigned long getTimeout() const { return timeout_; }
+
+  // Zoals de Arduino core: per teken wachten tot de timeout
+  size_t readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = timed_read_();
+      if (c < 0)
+        break;
+      buffer[count++] = (char) c;
+    }
+    return count;
+  }
+  size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *) buffer, length); }
+
+ protected:
+  int timed_read_() {
+    uint32_t start = millis();
+    do {
+      int c = read();
+      if (c >= 0)
+        return c;
+      yield();
+    } while (millis() - start < timeout_);
+    return -1;
+  }
+
+  unsigned long timeout_ = 1000;
+};
+
+class Client : public Stream {
+ public:
+  virtual int connect(const char *host, uint16_t port) = 0;
+  virtual uint8_t connected() = 0;
+  virtual void stop() = 0;
+  virtual int read(uint8_t *buffer, size_t size) = 0;
+  using Stream::read;
+};
+
+class IPAddress {
+ public:
+  IPAddress() = default;
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : addr_((uint32_t) a | b << 8 | c << 16 | (uint32_t) d << 24) {}
+  operator uint32_t() const { return addr_; }
+
+ protected:
+  uint32_t addr_ = 0;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+// Host stand-in voor de Arduino-ESP32 HTTPClient, voor zover TodoistApi hem gebruikt: begin met
+// een eigen client, verzamelde headers, GET/POST, getStream/getSize/getString en end met reuse.
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+typedef enum {
+  HTTP_CODE_OK = 200,
+  HTTP_CODE_NO_CONTENT = 204,
+  HTTP_CODE_NOT_MODIFIED = 304,
+  HTTP_CODE_BAD_REQUEST = 400,
+  HTTP_CODE_UNAUTHORIZED = 401,
+  HTTP_CODE_NOT_FOUND = 404,
+  HTTP_CODE_TOO_MANY_REQUESTS = 429,
+  HTTP_CODE_INTERNAL_SERVER_ERROR = 500,
+  HTTP_CODE_SERVICE_UNAVAILABLE = 503,
+} t_http_codes;
+
+class HTTPClient {
+ public:
+  bool begin(WiFiClientSecure &client, const char *url);
+  void end();
+  void setReuse(bool reuse) { reuse_ = reuse; }
+  void collectHeaders(const char *header_keys[], size_t count);
+  void addHeader(const String &name, const String &value);
+
+  int GET();
+  int POST(const String &payload);
+
+  String header(const char *name);
+  int getSize() { return size_; }
+  WiFiClientSecure &getStream() { return *client_; }
+  String getString();
+
+ protected:
+  int send_(const char *method, const std::string &payload);
+  // Leest statusregel en headers van de verbinding, zoals handleHeaderResponse
+  int read_head_();
+  bool read_line_(std::string &line);
+
+  WiFiClientSecure *client_ = nullptr;
+  std::string url_;
+  bool reuse_ = true;
+  bool can_reuse_ = false;
+  std::vector<std::string> collect_;
+  std::map<std::string, std::string> request_headers_;
+  std::map<std::string, std::string> response_headers_;
+  int size_ = -1;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Host stand-in: elke naam resolvet, tenzij een test DNS laat falen
+class WiFiClass {
+ public:
+  int hostByName(const char *host, IPAddress &result);
+  bool fail_dns = false;
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+#include "host_http.h"
+#include <string>
+
+// Verbinding met host::FakeServer. Wat de server stuurt staat in rx_ en komt er met read() in
+// stukken van hooguit FakeServer::read_slice() bytes uit.
+class WiFiClientSecure : public Client {
+ public:
+  void setInsecure() {}
+  void setCACert(const char *) {}
+
+  int connect(const char *host, uint16_t port) override;
+  uint8_t connected() override;
+  void stop() override;
+
+  int available() override;
+  int read() override;
+  int read(uint8_t *buffer, size_t size) override;
+  int peek() override;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buffer, size_t size) override;
+  void flush() override {}
+
+  // Gebruikt door HTTPClient: stuurt de request naar de server en zet de response klaar.
+  // false als de verbinding (aan de serverkant) al dicht was
+  bool exchange_(host::FakeRequest &request);
+
+  const std::string &host() const { return host_; }
+  uint16_t port() const { return port_; }
+
+ protected:
+  bool connected_ = false;
+  // Server sluit na de laatste byte in rx_
+  bool closing_ = false;
+  std::string host_;
+  uint16_t port_ = 0;
+  size_t connection_ = 0;
+  uint32_t generation_ = 0;
+  std::string rx_;
+  size_t rx_pos_ = 0;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+// Host stand-in: er is geen PSRAM, alles komt van de gewone heap
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+
+inline void *heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+inline void *heap_caps_realloc(void *ptr, size_t size, uint32_t) { return realloc(ptr, size); }
+inline void heap_caps_free(void *ptr) { free(ptr); }
+inline size_t heap_caps_get_free_size(uint32_t) { return 0; }
+inline size_t heap_caps_get_minimum_free_size(uint32_t) { return 0; }
+inline size_t heap_caps_get_largest_free_block(uint32_t) { return 0; }
+inline uint32_t esp_get_free_heap_size() { return 0; }
@@ -0,0 +1,47 @@
+#pragma once
+
+// Host stand-in: één data partitie in het geheugen, te vullen en te beschadigen via host::flash()
+
+#include "esp_err.h"
+#include "esp_spi_flash.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+typedef enum {
+  ESP_PARTITION_TYPE_APP = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef enum {
+  ESP_PARTITION_SUBTYPE_DATA_NVS = 0x02,
+  ESP_PARTITION_SUBTYPE_DATA_SPIFFS = 0x82,
+} esp_partition_subtype_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label);
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                             spi_flash_mmap_memory_t memory, const void **out_ptr,
+                             spi_flash_mmap_handle_t *out_handle);
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size);
+
+namespace host {
+struct FlashPartition {
+  // Leeg (size 0) betekent: de partitietabel heeft geen spiffs partitie
+  std::vector<uint8_t> data;
+  // Laat de volgende esp_partition_write na dit aantal geslaagde writes falen; -1 = nooit
+  int fail_after_writes = -1;
+  size_t erase_count = 0;
+  size_t write_count = 0;
+};
+FlashPartition &flash();
+}  // namespace host
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+namespace esphome {
+namespace sensor {
+
+// Onthoudt alle gepubliceerde waarden, zodat tests ze kunnen controleren
+class Sensor {
+ public:
+  void publish_state(float value) {
+    state = value;
+    has_state_ = true;
+    published.push_back(value);
+  }
+  bool has_state() const { return has_state_; }
+
+  float state = NAN;
+  std::vector<float> published;
+
+ protected:
+  bool has_state_ = false;
+};
+
+}  // namespace sensor
+}  // namespace esphome
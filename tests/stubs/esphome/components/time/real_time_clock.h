@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+namespace esphome {
+
+struct ESPTime {
+  uint8_t second;
+  uint8_t minute;
+  uint8_t hour;
+  uint8_t day_of_week;
+  uint8_t day_of_month;
+  uint16_t day_of_year;
+  uint8_t month;
+  uint16_t year;
+  bool is_dst;
+  time_t timestamp;
+
+  bool is_valid() const { return year >= 2019; }
+  static ESPTime from_epoch_local(time_t epoch);
+};
+
+namespace time {
+
+// Lokale tijd van de host, of een vaste tijd als een test die zet
+class RealTimeClock {
+ public:
+  ESPTime now() { return ESPTime::from_epoch_local(fixed_ != 0 ? fixed_ : ::time(nullptr)); }
+  void set_fixed(time_t epoch) { fixed_ = epoch; }
+
+ protected:
+  time_t fixed_ = 0;
+};
+
+}  // namespace time
+}  // namespace esphome
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+
+class Application {
+ public:
+  uint32_t get_loop_component_start_time() const;
+  void feed_wdt() {}
+};
+
+extern Application App;
+
+}  // namespace esphome
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace esphome {
+
+namespace setup_priority {
+const float BUS = 1000.0f;
+const float IO = 900.0f;
+const float HARDWARE = 800.0f;
+const float DATA = 600.0f;
+const float PROCESSOR = 400.0f;
+const float WIFI = 250.0f;
+const float AFTER_WIFI = 200.0f;
+const float AFTER_CONNECTION = 100.0f;
+const float LATE = -100.0f;
+}  // namespace setup_priority
+
+// Alleen wat de componenten zelf aanroepen; de host harness roept setup() en loop() aan
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual float get_setup_priority() const { return setup_priority::DATA; }
+
+  void mark_failed() { failed_ = true; }
+  bool is_failed() const { return failed_; }
+
+ protected:
+  bool failed_ = false;
+};
+
+}  // namespace esphome
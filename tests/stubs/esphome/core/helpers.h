@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace esphome {
+
+uint32_t fnv1_hash(const std::string &str);
+// Deterministisch op de host (vaste seed), zodat jitter in tests reproduceerbaar is
+uint32_t random_uint32();
+float random_float();
+
+}  // namespace esphome
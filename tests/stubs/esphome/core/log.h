@@ -0,0 +1,23 @@
+#pragma once
+
+// Host stand-in voor de ESPHome logger; het niveau komt uit de omgevingsvariabele HOST_LOG_LEVEL
+// (0 = niets, 1 = errors, 2 = warnings (standaard), 3 = info, 4 = config, 5 = debug)
+
+#define ESPHOME_LOG_LEVEL_ERROR 1
+#define ESPHOME_LOG_LEVEL_WARN 2
+#define ESPHOME_LOG_LEVEL_INFO 3
+#define ESPHOME_LOG_LEVEL_CONFIG 4
+#define ESPHOME_LOG_LEVEL_DEBUG 5
+#define ESPHOME_LOG_LEVEL_VERBOSE 6
+
+namespace esphome {
+void host_log(int level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+}  // namespace esphome
+
+#define ESP_LOGE(tag, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_CONFIG, tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_VERBOSE, tag, __VA_ARGS__)
+#define ESP_LOGVV(tag, ...) ::esphome::host_log(ESPHOME_LOG_LEVEL_VERBOSE, tag, __VA_ARGS__)
@@ -0,0 +1,45 @@
+#pragma once
+
+// Host stand-in voor de ESPHome preferences: een map in het geheugen in plaats van NVS. Tests
+// kunnen met host::preferences() een herstart nabootsen (de data blijft) of flash laten falen.
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace esphome {
+
+class ESPPreferenceObject {
+ public:
+  ESPPreferenceObject() = default;
+  explicit ESPPreferenceObject(uint32_t key) : key_(key), valid_(true) {}
+
+  template<typename T> bool save(const T *src) { return save_(reinterpret_cast<const uint8_t *>(src), sizeof(T)); }
+  template<typename T> bool load(T *dest) { return load_(reinterpret_cast<uint8_t *>(dest), sizeof(T)); }
+
+ protected:
+  bool save_(const uint8_t *data, size_t len);
+  bool load_(uint8_t *data, size_t len);
+
+  uint32_t key_ = 0;
+  bool valid_ = false;
+};
+
+class ESPPreferences {
+ public:
+  template<typename T> ESPPreferenceObject make_preference(uint32_t type, bool in_flash) {
+    (void) in_flash;
+    return ESPPreferenceObject(type);
+  }
+  template<typename T> ESPPreferenceObject make_preference(uint32_t type) { return ESPPreferenceObject(type); }
+  bool sync() { return !fail_writes; }
+
+  // Wat er "op flash" staat, per key
+  std::map<uint32_t, std::vector<uint8_t>> stored;
+  bool fail_writes = false;
+};
+
+extern ESPPreferences *global_preferences;
+
+}  // namespace esphome
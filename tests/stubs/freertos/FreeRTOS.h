@@ -0,0 +1,19 @@
+#pragma once
+
+// Host stand-in voor de paar FreeRTOS primitieven die de componenten gebruiken: een queue met een
+// mutex en condition variable en taken als std::thread. Een tick is hier één milliseconde.
+
+#include <cstddef>
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t) 0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t) (ms))
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+struct HostQueue;
+typedef HostQueue *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+struct HostTask;
+typedef HostTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+// De taak draait als losgekoppelde std::thread; stack grootte, prioriteit en core worden genegeerd
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stack_depth, void *param,
+                                   UBaseType_t priority, TaskHandle_t *created_task, BaseType_t core_id);
+void vTaskDelay(TickType_t ticks);
@@ -0,0 +1,254 @@
+// Host implementatie van de Arduino, ESP-IDF en ESPHome stand-ins
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_partition.h>
+#include <esp_rom_crc.h>
+#include "esphome/core/application.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/time/real_time_clock.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+
+// ---- tijd ----
+
+static const auto BOOT = std::chrono::steady_clock::now();
+static std::atomic<bool> virtual_clock{false};
+static std::atomic<uint64_t> virtual_us{0};
+static std::atomic<uint64_t> offset_us{0};
+
+static uint64_t now_us() {
+  if (virtual_clock)
+    return virtual_us.load();
+  auto elapsed = std::chrono::steady_clock::now() - BOOT;
+  return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() + offset_us.load();
+}
+
+uint32_t millis() { return (uint32_t) (now_us() / 1000); }
+uint32_t micros() { return (uint32_t) now_us(); }
+
+void delay(uint32_t ms) {
+  if (virtual_clock) {
+    virtual_us += (uint64_t) ms * 1000;
+    std::this_thread::yield();
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() {
+  if (virtual_clock) {
+    virtual_us += 1000;
+  }
+  std::this_thread::yield();
+}
+
+uint32_t esp_random() {
+  static std::mt19937 rng(12345);
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+  return rng();
+}
+
+namespace host {
+
+void advance_millis(uint32_t ms) {
+  if (virtual_clock) {
+    virtual_us += (uint64_t) ms * 1000;
+  } else {
+    offset_us += (uint64_t) ms * 1000;
+  }
+}
+
+void set_virtual_clock(bool enabled) {
+  virtual_us = now_us();
+  virtual_clock = enabled;
+}
+
+}  // namespace host
+
+// ---- ESP-IDF ----
+
+const char *esp_err_to_name(esp_err_t code) {
+  switch (code) {
+    case ESP_OK:
+      return "ESP_OK";
+    case ESP_ERR_NO_MEM:
+      return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+      return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_SIZE:
+      return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:
+      return "ESP_ERR_NOT_FOUND";
+    default:
+      return "ESP_FAIL";
+  }
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+  crc = ~crc;
+  for (uint32_t i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
+
+namespace host {
+FlashPartition &flash() {
+  static FlashPartition partition;
+  return partition;
+}
+}  // namespace host
+
+static esp_partition_t spiffs_partition;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char *label) {
+  host::FlashPartition &flash = host::flash();
+  if (flash.data.empty() || type != ESP_PARTITION_TYPE_DATA || subtype != ESP_PARTITION_SUBTYPE_DATA_SPIFFS)
+    return nullptr;
+  spiffs_partition.type = type;
+  spiffs_partition.subtype = subtype;
+  spiffs_partition.address = 0x290000;
+  spiffs_partition.size = flash.data.size();
+  strncpy(spiffs_partition.label, label != nullptr ? label : "spiffs", sizeof(spiffs_partition.label) - 1);
+  return &spiffs_partition;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                             spi_flash_mmap_memory_t, const void **out_ptr, spi_flash_mmap_handle_t *out_handle) {
+  host::FlashPartition &flash = host::flash();
+  if (partition == nullptr || offset + size > flash.data.size())
+    return ESP_ERR_INVALID_ARG;
+  *out_ptr = flash.data.data() + offset;
+  *out_handle = 1;
+  return ESP_OK;
+}
+
+void spi_flash_munmap(spi_flash_mmap_handle_t) {}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size) {
+  host::FlashPartition &flash = host::flash();
+  if (partition == nullptr || offset % 4096 != 0 || size % 4096 != 0 || offset + size > flash.data.size())
+    return ESP_ERR_INVALID_ARG;
+  memset(flash.data.data() + offset, 0xFF, size);
+  flash.erase_count++;
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size) {
+  host::FlashPartition &flash = host::flash();
+  if (partition == nullptr || dst_offset + size > flash.data.size())
+    return ESP_ERR_INVALID_SIZE;
+  if (flash.fail_after_writes == 0)
+    return ESP_FAIL;
+  if (flash.fail_after_writes > 0)
+    flash.fail_after_writes--;
+  // NOR flash: schrijven kan alleen bits van 1 naar 0 zetten
+  const uint8_t *bytes = static_cast<const uint8_t *>(src);
+  for (size_t i = 0; i < size; i++)
+    flash.data[dst_offset + i] &= bytes[i];
+  flash.write_count++;
+  return ESP_OK;
+}
+
+// ---- WiFi ----
+
+WiFiClass WiFi;
+
+int WiFiClass::hostByName(const char *, IPAddress &result) {
+  if (fail_dns)
+    return 0;
+  result = IPAddress(127, 0, 0, 1);
+  return 1;
+}
+
+// ---- ESPHome ----
+
+namespace esphome {
+
+static int log_level() {
+  static int level = [] {
+    const char *env = getenv("HOST_LOG_LEVEL");
+    return env != nullptr ? atoi(env) : ESPHOME_LOG_LEVEL_WARN;
+  }();
+  return level;
+}
+
+void host_log(int level, const char *tag, const char *format, ...) {
+  if (level > log_level())
+    return;
+  static const char LETTERS[] = "?EWICDV";
+  char message[512];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(message, sizeof(message), format, args);
+  va_end(args);
+  fprintf(stderr, "[%c][%s] %s\n", LETTERS[level < 7 ? level : 0], tag, message);
+}
+
+uint32_t fnv1_hash(const std::string &str) {
+  uint32_t hash = 2166136261UL;
+  for (char c : str) {
+    hash *= 16777619UL;
+    hash ^= (uint8_t) c;
+  }
+  return hash;
+}
+
+uint32_t random_uint32() { return esp_random(); }
+float random_float() { return (float) (random_uint32() >> 8) / (float) (1 << 24); }
+
+bool ESPPreferenceObject::save_(const uint8_t *data, size_t len) {
+  if (!valid_ || global_preferences->fail_writes)
+    return false;
+  global_preferences->stored[key_].assign(data, data + len);
+  return true;
+}
+
+bool ESPPreferenceObject::load_(uint8_t *data, size_t len) {
+  if (!valid_)
+    return false;
+  auto it = global_preferences->stored.find(key_);
+  if (it == global_preferences->stored.end() || it->second.size() != len)
+    return false;
+  memcpy(data, it->second.data(), len);
+  return true;
+}
+
+static ESPPreferences host_preferences;
+ESPPreferences *global_preferences = &host_preferences;
+
+Application App;
+
+uint32_t Application::get_loop_component_start_time() const { return millis(); }
+
+ESPTime ESPTime::from_epoch_local(time_t epoch) {
+  struct tm c_tm;
+  localtime_r(&epoch, &c_tm);
+  ESPTime res{};
+  res.second = c_tm.tm_sec;
+  res.minute = c_tm.tm_min;
+  res.hour = c_tm.tm_hour;
+  res.day_of_week = c_tm.tm_wday + 1;
+  res.day_of_month = c_tm.tm_mday;
+  res.day_of_year = c_tm.tm_yday + 1;
+  res.month = c_tm.tm_mon + 1;
+  res.year = c_tm.tm_year + 1900;
+  res.is_dst = c_tm.tm_isdst > 0;
+  res.timestamp = epoch;
+  return res;
+}
+
+}  // namespace esphome
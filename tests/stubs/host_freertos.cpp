@@ -0,0 +1,78 @@
+// FreeRTOS queue en taken op std::thread
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <Arduino.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct HostQueue {
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<std::vector<uint8_t>> items;
+  size_t length;
+  size_t item_size;
+};
+
+struct HostTask {};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+  HostQueue *queue = new HostQueue();
+  queue->length = length;
+  queue->item_size = item_size;
+  return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) { delete queue; }
+
+template<typename Pred> static bool wait_for(HostQueue *queue, std::unique_lock<std::mutex> &lock, TickType_t ticks,
+                                             Pred pred) {
+  if (ticks == portMAX_DELAY) {
+    queue->changed.wait(lock, pred);
+    return true;
+  }
+  return queue->changed.wait_for(lock, std::chrono::milliseconds(ticks), pred);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait) {
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  if (!wait_for(queue, lock, ticks_to_wait, [queue] { return queue->items.size() < queue->length; }))
+    return pdFALSE;
+  const uint8_t *bytes = static_cast<const uint8_t *>(item);
+  queue->items.emplace_back(bytes, bytes + queue->item_size);
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait) {
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  if (!wait_for(queue, lock, ticks_to_wait, [queue] { return !queue->items.empty(); }))
+    return pdFALSE;
+  memcpy(item, queue->items.front().data(), queue->item_size);
+  queue->items.pop_front();
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  return queue->items.size();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *, uint32_t, void *param, UBaseType_t,
+                                   TaskHandle_t *created_task, BaseType_t) {
+  // Taken eindigen op het device nooit; de thread leeft tot het proces stopt
+  std::thread(function, param).detach();
+  static HostTask task;
+  if (created_task != nullptr)
+    *created_task = &task;
+  return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) { std::this_thread::sleep_for(std::chrono::milliseconds(ticks)); }
@@ -0,0 +1,323 @@
+// Nep HTTP transport: FakeServer, WiFiClientSecure en HTTPClient
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+#include "host_http.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace host {
+
+static std::string lower(std::string s) {
+  std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return (char) tolower(c); });
+  return s;
+}
+
+std::string FakeRequest::header(const std::string &name) const {
+  for (const auto &it : headers) {
+    if (lower(it.first) == lower(name))
+      return it.second;
+  }
+  return "";
+}
+
+FakeResponse FakeResponse::json(const std::string &body, int status) {
+  FakeResponse response;
+  response.status = status;
+  response.body = body;
+  response.headers["Content-Type"] = "application/json";
+  return response;
+}
+
+FakeServer &FakeServer::instance() {
+  // Bewust gelekt: netwerktaken van eerdere tests kunnen hem nog aanroepen bij het afsluiten
+  static FakeServer *server = new FakeServer();
+  return *server;
+}
+
+void FakeServer::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  handler_ = nullptr;
+  requests_.clear();
+  connections_ = 0;
+  read_slice_ = 4096;
+  generation_++;
+}
+
+void FakeServer::set_handler(Handler handler) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  handler_ = std::move(handler);
+}
+
+std::vector<FakeRequest> FakeServer::requests() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return requests_;
+}
+
+FakeResponse FakeServer::handle_(const FakeRequest &request) {
+  Handler handler;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.push_back(request);
+    handler = handler_;
+  }
+  if (!handler)
+    return FakeResponse::json("{}", 404);
+  return handler(request);
+}
+
+static const char *reason(int status) {
+  switch (status) {
+    case 200:
+      return "OK";
+    case 204:
+      return "No Content";
+    case 304:
+      return "Not Modified";
+    case 400:
+      return "Bad Request";
+    case 401:
+      return "Unauthorized";
+    case 403:
+      return "Forbidden";
+    case 404:
+      return "Not Found";
+    case 429:
+      return "Too Many Requests";
+    case 503:
+      return "Service Unavailable";
+    default:
+      return status >= 500 ? "Server Error" : "Unknown";
+  }
+}
+
+std::string serialize_response(const FakeResponse &response, bool head_only) {
+  bool has_body = !head_only && response.status != 204 && response.status != 304;
+  char line[64];
+  snprintf(line, sizeof(line), "HTTP/1.1 %d %s\r\n", response.status, reason(response.status));
+  std::string out = line;
+  for (const auto &it : response.headers)
+    out += it.first + ": " + it.second + "\r\n";
+  if (response.close)
+    out += "Connection: close\r\n";
+  if (response.chunked) {
+    out += "Transfer-Encoding: chunked\r\n";
+  } else if (response.status != 204 && response.status != 304) {
+    out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+  }
+  out += "\r\n";
+  size_t head = out.size();
+
+  if (has_body) {
+    if (response.chunked) {
+      size_t step = response.chunk_size > 0 ? response.chunk_size : response.body.size();
+      for (size_t pos = 0; pos < response.body.size(); pos += step) {
+        size_t n = std::min(step, response.body.size() - pos);
+        snprintf(line, sizeof(line), "%zx\r\n", n);
+        out += line;
+        out.append(response.body, pos, n);
+        out += "\r\n";
+      }
+      out += "0\r\n\r\n";
+    } else {
+      out += response.body;
+    }
+  }
+  if (response.truncate_after >= 0 && head + response.truncate_after < out.size())
+    out.resize(head + response.truncate_after);
+  return out;
+}
+
+}  // namespace host
+
+// ---- WiFiClientSecure ----
+
+int WiFiClientSecure::connect(const char *host, uint16_t port) {
+  stop();
+  host::FakeServer &server = host::FakeServer::instance();
+  host_ = host;
+  port_ = port;
+  connection_ = server.open_connection_();
+  generation_ = server.generation_;
+  connected_ = true;
+  closing_ = false;
+  return 1;
+}
+
+uint8_t WiFiClientSecure::connected() {
+  // Net als lwIP: data die al binnen is blijft leesbaar na een close van de server
+  if (connected_ && closing_ && rx_pos_ >= rx_.size())
+    connected_ = false;
+  return connected_ || rx_pos_ < rx_.size();
+}
+
+void WiFiClientSecure::stop() {
+  connected_ = false;
+  closing_ = false;
+  rx_.clear();
+  rx_pos_ = 0;
+}
+
+int WiFiClientSecure::available() { return (int) (rx_.size() - rx_pos_); }
+
+int WiFiClientSecure::read() {
+  if (rx_pos_ >= rx_.size())
+    return -1;
+  return (uint8_t) rx_[rx_pos_++];
+}
+
+int WiFiClientSecure::read(uint8_t *buffer, size_t size) {
+  size_t n = std::min({size, rx_.size() - rx_pos_, host::FakeServer::instance().read_slice()});
+  if (n == 0)
+    return connected() ? 0 : -1;
+  memcpy(buffer, rx_.data() + rx_pos_, n);
+  rx_pos_ += n;
+  return (int) n;
+}
+
+int WiFiClientSecure::peek() {
+  if (rx_pos_ >= rx_.size())
+    return -1;
+  return (uint8_t) rx_[rx_pos_];
+}
+
+size_t WiFiClientSecure::write(const uint8_t *, size_t size) { return connected_ ? size : 0; }
+
+bool WiFiClientSecure::exchange_(host::FakeRequest &request) {
+  host::FakeServer &server = host::FakeServer::instance();
+  if (!connected_ || closing_ || generation_ != server.generation_) {
+    // De server heeft de verbinding intussen gesloten: de request komt nooit aan
+    connected_ = false;
+    return false;
+  }
+  request.host = host_;
+  request.port = port_;
+  request.connection = connection_;
+  host::FakeResponse response = server.handle_(request);
+  if (response.delay_ms > 0)
+    delay(response.delay_ms);
+  if (response.drop) {
+    connected_ = false;
+    return false;
+  }
+  // Oude ongelezen bytes weg; net als echte TCP komt de nieuwe response erachter
+  rx_.erase(0, rx_pos_);
+  rx_pos_ = 0;
+  rx_ += host::serialize_response(response, request.method == "HEAD");
+  closing_ = response.close || response.truncate_after >= 0;
+  return true;
+}
+
+// ---- HTTPClient ----
+
+bool HTTPClient::begin(WiFiClientSecure &client, const char *url) {
+  client_ = &client;
+  url_ = url;
+  request_headers_.clear();
+  response_headers_.clear();
+  size_ = -1;
+  return true;
+}
+
+void HTTPClient::collectHeaders(const char *header_keys[], size_t count) {
+  collect_.clear();
+  for (size_t i = 0; i < count; i++)
+    collect_.push_back(host::lower(header_keys[i]));
+}
+
+void HTTPClient::addHeader(const String &name, const String &value) { request_headers_[name.c_str()] = value.c_str(); }
+
+int HTTPClient::GET() { return send_("GET", ""); }
+int HTTPClient::POST(const String &payload) { return send_("POST", payload.c_str()); }
+
+int HTTPClient::send_(const char *method, const std::string &payload) {
+  if (client_ == nullptr || !client_->connected())
+    return HTTPC_ERROR_NOT_CONNECTED;
+
+  host::FakeRequest request;
+  request.method = method;
+  // Alleen het pad; host en poort komen van de verbinding
+  std::string path = url_;
+  size_t scheme = path.find("://");
+  if (scheme != std::string::npos) {
+    size_t slash = path.find('/', scheme + 3);
+    path = slash == std::string::npos ? "/" : path.substr(slash);
+  }
+  request.url = path;
+  request.headers = request_headers_;
+  request.body = payload;
+  if (!client_->exchange_(request))
+    return HTTPC_ERROR_CONNECTION_LOST;
+  return read_head_();
+}
+
+bool HTTPClient::read_line_(std::string &line) {
+  line.clear();
+  while (true) {
+    int c = client_->read();
+    if (c < 0)
+      return false;
+    if (c == '\n')
+      break;
+    if (c != '\r')
+      line += (char) c;
+  }
+  return true;
+}
+
+int HTTPClient::read_head_() {
+  std::string line;
+  if (!read_line_(line) || line.compare(0, 5, "HTTP/") != 0)
+    return HTTPC_ERROR_NO_HTTP_SERVER;
+  int status = atoi(line.c_str() + line.find(' ') + 1);
+
+  bool chunked = false;
+  can_reuse_ = reuse_;
+  while (read_line_(line) && !line.empty()) {
+    size_t colon = line.find(':');
+    if (colon == std::string::npos)
+      continue;
+    std::string name = host::lower(line.substr(0, colon));
+    std::string value = line.substr(line.find_first_not_of(' ', colon + 1));
+    if (name == "content-length")
+      size_ = atoi(value.c_str());
+    if (name == "transfer-encoding" && host::lower(value) == "chunked")
+      chunked = true;
+    if (name == "connection" && host::lower(value) == "close")
+      can_reuse_ = false;
+    if (std::find(collect_.begin(), collect_.end(), name) != collect_.end())
+      response_headers_[name] = value;
+  }
+  if (chunked)
+    size_ = -1;
+  return status;
+}
+
+String HTTPClient::header(const char *name) {
+  auto it = response_headers_.find(host::lower(name));
+  return it != response_headers_.end() ? String(it->second) : String();
+}
+
+String HTTPClient::getString() {
+  std::string body;
+  if (size_ > 0) {
+    while ((int) body.size() < size_) {
+      int c = client_->read();
+      if (c < 0)
+        break;
+      body += (char) c;
+    }
+  }
+  return String(body);
+}
+
+void HTTPClient::end() {
+  if (client_ == nullptr)
+    return;
+  // Zoals disconnect(): wat er nog op de verbinding staat weggooien, dan open laten of sluiten
+  while (client_->available() > 0)
+    client_->read();
+  if (!reuse_ || !can_reuse_)
+    client_->stop();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+// Nep HTTP server voor de host: WiFiClientSecure en HTTPClient praten hiermee in plaats van met
+// het netwerk. Een test zet een handler die per request een FakeResponse teruggeeft; de response
+// wordt als echte HTTP/1.1 bytes op de verbinding gezet, dus BodyStream leest dezelfde framing
+// (Content-Length of chunked) als op het device.
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace host {
+
+struct FakeRequest {
+  std::string host;
+  uint16_t port = 0;
+  std::string method;
+  std::string url;
+  std::map<std::string, std::string> headers;
+  std::string body;
+  // Volgnummer van de verbinding waarover de request kwam (1 = de eerste)
+  size_t connection = 0;
+
+  // Leeg als de header ontbreekt
+  std::string header(const std::string &name) const;
+};
+
+struct FakeResponse {
+  int status = 200;
+  std::map<std::string, std::string> headers;
+  std::string body;
+  // Chunked transfer encoding met chunks van chunk_size bytes, anders Content-Length
+  bool chunked = false;
+  size_t chunk_size = 256;
+  // Server sluit de verbinding na deze response
+  bool close = false;
+  // Verbinding valt weg na zoveel body bytes (de rest komt nooit aan)
+  int truncate_after = -1;
+  // Geen response: de verbinding valt weg zodra de request verstuurd is
+  bool drop = false;
+  // Zo lang duurt het tot de eerste byte
+  uint32_t delay_ms = 0;
+
+  static FakeResponse json(const std::string &body, int status = 200);
+};
+
+class FakeServer {
+ public:
+  using Handler = std::function<FakeResponse(const FakeRequest &)>;
+
+  // Eén server per proces; een test zet hem met reset() terug
+  static FakeServer &instance();
+
+  void reset();
+  void set_handler(Handler handler);
+
+  // Alle requests tot nu toe
+  std::vector<FakeRequest> requests();
+  size_t connections() const { return connections_; }
+  // Zoveel bytes geeft de client per read() hooguit terug, zoals TLS records die binnendruppelen
+  void set_read_slice(size_t slice) { read_slice_ = slice; }
+  size_t read_slice() const { return read_slice_; }
+  // Sluit alle open verbindingen aan de serverkant, zoals een server met een idle timeout; de
+  // client merkt dat pas bij de volgende request
+  void close_idle_connections() { generation_++; }
+
+  // Gebruikt door WiFiClientSecure
+  size_t open_connection_() { return ++connections_; }
+  std::atomic<uint32_t> generation_{0};
+  FakeResponse handle_(const FakeRequest &request);
+
+ protected:
+  std::mutex mutex_;
+  Handler handler_;
+  std::vector<FakeRequest> requests_;
+  std::atomic<size_t> connections_{0};
+  size_t read_slice_ = 4096;
+};
+
+// HTTP/1.1 bytes van een response, afgekapt volgens truncate_after
+std::string serialize_response(const FakeResponse &response, bool head_only);
+
+}  // namespace host
@@ -0,0 +1,35 @@
+#pragma once
+
+// Alleen de LVGL 8.3 typen en area helpers die hd_dirty_regions gebruikt, zodat TileHashes en
+// coalesce_dirty_areas zonder de LVGL bronnen te testen zijn. Met LVGL_DIR wordt de echte
+// lvgl.h gebruikt.
+
+#include <cstdint>
+
+typedef int16_t lv_coord_t;
+
+typedef struct {
+  lv_coord_t x1;
+  lv_coord_t y1;
+  lv_coord_t x2;
+  lv_coord_t y2;
+} lv_area_t;
+
+#define LV_INV_BUF_SIZE 32
+
+typedef struct {
+  lv_area_t inv_areas[LV_INV_BUF_SIZE];
+  uint8_t inv_area_joined[LV_INV_BUF_SIZE];
+  uint16_t inv_p;
+} lv_disp_t;
+
+static inline uint32_t lv_area_get_size(const lv_area_t *area) {
+  return (uint32_t) (area->x2 - area->x1 + 1) * (uint32_t) (area->y2 - area->y1 + 1);
+}
+
+static inline void _lv_area_join(lv_area_t *res, const lv_area_t *a1, const lv_area_t *a2) {
+  res->x1 = a1->x1 < a2->x1 ? a1->x1 : a2->x1;
+  res->y1 = a1->y1 < a2->y1 ? a1->y1 : a2->y1;
+  res->x2 = a1->x2 > a2->x2 ? a1->x2 : a2->x2;
+  res->y2 = a1->y2 > a2->y2 ? a1->y2 : a2->y2;
+}
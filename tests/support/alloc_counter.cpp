@@ -0,0 +1,82 @@
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+}
+
+static std::atomic<size_t> current{0};
+static std::atomic<size_t> peak{0};
+static std::atomic<size_t> allocations{0};
+
+static void *track(void *ptr) {
+  if (ptr == nullptr)
+    return ptr;
+  size_t now = current += malloc_usable_size(ptr);
+  size_t old = peak.load();
+  while (now > old && !peak.compare_exchange_weak(old, now)) {
+  }
+  allocations++;
+  return ptr;
+}
+
+static void untrack(void *ptr) {
+  if (ptr != nullptr)
+    current -= malloc_usable_size(ptr);
+}
+
+extern "C" {
+
+void *malloc(size_t size) { return track(__libc_malloc(size)); }
+
+void *calloc(size_t count, size_t size) { return track(__libc_calloc(count, size)); }
+
+void *realloc(void *ptr, size_t size) {
+  untrack(ptr);
+  void *result = __libc_realloc(ptr, size);
+  if (result == nullptr && size > 0) {
+    // Origineel blijft bestaan
+    current += malloc_usable_size(ptr);
+    return nullptr;
+  }
+  return track(result);
+}
+
+void *memalign(size_t alignment, size_t size) { return track(__libc_memalign(alignment, size)); }
+
+void *aligned_alloc(size_t alignment, size_t size) { return track(__libc_memalign(alignment, size)); }
+
+int posix_memalign(void **out, size_t alignment, size_t size) {
+  void *ptr = track(__libc_memalign(alignment, size));
+  if (ptr == nullptr)
+    return ENOMEM;
+  *out = ptr;
+  return 0;
+}
+
+void free(void *ptr) {
+  untrack(ptr);
+  __libc_free(ptr);
+}
+
+}  // extern "C"
+
+namespace host {
+
+AllocStats alloc_stats() { return AllocStats{current.load(), peak.load(), allocations.load()}; }
+
+void reset_alloc_peak() {
+  peak = current.load();
+  allocations = 0;
+}
+
+}  // namespace host
@@ -0,0 +1,21 @@
+#pragma once
+
+// Telt heap gebruik van het hele proces door malloc en vrienden te vervangen (alleen glibc).
+// Alleen gelinkt in benchmarks: de piek tussen reset_peak() en peak() is wat een stuk code op de
+// heap nodig had, vergelijkbaar met heap_caps_get_minimum_free_size op het device.
+
+#include <cstddef>
+
+namespace host {
+
+struct AllocStats {
+  size_t current;
+  size_t peak;
+  size_t allocations;
+};
+
+AllocStats alloc_stats();
+// Zet de piek op het huidige gebruik en het aantal allocaties op 0
+void reset_alloc_peak();
+
+}  // namespace host
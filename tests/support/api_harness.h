@@ -0,0 +1,24 @@
+#pragma once
+
+// Hulpjes voor tests die TodoistApi tegen de FakeServer draaien
+
+#include <Arduino.h>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace host {
+
+// Roept loop() aan (zoals de ESPHome main loop) tot done() waar is; false na timeout_ms echte tijd
+template<typename Api> bool pump(Api &api, const std::function<bool()> &done, uint32_t timeout_ms = 5000) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline)
+      return false;
+    api.loop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+}  // namespace host
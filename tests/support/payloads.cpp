@@ -0,0 +1,155 @@
+#include "payloads.h"
+
+#include <cstdio>
+
+namespace host {
+
+std::string task_id(size_t index) { return std::to_string(7000000000ULL + index * 7919); }
+
+static std::string project_id(size_t index, const PayloadOptions &options) {
+  return std::to_string(2300000000ULL + (index % (options.projects > 0 ? options.projects : 1)) * 104729);
+}
+
+static std::string content(size_t index, const PayloadOptions &options) {
+  std::string out = "Taak " + std::to_string(index);
+  if (options.unicode)
+    out += " \xc3\xa9\xc3\xa8 \\u00fc \\\"quoted\\\" \xe2\x9c\x93 \xf0\x9f\x93\x85";
+  else
+    out += " boodschappen doen";
+  return out;
+}
+
+static std::string description(size_t index, const PayloadOptions &options) {
+  std::string out;
+  while (out.size() < options.description_length)
+    out += "Regel " + std::to_string(index) + " van de beschrijving. ";
+  out.resize(options.description_length);
+  return out;
+}
+
+// Datum index dagen na de startdatum; simpel ophogen is genoeg voor een paar jaar aan taken
+static void date(size_t index, const PayloadOptions &options, char *out, size_t len) {
+  static const int DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  int year = options.year, month = options.month, day = options.day + (int) (index % 400);
+  while (true) {
+    int days = DAYS[month - 1] + (month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0));
+    if (day <= days)
+      break;
+    day -= days;
+    if (++month > 12) {
+      month = 1;
+      year++;
+    }
+  }
+  snprintf(out, len, "%04d-%02d-%02d", year, month, day);
+}
+
+static std::string due(size_t index, const PayloadOptions &options, bool sync) {
+  char day[16];
+  date(index, options, day, sizeof(day));
+  bool with_time = options.datetime_every > 0 && index % options.datetime_every == 0;
+  char time[16];
+  snprintf(time, sizeof(time), "%02d:%02d:00", (int) (index % 24), (int) (index * 15 % 60));
+
+  std::string out = "{\"date\": \"";
+  out += day;
+  if (with_time && sync) {
+    // Sync API: tijd in date, met Z bij een vaste tijdzone
+    out += "T";
+    out += time;
+    out += "Z";
+  }
+  out += "\", \"is_recurring\": false, \"lang\": \"nl\", ";
+  if (with_time && !sync) {
+    out += "\"datetime\": \"";
+    out += day;
+    out += "T";
+    out += time;
+    out += ".000000Z\", \"timezone\": \"Europe/Amsterdam\", ";
+  } else if (!sync) {
+    out += "\"timezone\": null, ";
+  }
+  out += "\"string\": \"";
+  out += with_time ? "elke dag om 10:00" : day;
+  out += "\"}";
+  return out;
+}
+
+std::string rest_tasks_json(size_t count, const PayloadOptions &options) {
+  std::string out = "[";
+  for (size_t i = 0; i < count; i++) {
+    if (i > 0)
+      out += ", ";
+    std::string id = task_id(i);
+    out += "{\"creator_id\": \"2671355\", \"created_at\": \"2024-01-02T12:00:00.000000Z\", ";
+    out += "\"assignee_id\": null, \"assigner_id\": null, \"comment_count\": " + std::to_string(i % 4) + ", ";
+    out += "\"is_completed\": false, \"content\": \"" + content(i, options) + "\", ";
+    out += "\"description\": \"" + description(i, options) + "\", ";
+    out += "\"due\": " + due(i, options, false) + ", ";
+    out += "\"duration\": null, \"id\": \"" + id + "\", \"labels\": [\"thuis\", \"werk\"], ";
+    out += "\"order\": " + std::to_string(i + 1) + ", \"priority\": " + std::to_string(1 + i % 4) + ", ";
+    out += "\"project_id\": \"" + project_id(i, options) + "\", \"section_id\": null, \"parent_id\": null, ";
+    out += "\"url\": \"https://todoist.com/showTask?id=" + id + "\"}";
+  }
+  out += "]";
+  return out;
+}
+
+std::string sync_items_json(size_t count, bool full_sync, const std::string &sync_token, size_t completed,
+                            size_t deleted, const PayloadOptions &options) {
+  // Sleutels in dezelfde volgorde als de echte API: full_sync komt na items
+  std::string out = "{\"full_sync_date_utc\": \"2024-03-01T08:00:00Z\", \"items\": [";
+  for (size_t i = 0; i < count; i++) {
+    if (i > 0)
+      out += ", ";
+    bool is_checked = i < completed;
+    bool is_deleted = !is_checked && i < completed + deleted;
+    out += "{\"added_at\": \"2024-01-02T12:00:00.000000Z\", \"added_by_uid\": \"2671355\", ";
+    out += "\"checked\": " + std::string(is_checked ? "true" : "false") + ", \"child_order\": " + std::to_string(i) +
+           ", ";
+    out += "\"collapsed\": false, \"completed_at\": null, \"content\": \"" + content(i, options) + "\", ";
+    out += "\"description\": \"" + description(i, options) + "\", \"due\": " + due(i, options, true) + ", ";
+    out += "\"id\": \"" + task_id(i) + "\", \"is_deleted\": " + (is_deleted ? "true" : "false") + ", ";
+    out += "\"labels\": [], \"parent_id\": null, \"priority\": " + std::to_string(1 + i % 4) + ", ";
+    out += "\"project_id\": \"" + project_id(i, options) + "\", \"section_id\": null, \"user_id\": \"2671355\", ";
+    out += "\"v2_id\": \"6X7rM8997g3RQmvh\"}";
+  }
+  out += "], \"full_sync\": " + std::string(full_sync ? "true" : "false");
+  out += ", \"sync_token\": \"" + sync_token + "\", \"temp_id_mapping\": {}}";
+  return out;
+}
+
+static std::string escape(const std::string &text) {
+  std::string out;
+  for (char c : text) {
+    if (c == '"' || c == '\\')
+      out += '\\';
+    out += c;
+  }
+  return out;
+}
+
+std::string sync_json(const std::vector<SyncItem> &items, bool full_sync, const std::string &sync_token) {
+  std::string out = "{\"full_sync_date_utc\": \"2024-03-01T08:00:00Z\", \"items\": [";
+  for (size_t i = 0; i < items.size(); i++) {
+    const SyncItem &item = items[i];
+    if (i > 0)
+      out += ", ";
+    out += "{\"checked\": false, \"child_order\": " + std::to_string(i) + ", ";
+    out += "\"content\": \"" + escape(item.content) + "\", \"description\": \"" + escape(item.description) + "\", ";
+    if (item.due.empty()) {
+      out += "\"due\": null, ";
+    } else {
+      out += "\"due\": {\"date\": \"" + item.due + "\", \"is_recurring\": false, \"lang\": \"nl\", \"string\": \"" +
+             item.due + "\"}, ";
+    }
+    out += "\"id\": \"" + item.id + "\", \"is_deleted\": false, \"labels\": [], \"parent_id\": null, ";
+    out += "\"priority\": " + std::to_string(item.priority) + ", \"project_id\": \"" + item.project_id + "\", ";
+    out += "\"section_id\": null, \"user_id\": \"2671355\"}";
+  }
+  out += "], \"full_sync\": " + std::string(full_sync ? "true" : "false");
+  out += ", \"sync_token\": \"" + sync_token + "\", \"temp_id_mapping\": {}}";
+  return out;
+}
+
+}  // namespace host
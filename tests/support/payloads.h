@@ -0,0 +1,53 @@
+#pragma once
+
+// Genereert responses in het formaat van de Todoist REST v2 (/tasks) en Sync v9 (/sync) API,
+// met dezelfde velden als de echte responses, zodat parser tests en benchmarks ook de velden
+// doorlopen die het filter overslaat.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace host {
+
+struct PayloadOptions {
+  // Aantal verschillende projecten waarover de taken verdeeld worden
+  size_t projects = 5;
+  // Lengte van de beschrijving per taak (de parser bewaart alleen korte)
+  size_t description_length = 40;
+  // Niet-ASCII tekens en escapes in content
+  bool unicode = false;
+  // Om de zoveel taken een due tijd (REST: due.datetime in UTC)
+  size_t datetime_every = 3;
+  // Eerste dag van de due datums, als YYYY-MM-DD; de taken lopen er dag voor dag vanaf
+  int year = 2024;
+  int month = 3;
+  int day = 1;
+};
+
+// JSON array zoals GET /rest/v2/tasks
+std::string rest_tasks_json(size_t count, const PayloadOptions &options = PayloadOptions());
+
+// JSON object zoals POST /sync/v9/sync met resource_types=["items"]. De eerste completed items
+// hebben checked: true, de volgende deleted items is_deleted: true.
+std::string sync_items_json(size_t count, bool full_sync, const std::string &sync_token, size_t completed = 0,
+                            size_t deleted = 0, const PayloadOptions &options = PayloadOptions());
+
+// Eén item voor sync_json, voor tests die per taak bepalen wat er op het scherm moet komen
+struct SyncItem {
+  std::string id;
+  std::string content;
+  // YYYY-MM-DD, YYYY-MM-DDThh:mm:ssZ of leeg voor een taak zonder datum
+  std::string due;
+  int priority = 1;
+  std::string description;
+  std::string project_id = "2300000000";
+};
+
+// Zoals sync_items_json, met precies deze items
+std::string sync_json(const std::vector<SyncItem> &items, bool full_sync, const std::string &sync_token);
+
+// Task id zoals in de payloads hierboven
+std::string task_id(size_t index);
+
+}  // namespace host
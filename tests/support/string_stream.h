@@ -0,0 +1,27 @@
+#pragma once
+
+// Stream over een string in het geheugen, voor parser tests en benchmarks zonder transport.
+// Met een slice geeft available() hooguit zoveel bytes per keer, zoals een TLS verbinding.
+
+#include <Arduino.h>
+#include <string>
+
+namespace host {
+
+class StringStream : public Stream {
+ public:
+  explicit StringStream(std::string data) : data_(std::move(data)) { setTimeout(10); }
+
+  int available() override { return (int) (data_.size() - pos_); }
+  int read() override { return pos_ < data_.size() ? (uint8_t) data_[pos_++] : -1; }
+  int peek() override { return pos_ < data_.size() ? (uint8_t) data_[pos_] : -1; }
+  size_t write(uint8_t) override { return 0; }
+
+  size_t position() const { return pos_; }
+
+ protected:
+  std::string data_;
+  size_t pos_ = 0;
+};
+
+}  // namespace host
@@ -0,0 +1,155 @@
+// BodyStream: Content-Length en chunked framing op een keep-alive verbinding
+#include "todoist_body_stream.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace esphome {
+namespace todoist {
+
+// Verbinding met vaste inhoud die per read(buf, n) hooguit slice bytes teruggeeft
+class ScriptedClient : public Client {
+ public:
+  explicit ScriptedClient(std::string data, size_t slice = 4096) : data_(std::move(data)), slice_(slice) {
+    setTimeout(20);
+  }
+
+  int connect(const char *, uint16_t) override { return 1; }
+  uint8_t connected() override { return open_; }
+  void stop() override { open_ = false; }
+  int available() override { return (int) (data_.size() - pos_); }
+  int read() override { return pos_ < data_.size() ? (uint8_t) data_[pos_++] : -1; }
+  int read(uint8_t *buffer, size_t size) override {
+    size_t n = std::min({size, slice_, data_.size() - pos_});
+    memcpy(buffer, data_.data() + pos_, n);
+    pos_ += n;
+    return n > 0 ? (int) n : -1;
+  }
+  int peek() override { return pos_ < data_.size() ? (uint8_t) data_[pos_] : -1; }
+  size_t write(uint8_t) override { return 1; }
+
+  // Wat er na de body nog op de verbinding staat
+  std::string rest() const { return data_.substr(pos_); }
+
+ protected:
+  std::string data_;
+  size_t slice_;
+  size_t pos_ = 0;
+  bool open_ = true;
+};
+
+static std::string read_all(Stream &stream) {
+  std::string out;
+  int c;
+  while ((c = stream.read()) >= 0)
+    out += (char) c;
+  return out;
+}
+
+static std::string chunked(const std::string &body, size_t chunk_size, const std::string &trailers = "") {
+  std::string out;
+  for (size_t pos = 0; pos < body.size(); pos += chunk_size) {
+    size_t n = std::min(chunk_size, body.size() - pos);
+    char header[16];
+    snprintf(header, sizeof(header), "%zx\r\n", n);
+    out += header + body.substr(pos, n) + "\r\n";
+  }
+  return out + "0\r\n" + trailers + "\r\n";
+}
+
+class BodyStreamTest : public ::testing::Test {
+ protected:
+  uint8_t buffer_[64];
+};
+
+TEST_F(BodyStreamTest, StopsAtContentLength) {
+  ScriptedClient client("[1,2,3]HTTP/1.1 200 OK\r\n");
+  BodyStream body(client, 7, false, buffer_, sizeof(buffer_));
+  EXPECT_EQ(read_all(body), "[1,2,3]");
+  EXPECT_EQ(body.bytes_read(), 7u);
+  // De volgende response op de verbinding is niet aangeraakt
+  EXPECT_EQ(client.rest(), "HTTP/1.1 200 OK\r\n");
+}
+
+TEST_F(BodyStreamTest, DecodesChunks) {
+  std::string body = "{\"items\": [\"een\", \"twee\", \"drie\"]}";
+  ScriptedClient client(chunked(body, 5) + "NEXT");
+  BodyStream stream(client, -1, true, buffer_, sizeof(buffer_));
+  EXPECT_EQ(read_all(stream), body);
+  EXPECT_EQ(client.rest(), "NEXT");
+}
+
+TEST_F(BodyStreamTest, DecodesUppercaseHexExtensionsAndTrailers) {
+  std::string body(300, 'x');
+  std::string wire = "12C;name=value\r\n" + body + "\r\n0\r\nX-Trailer: 1\r\n\r\nNEXT";
+  ScriptedClient client(wire);
+  BodyStream stream(client, -1, true, buffer_, sizeof(buffer_));
+  EXPECT_EQ(read_all(stream), body);
+  EXPECT_EQ(client.rest(), "NEXT");
+}
+
+TEST_F(BodyStreamTest, HandlesDataArrivingInSmallPieces) {
+  std::string body;
+  for (int i = 0; i < 200; i++)
+    body += std::to_string(i) + ",";
+  ScriptedClient client(chunked(body, 37), 3);
+  BodyStream stream(client, -1, true, buffer_, sizeof(buffer_));
+  EXPECT_EQ(read_all(stream), body);
+  EXPECT_EQ(stream.bytes_read(), body.size());
+}
+
+TEST_F(BodyStreamTest, PeekDoesNotConsume) {
+  ScriptedClient client(chunked("ab", 1));
+  BodyStream stream(client, -1, true, buffer_, sizeof(buffer_));
+  EXPECT_EQ(stream.peek(), 'a');
+  EXPECT_EQ(stream.read(), 'a');
+  // Over de chunk grens heen
+  EXPECT_EQ(stream.peek(), 'b');
+  EXPECT_EQ(stream.read(), 'b');
+  EXPECT_EQ(stream.peek(), -1);
+}
+
+TEST_F(BodyStreamTest, ReadBytesStopsAtTheEnd) {
+  ScriptedClient client(chunked("0123456789", 4));
+  BodyStream stream(client, -1, true, buffer_, sizeof(buffer_));
+  char out[32];
+  EXPECT_EQ(stream.readBytes(out, sizeof(out)), 10u);
+  EXPECT_EQ(std::string(out, 10), "0123456789");
+}
+
+TEST_F(BodyStreamTest, DrainLeavesTheConnectionReusable) {
+  ScriptedClient client(chunked(std::string(500, 'y'), 100) + "NEXT");
+  BodyStream stream(client, -1, true, buffer_, sizeof(buffer_));
+  EXPECT_EQ(stream.read(), 'y');
+  EXPECT_TRUE(stream.drain(1024));
+  EXPECT_EQ(client.rest(), "NEXT");
+}
+
+TEST_F(BodyStreamTest, DrainGivesUpOnALargeRemainder) {
+  ScriptedClient client(std::string(5000, 'z'));
+  BodyStream stream(client, 5000, false, buffer_, sizeof(buffer_));
+  EXPECT_FALSE(stream.drain(1024));
+}
+
+TEST_F(BodyStreamTest, DrainFailsWithoutALength) {
+  ScriptedClient client("tot de verbinding sluit");
+  BodyStream stream(client, -1, false, buffer_, sizeof(buffer_));
+  EXPECT_FALSE(stream.drain(1024));
+}
+
+TEST_F(BodyStreamTest, ATruncatedChunkEndsTheBody) {
+  // Verbinding valt weg midden in een chunk
+  ScriptedClient client("10\r\n0123");
+  BodyStream stream(client, -1, true, buffer_, sizeof(buffer_));
+  EXPECT_EQ(read_all(stream), "0123");
+  EXPECT_FALSE(stream.drain(1024));
+}
+
+TEST_F(BodyStreamTest, AnInvalidChunkHeaderEndsTheBody) {
+  ScriptedClient client("zz\r\nabc");
+  BodyStream stream(client, -1, true, buffer_, sizeof(buffer_));
+  EXPECT_EQ(stream.read(), -1);
+}
+
+}  // namespace todoist
+}  // namespace esphome
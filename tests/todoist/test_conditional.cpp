@@ -0,0 +1,69 @@
+// Conditional GET: validators en 304 Not Modified
+#include "todoist_api.h"
+#include "host_http.h"
+#include "payloads.h"
+
+#include <gtest/gtest.h>
+
+namespace esphome {
+namespace todoist {
+
+class ConditionalTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::FakeServer::instance().reset();
+    api_.set_api_key("test-token");
+    // Antwoordt met 304 als de client de huidige ETag meestuurt
+    host::FakeServer::instance().set_handler([this](const host::FakeRequest &request) {
+      if (request.header("If-None-Match") == etag_)
+        return host::FakeResponse::json("", 304);
+      host::FakeResponse response = host::FakeResponse::json(body_);
+      response.headers["ETag"] = etag_;
+      response.truncate_after = truncate_after_;
+      return response;
+    });
+  }
+
+  // 1 = gewijzigd, 0 = niet gewijzigd, -1 = fout
+  int fetch() {
+    int result = -1;
+    api_.fetch_tasks([&](TaskStore &&, bool modified) { result = modified ? 1 : 0; });
+    return result;
+  }
+
+  std::string last_if_none_match() { return host::FakeServer::instance().requests().back().header("If-None-Match"); }
+
+  TodoistApi api_;
+  std::string etag_ = "\"v1\"";
+  std::string body_ = host::rest_tasks_json(3);
+  int truncate_after_ = -1;
+};
+
+TEST_F(ConditionalTest, ShortCircuitsOnNotModified) {
+  EXPECT_EQ(fetch(), 1);
+  EXPECT_EQ(last_if_none_match(), "");
+  EXPECT_EQ(fetch(), 0);
+  EXPECT_EQ(last_if_none_match(), "\"v1\"");
+  EXPECT_EQ(api_.get_not_modified_count(), 1u);
+  EXPECT_EQ(api_.get_full_fetch_count(), 1u);
+
+  etag_ = "\"v2\"";
+  EXPECT_EQ(fetch(), 1);
+  EXPECT_EQ(fetch(), 0);
+  EXPECT_EQ(last_if_none_match(), "\"v2\"");
+}
+
+TEST_F(ConditionalTest, DoesNotKeepValidatorsOfABodyThatFailedToParse) {
+  EXPECT_EQ(fetch(), 1);
+  etag_ = "\"v2\"";
+  truncate_after_ = (int) body_.size() / 2;
+  EXPECT_EQ(fetch(), -1);
+
+  // Nog steeds de validator van de laatste goede body; een 304 op v2 zou data overslaan die we nooit zagen
+  truncate_after_ = -1;
+  EXPECT_EQ(fetch(), 1);
+  EXPECT_EQ(last_if_none_match(), "\"v1\"");
+}
+
+}  // namespace todoist
+}  // namespace esphome
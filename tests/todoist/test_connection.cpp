@@ -0,0 +1,101 @@
+// Keep-alive verbinding en een instelbare basis URL
+#include "todoist_api.h"
+#include "host_http.h"
+#include "payloads.h"
+
+#include <gtest/gtest.h>
+
+namespace esphome {
+namespace todoist {
+
+class ConnectionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::FakeServer::instance().reset();
+    api_.set_api_key("test-token");
+    host::FakeServer::instance().set_handler(
+        [](const host::FakeRequest &) { return host::FakeResponse::json(host::rest_tasks_json(3)); });
+  }
+
+  // Zonder start() loopt alles synchroon
+  size_t fetch() {
+    size_t count = 0;
+    error_.clear();
+    api_.fetch_tasks([&](TaskStore &&tasks, bool) { count = tasks.size(); }, [&](std::string e) { error_ = e; });
+    return count;
+  }
+
+  TodoistApi api_;
+  std::string error_;
+};
+
+TEST_F(ConnectionTest, ReusesTheConnectionAcrossRequests) {
+  EXPECT_EQ(fetch(), 3u);
+  EXPECT_EQ(fetch(), 3u);
+  EXPECT_EQ(fetch(), 3u);
+  EXPECT_EQ(host::FakeServer::instance().connections(), 1u);
+  EXPECT_EQ(host::FakeServer::instance().requests().size(), 3u);
+}
+
+TEST_F(ConnectionTest, ReusesTheConnectionAfterAChunkedBody) {
+  host::FakeServer::instance().set_handler([](const host::FakeRequest &) {
+    host::FakeResponse response = host::FakeResponse::json(host::rest_tasks_json(30));
+    response.chunked = true;
+    response.chunk_size = 700;
+    return response;
+  });
+  host::FakeServer::instance().set_read_slice(100);
+  EXPECT_EQ(fetch(), 30u);
+  EXPECT_EQ(fetch(), 30u);
+  EXPECT_EQ(host::FakeServer::instance().connections(), 1u);
+}
+
+TEST_F(ConnectionTest, ReconnectsOnceWhenTheServerClosedTheConnection) {
+  EXPECT_EQ(fetch(), 3u);
+  host::FakeServer::instance().close_idle_connections();
+  EXPECT_EQ(fetch(), 3u) << error_;
+  EXPECT_EQ(host::FakeServer::instance().connections(), 2u);
+}
+
+TEST_F(ConnectionTest, OpensANewConnectionAfterConnectionClose) {
+  host::FakeServer::instance().set_handler([](const host::FakeRequest &) {
+    host::FakeResponse response = host::FakeResponse::json(host::rest_tasks_json(1));
+    response.close = true;
+    return response;
+  });
+  EXPECT_EQ(fetch(), 1u);
+  EXPECT_EQ(fetch(), 1u);
+  EXPECT_EQ(host::FakeServer::instance().connections(), 2u);
+}
+
+TEST_F(ConnectionTest, ConnectsToTheConfiguredHostAndPort) {
+  ASSERT_TRUE(api_.set_base_url("https://todoist.local:8443/api/"));
+  EXPECT_EQ(fetch(), 3u) << error_;
+  auto requests = host::FakeServer::instance().requests();
+  ASSERT_EQ(requests.size(), 1u);
+  EXPECT_EQ(requests[0].host, "todoist.local");
+  EXPECT_EQ(requests[0].port, 8443);
+  EXPECT_EQ(requests[0].url.rfind("/api/rest/v2/tasks?", 0), 0u) << requests[0].url;
+  EXPECT_EQ(requests[0].header("Authorization"), "Bearer test-token");
+}
+
+TEST_F(ConnectionTest, DefaultsToPort443) {
+  ASSERT_TRUE(api_.set_base_url("https://api.todoist.com"));
+  EXPECT_EQ(fetch(), 3u);
+  auto requests = host::FakeServer::instance().requests();
+  ASSERT_EQ(requests.size(), 1u);
+  EXPECT_EQ(requests[0].host, "api.todoist.com");
+  EXPECT_EQ(requests[0].port, 443);
+}
+
+TEST_F(ConnectionTest, RejectsUrlsThatAreNotHttps) {
+  EXPECT_FALSE(api_.set_base_url("http://api.todoist.com"));
+  EXPECT_FALSE(api_.set_base_url("https://"));
+  EXPECT_FALSE(api_.set_base_url("https://host:notaport"));
+  // De vorige URL blijft staan
+  EXPECT_EQ(fetch(), 3u);
+  EXPECT_EQ(host::FakeServer::instance().requests()[0].host, "api.todoist.com");
+}
+
+}  // namespace todoist
+}  // namespace esphome
@@ -0,0 +1,119 @@
+// Due datums: parse_due_date, classify_due en days_from_civil
+#include "todoist_task.h"
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+
+namespace esphome {
+namespace todoist {
+
+class DueDateTest : public ::testing::Test {
+ protected:
+  void SetUp() override { set_tz("UTC"); }
+  void TearDown() override { set_tz("UTC"); }
+
+  static void set_tz(const char *tz) {
+    setenv("TZ", tz, 1);
+    tzset();
+  }
+};
+
+TEST_F(DueDateTest, DaysFromCivilMatchesTimegm) {
+  for (int year : {1970, 1999, 2000, 2024, 2100}) {
+    for (int month = 1; month <= 12; month++) {
+      struct tm tm {};
+      tm.tm_year = year - 1900;
+      tm.tm_mon = month - 1;
+      tm.tm_mday = 28;
+      EXPECT_EQ(days_from_civil(year, month, 28), timegm(&tm) / 86400) << year << "-" << month;
+    }
+  }
+  EXPECT_EQ(days_from_civil(1970, 1, 1), 0);
+  EXPECT_EQ(days_from_civil(2024, 3, 1) - days_from_civil(2024, 2, 28), 2);  // Schrikkeljaar
+}
+
+TEST_F(DueDateTest, ParsesADateWithoutTime) {
+  DueDate due = parse_due_date("2024-03-01");
+  EXPECT_EQ(due_day(due), days_from_civil(2024, 3, 1));
+  EXPECT_EQ(due_minute(due), DUE_NO_TIME);
+  EXPECT_EQ(due_time_string(due), "");
+}
+
+TEST_F(DueDateTest, ParsesAFloatingTime) {
+  DueDate due = parse_due_date("2024-03-01T13:05:00");
+  EXPECT_EQ(due_day(due), days_from_civil(2024, 3, 1));
+  EXPECT_EQ(due_minute(due), 13 * 60 + 5);
+  EXPECT_EQ(due_time_string(due), "13:05");
+  // Zonder seconden
+  EXPECT_EQ(due_minute(parse_due_date("2024-03-01T07:30")), 7 * 60 + 30);
+}
+
+TEST_F(DueDateTest, ConvertsUtcTimesToLocalTime) {
+  set_tz("CET-1CEST,M3.5.0,M10.5.0/3");
+  DueDate due = parse_due_date("2024-03-01T13:00:00Z");
+  EXPECT_EQ(due_day(due), days_from_civil(2024, 3, 1));
+  EXPECT_EQ(due_minute(due), 14 * 60);
+
+  // REST datetime met fractie, zomertijd
+  due = parse_due_date("2024-07-01T13:00:00.000000Z");
+  EXPECT_EQ(due_minute(due), 15 * 60);
+
+  // Over middernacht naar de volgende dag
+  due = parse_due_date("2024-03-01T23:30Z");
+  EXPECT_EQ(due_day(due), days_from_civil(2024, 3, 2));
+  EXPECT_EQ(due_minute(due), 30);
+
+  // Een floating tijd blijft zoals hij is
+  EXPECT_EQ(due_minute(parse_due_date("2024-03-01T13:00:00")), 13 * 60);
+}
+
+TEST_F(DueDateTest, RejectsInvalidDates) {
+  EXPECT_EQ(parse_due_date(nullptr), DUE_NONE);
+  EXPECT_EQ(parse_due_date(""), DUE_NONE);
+  EXPECT_EQ(parse_due_date("2024-3-1"), DUE_NONE);
+  EXPECT_EQ(parse_due_date("2024-13-01"), DUE_NONE);
+  EXPECT_EQ(parse_due_date("1969-12-31"), DUE_NONE);
+  EXPECT_EQ(parse_due_date("morgen om 10"), DUE_NONE);
+  // Een ongeldige tijd valt terug op alleen de datum
+  EXPECT_EQ(due_minute(parse_due_date("2024-03-01T25:00")), DUE_NO_TIME);
+}
+
+TEST_F(DueDateTest, IgnoresATruncatedTime) {
+  // Precies zo groot als de tekst, zodat een leesactie voorbij de NUL buiten de buffer valt
+  for (const char *text : {"2024-03-01T", "2024-03-01T1", "2024-03-01T13", "2024-03-01T13:", "2024-03-01T13:0"}) {
+    std::unique_ptr<char[]> exact(new char[strlen(text) + 1]);
+    memcpy(exact.get(), text, strlen(text) + 1);
+    DueDate due = parse_due_date(exact.get());
+    EXPECT_EQ(due_day(due), days_from_civil(2024, 3, 1)) << text;
+    EXPECT_EQ(due_minute(due), DUE_NO_TIME) << text;
+  }
+}
+
+TEST_F(DueDateTest, ClassifiesAgainstTheCurrentDayAndMinute) {
+  int32_t today = days_from_civil(2024, 3, 10);
+  uint16_t noon = 12 * 60;
+  EXPECT_EQ(classify_due(DUE_NONE, today, noon), DUE_CLASS_NONE);
+  EXPECT_EQ(classify_due(parse_due_date("2024-03-09"), today, noon), DUE_CLASS_OVERDUE);
+  EXPECT_EQ(classify_due(parse_due_date("2024-03-10"), today, noon), DUE_CLASS_TODAY);
+  EXPECT_EQ(classify_due(parse_due_date("2024-03-11"), today, noon), DUE_CLASS_TOMORROW);
+  EXPECT_EQ(classify_due(parse_due_date("2024-03-12"), today, noon), DUE_CLASS_LATER);
+  // Over de jaargrens
+  EXPECT_EQ(classify_due(parse_due_date("2025-01-01"), days_from_civil(2024, 12, 31), noon), DUE_CLASS_TOMORROW);
+}
+
+TEST_F(DueDateTest, ATimedTaskIsOverdueFromItsMinute) {
+  int32_t today = days_from_civil(2024, 3, 10);
+  DueDate due = parse_due_date("2024-03-10T14:30");
+  EXPECT_EQ(classify_due(due, today, 14 * 60 + 29), DUE_CLASS_TODAY);
+  EXPECT_EQ(classify_due(due, today, 14 * 60 + 30), DUE_CLASS_OVERDUE);
+  // Zonder tijd pas de dag erna
+  DueDate all_day = parse_due_date("2024-03-10");
+  EXPECT_EQ(classify_due(all_day, today, 23 * 60 + 59), DUE_CLASS_TODAY);
+  EXPECT_EQ(classify_due(all_day, today + 1, 0), DUE_CLASS_OVERDUE);
+}
+
+}  // namespace todoist
+}  // namespace esphome
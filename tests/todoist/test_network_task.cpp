@@ -0,0 +1,121 @@
+// Requests lopen op de netwerktaak; callbacks komen via de ring terug op de main loop
+#include "todoist_api.h"
+#include "api_harness.h"
+#include "host_http.h"
+#include "payloads.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace esphome {
+namespace todoist {
+
+class NetworkTaskTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::FakeServer::instance().reset();
+    // De netwerktaak eindigt nooit, dus de api ook niet: bewust gelekt
+    api_ = new TodoistApi();
+    api_->set_api_key("test-token");
+  }
+
+  TodoistApi *api_ = nullptr;
+};
+
+TEST_F(NetworkTaskTest, FetchDoesNotBlockTheMainLoop) {
+  host::FakeServer::instance().set_handler([](const host::FakeRequest &) {
+    host::FakeResponse response = host::FakeResponse::json(host::rest_tasks_json(20));
+    response.delay_ms = 300;
+    return response;
+  });
+  ASSERT_TRUE(api_->start());
+
+  std::thread::id main_thread = std::this_thread::get_id();
+  std::thread::id callback_thread;
+  size_t fetched = 0;
+  bool done = false;
+
+  auto start = std::chrono::steady_clock::now();
+  api_->fetch_tasks([&](TaskStore &&tasks, bool modified) {
+    callback_thread = std::this_thread::get_id();
+    fetched = tasks.size();
+    EXPECT_TRUE(modified);
+    done = true;
+  });
+  api_->loop();
+  auto blocked = std::chrono::steady_clock::now() - start;
+
+  // De 300 ms van de server zitten op de netwerktaak, niet in fetch_tasks of loop
+  EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(blocked).count(), 100);
+  EXPECT_FALSE(done);
+
+  ASSERT_TRUE(host::pump(*api_, [&] { return done; }));
+  EXPECT_EQ(fetched, 20u);
+  EXPECT_EQ(callback_thread, main_thread);
+}
+
+TEST_F(NetworkTaskTest, ErrorsComeBackOnTheMainLoop) {
+  host::FakeServer::instance().set_handler(
+      [](const host::FakeRequest &) { return host::FakeResponse::json("{\"error\": \"Unauthorized\"}", 401); });
+  ASSERT_TRUE(api_->start());
+
+  std::thread::id main_thread = std::this_thread::get_id();
+  std::string error;
+  bool done = false;
+  api_->fetch_tasks([](TaskStore &&, bool) { FAIL() << "unexpected success"; },
+                    [&](std::string message) {
+                      EXPECT_EQ(std::this_thread::get_id(), main_thread);
+                      error = message;
+                      done = true;
+                    });
+  ASSERT_TRUE(host::pump(*api_, [&] { return done; }));
+  EXPECT_EQ(error.rfind("HTTP error code: 401", 0), 0u) << error;
+}
+
+TEST_F(NetworkTaskTest, ClampsAHugeRetryAfter) {
+  // 4294968 s * 1000 loopt over in uint32_t en zou een backoff van 704 ms geven
+  host::FakeServer::instance().set_handler([](const host::FakeRequest &) {
+    host::FakeResponse response = host::FakeResponse::json("{}", 429);
+    response.headers["Retry-After"] = "4294968";
+    return response;
+  });
+
+  bool failed = false;
+  api_->fetch_tasks([](TaskStore &&, bool) { FAIL() << "unexpected success"; },
+                    [&](std::string) { failed = true; });
+  ASSERT_TRUE(failed);
+  EXPECT_EQ(api_->get_retry_after(), 600u);
+}
+
+TEST_F(NetworkTaskTest, CoalescesAFetchWhileOneIsInFlight) {
+  host::FakeServer::instance().set_handler([](const host::FakeRequest &) {
+    host::FakeResponse response = host::FakeResponse::json(host::rest_tasks_json(2));
+    response.delay_ms = 100;
+    return response;
+  });
+  ASSERT_TRUE(api_->start());
+
+  int callbacks = 0;
+  for (int i = 0; i < 5; i++)
+    api_->fetch_tasks([&](TaskStore &&, bool) { callbacks++; });
+  ASSERT_TRUE(host::pump(*api_, [&] { return callbacks > 0; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  api_->loop();
+
+  EXPECT_EQ(callbacks, 1);
+  EXPECT_EQ(host::FakeServer::instance().requests().size(), 1u);
+}
+
+TEST_F(NetworkTaskTest, RunsSynchronouslyWithoutTheNetworkTask) {
+  host::FakeServer::instance().set_handler(
+      [](const host::FakeRequest &) { return host::FakeResponse::json(host::rest_tasks_json(3)); });
+
+  size_t fetched = 0;
+  api_->fetch_tasks([&](TaskStore &&tasks, bool) { fetched = tasks.size(); });
+  EXPECT_EQ(fetched, 3u);
+}
+
+}  // namespace todoist
+}  // namespace esphome
@@ -0,0 +1,106 @@
+// Outbox: persistente completions met een command uuid per entry
+#include "todoist_outbox.h"
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <set>
+#include <string>
+
+namespace esphome {
+namespace todoist {
+
+// Elke test begint met een lege "flash"
+class OutboxFixture : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    global_preferences->stored.clear();
+    global_preferences->fail_writes = false;
+    outbox_.load();
+  }
+
+  Outbox outbox_;
+};
+
+TEST_F(OutboxFixture, AddsEntriesWithAUniqueUuid) {
+  ASSERT_TRUE(outbox_.add("7000000001"));
+  ASSERT_TRUE(outbox_.add("7000000002"));
+  ASSERT_EQ(outbox_.size(), 2u);
+  EXPECT_STREQ(outbox_[0].task_id, "7000000001");
+
+  std::set<std::string> uuids;
+  for (size_t i = 0; i < outbox_.size(); i++) {
+    std::string uuid = outbox_[i].uuid;
+    ASSERT_EQ(uuid.size(), 36u);
+    EXPECT_EQ(uuid[8], '-');
+    EXPECT_EQ(uuid[14], '4');  // Versie 4
+    EXPECT_NE(std::string("89ab").find(uuid[19]), std::string::npos);
+    uuids.insert(uuid);
+  }
+  EXPECT_EQ(uuids.size(), 2u);
+}
+
+TEST_F(OutboxFixture, IgnoresADuplicateCompletion) {
+  ASSERT_TRUE(outbox_.add("7000000001"));
+  std::string uuid = outbox_[0].uuid;
+  ASSERT_TRUE(outbox_.add("7000000001"));
+  EXPECT_EQ(outbox_.size(), 1u);
+  EXPECT_EQ(outbox_[0].uuid, uuid);
+  EXPECT_TRUE(outbox_.contains_task("7000000001"));
+  EXPECT_FALSE(outbox_.contains_task("7000000002"));
+}
+
+TEST_F(OutboxFixture, RefusesWhenFullOrTheIdIsTooLong) {
+  for (size_t i = 0; i < Outbox::MAX_ENTRIES; i++)
+    ASSERT_TRUE(outbox_.add(std::to_string(7000000000ULL + i).c_str()));
+  EXPECT_FALSE(outbox_.add("7999999999"));
+  EXPECT_EQ(outbox_.size(), (size_t) Outbox::MAX_ENTRIES);
+
+  Outbox other;
+  other.load();
+  EXPECT_FALSE(other.add("123456789012345678901234567890"));
+}
+
+TEST_F(OutboxFixture, RemoveKeepsTheOrder) {
+  for (const char *id : {"1", "2", "3", "4"})
+    ASSERT_TRUE(outbox_.add(id));
+  outbox_.remove(outbox_[1].uuid);
+  ASSERT_EQ(outbox_.size(), 3u);
+  EXPECT_STREQ(outbox_[0].task_id, "1");
+  EXPECT_STREQ(outbox_[1].task_id, "3");
+  EXPECT_STREQ(outbox_[2].task_id, "4");
+  // Onbekende uuid: niets
+  outbox_.remove("00000000-0000-4000-8000-000000000000");
+  EXPECT_EQ(outbox_.size(), 3u);
+}
+
+TEST_F(OutboxFixture, SurvivesARestart) {
+  ASSERT_TRUE(outbox_.add("7000000001"));
+  ASSERT_TRUE(outbox_.add("7000000002"));
+  outbox_.remove(outbox_[0].uuid);
+  std::string uuid = outbox_[0].uuid;
+
+  Outbox restarted;
+  restarted.load();
+  ASSERT_EQ(restarted.size(), 1u);
+  EXPECT_STREQ(restarted[0].task_id, "7000000002");
+  // Zelfde uuid, zodat Todoist een herhaalde batch niet dubbel uitvoert
+  EXPECT_EQ(restarted[0].uuid, uuid);
+}
+
+TEST_F(OutboxFixture, IgnoresACorruptStoredCount) {
+  ASSERT_TRUE(outbox_.add("7000000001"));
+  for (auto &it : global_preferences->stored)
+    it.second[0] = 200;
+  Outbox restarted;
+  restarted.load();
+  EXPECT_TRUE(restarted.empty());
+}
+
+TEST_F(OutboxFixture, KeepsWorkingInMemoryWhenFlashFails) {
+  global_preferences->fail_writes = true;
+  EXPECT_TRUE(outbox_.add("7000000001"));
+  EXPECT_EQ(outbox_.size(), 1u);
+}
+
+}  // namespace todoist
+}  // namespace esphome
@@ -0,0 +1,132 @@
+// Outbox flush: batches, idempotente retries en backoff tegen de FakeServer
+#include "todoist_api.h"
+#include "api_harness.h"
+#include "host_http.h"
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <set>
+
+namespace esphome {
+namespace todoist {
+
+class FlushApi : public TodoistApi {
+ public:
+  using TodoistApi::flush_failures_;
+};
+
+class OutboxFlushTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::FakeServer::instance().reset();
+    global_preferences->stored.clear();
+    api_.set_api_key("test-token");
+    api_.set_on_tasks_closed([this] { closed_++; });
+    // Bevestigt elke uuid die in de commands staat; drop_ laat requests verdwijnen
+    host::FakeServer::instance().set_handler([this](const host::FakeRequest &request) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      host::FakeResponse response;
+      if (drop_ > 0) {
+        drop_--;
+        response.drop = true;
+        return response;
+      }
+      std::string status;
+      for (const std::string &uuid : uuids_) {
+        if (request.body.find(uuid) == std::string::npos)
+          continue;
+        seen_.insert(uuid);
+        status += (status.empty() ? "" : ", ") + ("\"" + uuid + "\": \"ok\"");
+      }
+      return host::FakeResponse::json("{\"sync_status\": {" + status + "}, \"sync_token\": \"t\"}");
+    });
+  }
+
+  void complete(const char *id) {
+    ASSERT_TRUE(api_.complete_task(id));
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < api_.outbox().size(); i++)
+      uuids_.insert(api_.outbox()[i].uuid);
+  }
+
+  // Zonder start() loopt de flush synchroon in loop()
+  void loop_after(uint32_t ms) {
+    host::advance_millis(ms);
+    api_.loop();
+  }
+
+  FlushApi api_;
+  std::mutex mutex_;
+  std::set<std::string> uuids_;
+  std::set<std::string> seen_;
+  int drop_ = 0;
+  int closed_ = 0;
+};
+
+TEST_F(OutboxFlushTest, BatchesCompletionsIntoOneRequest) {
+  complete("7000000001");
+  complete("7000000002");
+  complete("7000000003");
+  // Binnen de flush delay gebeurt er nog niets
+  api_.loop();
+  EXPECT_TRUE(host::FakeServer::instance().requests().empty());
+
+  loop_after(2500);
+  auto requests = host::FakeServer::instance().requests();
+  ASSERT_EQ(requests.size(), 1u);
+  EXPECT_EQ(requests[0].method, "POST");
+  EXPECT_EQ(requests[0].body.rfind("commands=", 0), 0u);
+  EXPECT_EQ(seen_.size(), 3u);
+  EXPECT_TRUE(api_.outbox().empty());
+  EXPECT_EQ(closed_, 1);
+}
+
+TEST_F(OutboxFlushTest, RetriesTheSameCommandsAfterADroppedRequest) {
+  complete("7000000001");
+  drop_ = 1;
+  loop_after(2500);
+  EXPECT_EQ(api_.outbox().size(), 1u);
+  EXPECT_EQ(api_.flush_failures_, 1u);
+
+  // Nog in de backoff
+  loop_after(1000);
+  EXPECT_EQ(host::FakeServer::instance().requests().size(), 1u);
+
+  loop_after(5000);
+  auto requests = host::FakeServer::instance().requests();
+  ASSERT_EQ(requests.size(), 2u);
+  // Zelfde uuid in beide pogingen
+  EXPECT_EQ(requests[0].body, requests[1].body);
+  EXPECT_TRUE(api_.outbox().empty());
+  EXPECT_EQ(closed_, 1);
+}
+
+TEST_F(OutboxFlushTest, BacksOffExponentially) {
+  complete("7000000001");
+  drop_ = 3;
+  loop_after(2500);   // Poging 1, daarna 5 s
+  loop_after(5100);   // Poging 2, daarna 10 s
+  loop_after(5100);   // Te vroeg
+  EXPECT_EQ(host::FakeServer::instance().requests().size(), 2u);
+  loop_after(5100);   // Poging 3, daarna 20 s
+  loop_after(20100);  // Poging 4 lukt
+  EXPECT_EQ(host::FakeServer::instance().requests().size(), 4u);
+  EXPECT_TRUE(api_.outbox().empty());
+  EXPECT_EQ(api_.flush_failures_, 0u);
+}
+
+TEST_F(OutboxFlushTest, KeepsCommandsTheServerDidNotConfirm) {
+  complete("7000000001");
+  complete("7000000002");
+  {
+    // Alleen de eerste uuid is bekend bij de server
+    std::lock_guard<std::mutex> lock(mutex_);
+    uuids_.erase(api_.outbox()[1].uuid);
+  }
+  loop_after(2500);
+  ASSERT_EQ(api_.outbox().size(), 1u);
+  EXPECT_STREQ(api_.outbox()[0].task_id, "7000000002");
+}
+
+}  // namespace todoist
+}  // namespace esphome
@@ -0,0 +1,115 @@
+// Streaming parser van de REST task lijst (parse_tasks_stream)
+#include "todoist_api.h"
+#include "payloads.h"
+#include "string_stream.h"
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <ctime>
+
+namespace esphome {
+namespace todoist {
+
+class ParserApi : public TodoistApi {
+ public:
+  using TodoistApi::parse_tasks_stream;
+};
+
+class ParserTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Due tijden in UTC worden naar lokale tijd omgerekend; vast op UTC voor voorspelbare minuten
+    setenv("TZ", "UTC", 1);
+    tzset();
+  }
+
+  bool parse(const std::string &json) {
+    host::StringStream stream(json);
+    error_.clear();
+    return api_.parse_tasks_stream(stream, tasks_, error_);
+  }
+
+  ParserApi api_;
+  TaskStore tasks_;
+  std::string error_;
+};
+
+TEST_F(ParserTest, ReadsTheDisplayedFields) {
+  ASSERT_TRUE(parse(host::rest_tasks_json(4))) << error_;
+  ASSERT_EQ(tasks_.size(), 4u);
+
+  EXPECT_STREQ(tasks_[0].id(), host::task_id(0).c_str());
+  EXPECT_STREQ(tasks_[0].content(), "Taak 0 boodschappen doen");
+  EXPECT_EQ(strlen(tasks_[0].description()), 40u);
+  EXPECT_STREQ(tasks_[1].project_id(), "2300104729");
+  // REST priority 4 is p1 in de app
+  EXPECT_EQ(tasks_[0].priority(), PRIORITY_4);
+  EXPECT_EQ(tasks_[3].priority(), PRIORITY_1);
+  EXPECT_FALSE(tasks_[0].is_completed());
+}
+
+TEST_F(ParserTest, PrefersTheUtcDatetimeOverTheDate) {
+  ASSERT_TRUE(parse(host::rest_tasks_json(4))) << error_;
+  // Taak 0 en 3 hebben een tijd (datetime_every = 3), 1 en 2 alleen een datum
+  EXPECT_EQ(due_day(tasks_[0].due()), days_from_civil(2024, 3, 1));
+  EXPECT_EQ(due_minute(tasks_[0].due()), 0);
+  EXPECT_EQ(due_minute(tasks_[3].due()), 3 * 60 + 45);
+  EXPECT_EQ(due_day(tasks_[1].due()), days_from_civil(2024, 3, 2));
+  EXPECT_EQ(due_minute(tasks_[1].due()), DUE_NO_TIME);
+  EXPECT_STREQ(tasks_[1].due_string(), "2024-03-02");
+}
+
+TEST_F(ParserTest, DropsLongDescriptions) {
+  host::PayloadOptions options;
+  options.description_length = 400;
+  ASSERT_TRUE(parse(host::rest_tasks_json(2, options))) << error_;
+  ASSERT_EQ(tasks_.size(), 2u);
+  EXPECT_STREQ(tasks_[0].description(), "");
+}
+
+TEST_F(ParserTest, DecodesEscapesAndUnicode) {
+  host::PayloadOptions options;
+  options.unicode = true;
+  ASSERT_TRUE(parse(host::rest_tasks_json(1, options))) << error_;
+  std::string content = tasks_[0].content();
+  EXPECT_NE(content.find("\xc3\xbc"), std::string::npos);  // ü
+  EXPECT_NE(content.find("\"quoted\""), std::string::npos);
+  EXPECT_NE(content.find("\xf0\x9f\x93\x85"), std::string::npos);
+}
+
+TEST_F(ParserTest, AcceptsAnEmptyList) {
+  ASSERT_TRUE(parse(" [ ] ")) << error_;
+  EXPECT_TRUE(tasks_.empty());
+}
+
+TEST_F(ParserTest, RejectsAnObject) {
+  EXPECT_FALSE(parse("{\"error\": \"Forbidden\"}"));
+  EXPECT_EQ(error_, "JSON is not an array");
+}
+
+TEST_F(ParserTest, RejectsATruncatedBody) {
+  std::string json = host::rest_tasks_json(3);
+  EXPECT_FALSE(parse(json.substr(0, json.size() / 2)));
+  EXPECT_EQ(error_.rfind("JSON parse error", 0), 0u) << error_;
+  EXPECT_FALSE(parse(json.substr(0, json.size() - 1)));
+}
+
+TEST_F(ParserTest, FailsWhenTheStoreIsFull) {
+  host::PayloadOptions options;
+  options.description_length = 0;
+  std::string json = host::rest_tasks_json(TaskStore::MAX_TASKS + 20, options);
+  host::StringStream stream(json);
+  EXPECT_FALSE(api_.parse_tasks_stream(stream, tasks_, error_));
+  EXPECT_EQ(error_, "Task store full");
+  // De rest van de body is niet gelezen
+  EXPECT_LT(stream.position(), json.size());
+}
+
+TEST_F(ParserTest, ClearsThePreviousContents) {
+  ASSERT_TRUE(parse(host::rest_tasks_json(5))) << error_;
+  ASSERT_TRUE(parse(host::rest_tasks_json(2))) << error_;
+  EXPECT_EQ(tasks_.size(), 2u);
+}
+
+}  // namespace todoist
+}  // namespace esphome
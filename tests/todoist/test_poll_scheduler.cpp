@@ -0,0 +1,205 @@
+// PollScheduler met een nep-klok: activiteit, wijzigingen, idle backoff, fouten en Retry-After
+#include "todoist_poll_scheduler.h"
+
+#include <gtest/gtest.h>
+#include <set>
+
+namespace esphome {
+namespace todoist {
+
+static const uint32_t SECOND = 1000;
+
+class TestScheduler : public PollScheduler {
+ public:
+  using PollScheduler::next_poll_;
+};
+
+class PollSchedulerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Zonder jitter zijn de wachttijden exact; de jitter heeft een eigen test
+    scheduler_.set_jitter(0.0f);
+    scheduler_.set_active_interval(30 * SECOND);
+    scheduler_.set_idle_interval(300 * SECOND);
+    scheduler_.set_max_interval(1800 * SECOND);
+    scheduler_.set_idle_timeout(120 * SECOND);
+  }
+
+  // Wacht tot de scheduler een poll wil, voert hem uit en geeft de wachttijd in seconden terug
+  uint32_t poll(bool changed = false) {
+    uint32_t waited = advance_to_next_poll();
+    scheduler_.on_poll(now_);
+    now_ += SECOND;
+    scheduler_.on_success(now_, changed);
+    return waited;
+  }
+
+  uint32_t fail(uint32_t retry_after_ms = 0) {
+    uint32_t waited = advance_to_next_poll();
+    scheduler_.on_poll(now_);
+    now_ += SECOND;
+    scheduler_.on_failure(now_, retry_after_ms);
+    return waited;
+  }
+
+  uint32_t advance_to_next_poll() {
+    uint32_t start = now_;
+    if (!scheduler_.should_poll(now_)) {
+      now_ = scheduler_.next_poll_;
+      EXPECT_FALSE(scheduler_.should_poll(now_ - 1));
+    }
+    EXPECT_TRUE(scheduler_.should_poll(now_));
+    return (now_ - start) / SECOND;
+  }
+
+  TestScheduler scheduler_;
+  uint32_t now_ = 5 * SECOND;
+};
+
+TEST_F(PollSchedulerTest, PollsRightAfterBoot) {
+  EXPECT_TRUE(scheduler_.should_poll(now_));
+  EXPECT_FALSE(scheduler_.is_active(now_));
+}
+
+TEST_F(PollSchedulerTest, WaitsForTheResultBeforePlanningTheNextPoll) {
+  scheduler_.on_poll(now_);
+  EXPECT_FALSE(scheduler_.should_poll(now_ + 3600 * SECOND));
+  scheduler_.on_activity(now_ + 10 * SECOND);
+  EXPECT_FALSE(scheduler_.should_poll(now_ + 10 * SECOND));
+}
+
+TEST_F(PollSchedulerTest, BacksOffWhileNobodyLooks) {
+  poll();
+  // Gemeten vanaf het einde van de vorige poll
+  EXPECT_EQ(poll(), 300u);
+  EXPECT_EQ(poll(), 600u);
+  EXPECT_EQ(poll(), 1200u);
+  EXPECT_EQ(poll(), 1800u);
+  EXPECT_EQ(poll(), 1800u);
+}
+
+TEST_F(PollSchedulerTest, PollsFastWhileSomeoneUsesTheScreen) {
+  poll();
+  poll();
+  // Lang na de laatste poll: meteen een verse lijst
+  now_ += 200 * SECOND;
+  scheduler_.on_activity(now_);
+  EXPECT_TRUE(scheduler_.is_active(now_));
+  EXPECT_EQ(poll(), 0u);
+  EXPECT_EQ(poll(), 30u);
+  EXPECT_EQ(poll(), 30u);
+  EXPECT_EQ(poll(), 30u);
+
+  // Na de idle timeout terug naar het gewone interval, weer vanaf het begin van de backoff
+  EXPECT_EQ(poll(), 30u);
+  EXPECT_FALSE(scheduler_.is_active(now_));
+  EXPECT_EQ(poll(), 300u);
+  EXPECT_EQ(poll(), 600u);
+}
+
+TEST_F(PollSchedulerTest, ActivityRightAfterAPollWaitsForTheActiveInterval) {
+  poll();
+  now_ += 10 * SECOND;
+  scheduler_.on_activity(now_);
+  // Poll was 11 s geleden gestart
+  EXPECT_EQ(poll(), 19u);
+}
+
+TEST_F(PollSchedulerTest, ActivityResetsTheIdleBackoff) {
+  poll();
+  poll();
+  poll();
+  EXPECT_EQ(poll(), 1200u);
+  now_ += 5 * SECOND;
+  scheduler_.on_activity(now_);
+  // Actief tot de idle timeout; daarna weer de eerste idle stap
+  while (scheduler_.is_active(now_ + 1))
+    poll();
+  EXPECT_EQ(poll(), 300u);
+}
+
+TEST_F(PollSchedulerTest, AChangeKeepsPollingFast) {
+  poll();
+  EXPECT_EQ(poll(true), 300u);
+  EXPECT_TRUE(scheduler_.is_active(now_));
+  EXPECT_EQ(poll(), 30u);
+  // Elke wijziging verlengt de actieve periode
+  EXPECT_EQ(poll(true), 30u);
+  for (int i = 0; i < 3; i++)
+    EXPECT_EQ(poll(), 30u);
+}
+
+TEST_F(PollSchedulerTest, BacksOffOnFailures) {
+  poll();
+  EXPECT_EQ(fail(), 300u);
+  EXPECT_EQ(fail(), 300u);
+  EXPECT_EQ(fail(), 600u);
+  EXPECT_EQ(fail(), 1200u);
+  EXPECT_EQ(fail(), 1800u);
+  // Een geslaagde poll reset de backoff
+  EXPECT_EQ(poll(), 1800u);
+  EXPECT_EQ(poll(), 600u);
+}
+
+TEST_F(PollSchedulerTest, FailuresWhileActiveStartFromTheActiveInterval) {
+  scheduler_.on_activity(now_);
+  EXPECT_EQ(fail(), 0u);
+  EXPECT_EQ(fail(), 30u);
+  EXPECT_EQ(fail(), 60u);
+  // Aanraken tijdens de backoff haalt de poll niet naar voren
+  scheduler_.on_activity(now_ + SECOND);
+  EXPECT_EQ(fail(), 120u);
+}
+
+TEST_F(PollSchedulerTest, HonoursRetryAfterAboveTheMaxInterval) {
+  poll();
+  EXPECT_EQ(fail(3600 * SECOND), 300u);
+  EXPECT_FALSE(scheduler_.should_poll(now_ + 3599 * SECOND));
+  now_ += 3000 * SECOND;
+  scheduler_.on_activity(now_);
+  EXPECT_FALSE(scheduler_.should_poll(now_));
+  EXPECT_EQ(poll(), 600u);
+}
+
+TEST_F(PollSchedulerTest, RetryAfterIsAFloorForActivityAfterAFailure) {
+  poll();
+  // Korte Retry-After, dan een geslaagde poll: de ondergrens is weg
+  EXPECT_EQ(fail(60 * SECOND), 300u);
+  EXPECT_EQ(poll(), 300u);
+  now_ += 100 * SECOND;
+  scheduler_.on_activity(now_);
+  EXPECT_EQ(poll(), 0u);
+}
+
+TEST_F(PollSchedulerTest, HandlesMillisWrapAround) {
+  now_ = 0xFFFFFFFF - 100 * SECOND;
+  poll();
+  scheduler_.on_activity(now_);
+  EXPECT_EQ(poll(), 29u);
+  EXPECT_EQ(poll(), 30u);
+  EXPECT_EQ(poll(), 30u);
+  EXPECT_LT(now_, 0x80000000u);
+  EXPECT_TRUE(scheduler_.is_active(now_));
+}
+
+TEST(PollSchedulerJitterTest, SpreadsPollsAroundTheInterval) {
+  TestScheduler scheduler;
+  scheduler.set_jitter(0.1f);
+  scheduler.set_idle_interval(300 * SECOND);
+  scheduler.set_max_interval(300 * SECOND);
+  std::set<uint32_t> delays;
+  uint32_t now = 0;
+  for (int i = 0; i < 200; i++) {
+    scheduler.on_poll(now);
+    scheduler.on_success(now, false);
+    uint32_t delay = scheduler.next_poll_ - now;
+    ASSERT_GE(delay, 270 * SECOND);
+    ASSERT_LE(delay, 330 * SECOND);
+    delays.insert(delay);
+    now = scheduler.next_poll_;
+  }
+  EXPECT_GT(delays.size(), 100u);
+}
+
+}  // namespace todoist
+}  // namespace esphome
@@ -0,0 +1,232 @@
+// TaskSnapshot: opslaan en terugzetten via de spiffs partitie, en wat er gebeurt als het misgaat
+#include "todoist_snapshot.h"
+
+#include <esp_rom_crc.h>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+namespace esphome {
+namespace todoist {
+
+static const size_t PARTITION_SIZE = 64 * 1024;
+
+static TodoistTask make_task(size_t index) {
+  TodoistTask task;
+  task.id = std::to_string(7000000000ULL + index);
+  task.content = "Taak " + std::to_string(index);
+  task.description = index % 3 == 0 ? "Beschrijving met één accent" : "";
+  task.project_id = std::to_string(2300000000ULL + index % 4);
+  task.due_date = "2024-03-0" + std::to_string(1 + index % 9);
+  task.due_string = "mrt";
+  task.priority = static_cast<TaskPriority>(1 + index % 4);
+  return task;
+}
+
+static void fill(TaskStore &store, size_t count, size_t first = 0) {
+  for (size_t i = first; i < first + count; i++)
+    ASSERT_TRUE(store.add(make_task(i)));
+}
+
+class TaskSnapshotTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::FlashPartition &flash = host::flash();
+    flash.data.assign(PARTITION_SIZE, 0xFF);
+    flash.fail_after_writes = -1;
+    flash.erase_count = 0;
+    flash.write_count = 0;
+    ASSERT_TRUE(snapshot_.setup());
+  }
+
+  void TearDown() override { host::flash().data.clear(); }
+
+  // Na een herstart: een nieuwe TaskSnapshot zonder last_crc_
+  bool load_after_restart(TaskStore &store) {
+    TaskSnapshot snapshot;
+    return snapshot.setup() && snapshot.load(store);
+  }
+
+  TaskSnapshot::Header header() const {
+    TaskSnapshot::Header header;
+    memcpy(&header, host::flash().data.data(), sizeof(header));
+    return header;
+  }
+
+  TaskSnapshot snapshot_;
+};
+
+TEST_F(TaskSnapshotTest, RestoresTheStoredTasks) {
+  TaskStore store;
+  fill(store, 50);
+  store.reclassify(days_from_civil(2024, 3, 4), 8 * 60);
+  ASSERT_TRUE(snapshot_.save(store));
+
+  TaskStore restored;
+  ASSERT_TRUE(load_after_restart(restored));
+  ASSERT_EQ(restored.size(), store.size());
+  EXPECT_EQ(restored.today(), store.today());
+  for (size_t i = 0; i < store.size(); i++) {
+    EXPECT_STREQ(restored[i].id(), store[i].id());
+    EXPECT_STREQ(restored[i].content(), store[i].content());
+    EXPECT_STREQ(restored[i].description(), store[i].description());
+    EXPECT_STREQ(restored[i].project_id(), store[i].project_id());
+    EXPECT_EQ(restored[i].due(), store[i].due());
+    EXPECT_EQ(restored[i].priority(), store[i].priority());
+    EXPECT_EQ(restored[i].due_class(), store[i].due_class());
+  }
+  // De index is opnieuw opgebouwd
+  EXPECT_EQ(restored.find("7000000042"), 42);
+  ASSERT_TRUE(restored.add(make_task(50)));
+  EXPECT_EQ(restored.find("7000000050"), 50);
+}
+
+TEST_F(TaskSnapshotTest, RestoresAnEmptyList) {
+  TaskStore store;
+  ASSERT_TRUE(snapshot_.save(store));
+  TaskStore restored;
+  fill(restored, 3);
+  ASSERT_TRUE(load_after_restart(restored));
+  EXPECT_TRUE(restored.empty());
+}
+
+TEST_F(TaskSnapshotTest, FindsNothingOnErasedFlash) {
+  TaskStore store;
+  fill(store, 2);
+  EXPECT_FALSE(snapshot_.load(store));
+  EXPECT_EQ(store.size(), 2u);
+}
+
+TEST_F(TaskSnapshotTest, IsDisabledWithoutPartition) {
+  host::flash().data.clear();
+  TaskSnapshot snapshot;
+  EXPECT_FALSE(snapshot.setup());
+  TaskStore store;
+  EXPECT_FALSE(snapshot.save(store));
+  EXPECT_FALSE(snapshot.load(store));
+}
+
+TEST_F(TaskSnapshotTest, SkipsASaveWithoutChanges) {
+  TaskStore store;
+  fill(store, 10);
+  ASSERT_TRUE(snapshot_.save(store));
+  ASSERT_TRUE(snapshot_.save(store));
+  EXPECT_EQ(host::flash().erase_count, 1u);
+
+  // Ook na een herstart: de geladen snapshot telt als laatst opgeslagen
+  TaskSnapshot snapshot;
+  ASSERT_TRUE(snapshot.setup());
+  TaskStore restored;
+  ASSERT_TRUE(snapshot.load(restored));
+  ASSERT_TRUE(snapshot.save(restored));
+  EXPECT_EQ(host::flash().erase_count, 1u);
+
+  ASSERT_TRUE(restored.add(make_task(10)));
+  ASSERT_TRUE(snapshot.save(restored));
+  EXPECT_EQ(host::flash().erase_count, 2u);
+}
+
+TEST_F(TaskSnapshotTest, RejectsAChecksumMismatch) {
+  TaskStore store;
+  fill(store, 10);
+  ASSERT_TRUE(snapshot_.save(store));
+  host::flash().data[sizeof(TaskSnapshot::Header) + 10 * sizeof(TaskStore::Record) + 5] ^= 0x01;
+
+  TaskStore restored;
+  fill(restored, 1, 100);
+  EXPECT_FALSE(load_after_restart(restored));
+  ASSERT_EQ(restored.size(), 1u);
+  EXPECT_STREQ(restored[0].id(), "7000000100");
+}
+
+TEST_F(TaskSnapshotTest, RejectsAnOtherVersionOrLayout) {
+  TaskStore store;
+  fill(store, 4);
+  ASSERT_TRUE(snapshot_.save(store));
+
+  TaskSnapshot::Header changed = header();
+  changed.version++;
+  memcpy(host::flash().data.data(), &changed, sizeof(changed));
+  TaskStore restored;
+  EXPECT_FALSE(load_after_restart(restored));
+
+  changed.version--;
+  changed.record_size += 4;
+  memcpy(host::flash().data.data(), &changed, sizeof(changed));
+  EXPECT_FALSE(load_after_restart(restored));
+  EXPECT_TRUE(restored.empty());
+}
+
+TEST_F(TaskSnapshotTest, RejectsACountLargerThanThePartition) {
+  TaskStore store;
+  fill(store, 4);
+  ASSERT_TRUE(snapshot_.save(store));
+  TaskSnapshot::Header changed = header();
+  changed.count = TaskStore::MAX_TASKS;
+  changed.arena_size = TaskStore::MAX_ARENA_SIZE;
+  memcpy(host::flash().data.data(), &changed, sizeof(changed));
+  TaskStore restored;
+  EXPECT_FALSE(load_after_restart(restored));
+}
+
+TEST_F(TaskSnapshotTest, RejectsOffsetsOutsideTheArenaEvenWithAValidChecksum) {
+  TaskStore store;
+  fill(store, 4);
+  ASSERT_TRUE(snapshot_.save(store));
+
+  TaskSnapshot::Header changed = header();
+  uint8_t *data = host::flash().data.data();
+  TaskStore::Record record;
+  memcpy(&record, data + sizeof(changed), sizeof(record));
+  record.content = changed.arena_size + 100;
+  // Flash kan alleen bits wissen; hier direct in de buffer schrijven zoals een andere firmware
+  memcpy(data + sizeof(changed), &record, sizeof(record));
+  size_t records_size = changed.count * sizeof(TaskStore::Record);
+  uint32_t crc = esp_rom_crc32_le(0, data + sizeof(changed), records_size);
+  changed.crc = esp_rom_crc32_le(crc, data + sizeof(changed) + records_size, changed.arena_size);
+  memcpy(data, &changed, sizeof(changed));
+
+  TaskStore restored;
+  EXPECT_FALSE(load_after_restart(restored));
+  EXPECT_TRUE(restored.empty());
+}
+
+TEST_F(TaskSnapshotTest, AnInterruptedSaveLeavesNoSnapshotRatherThanAWrongOne) {
+  TaskStore first;
+  fill(first, 10);
+  ASSERT_TRUE(snapshot_.save(first));
+
+  // Records geschreven, arena niet, header nooit
+  TaskStore second;
+  fill(second, 20, 50);
+  host::flash().fail_after_writes = 1;
+  EXPECT_FALSE(snapshot_.save(second));
+
+  TaskStore restored;
+  EXPECT_FALSE(load_after_restart(restored));
+  EXPECT_TRUE(restored.empty());
+
+  // Alles behalve de header
+  host::flash().fail_after_writes = 2;
+  EXPECT_FALSE(snapshot_.save(second));
+  EXPECT_FALSE(load_after_restart(restored));
+
+  // De volgende save schrijft alles opnieuw, ook met dezelfde inhoud
+  host::flash().fail_after_writes = -1;
+  ASSERT_TRUE(snapshot_.save(second));
+  ASSERT_TRUE(load_after_restart(restored));
+  EXPECT_EQ(restored.size(), 20u);
+}
+
+TEST_F(TaskSnapshotTest, RefusesAListLargerThanThePartition) {
+  host::flash().data.assign(4096, 0xFF);
+  TaskSnapshot snapshot;
+  ASSERT_TRUE(snapshot.setup());
+  TaskStore store;
+  fill(store, 200);
+  EXPECT_FALSE(snapshot.save(store));
+  EXPECT_EQ(host::flash().erase_count, 0u);
+}
+
+}  // namespace todoist
+}  // namespace esphome
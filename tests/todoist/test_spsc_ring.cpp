@@ -0,0 +1,98 @@
+// SpscRing tussen de netwerktaak en de main loop
+#include "todoist_spsc_ring.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace esphome {
+namespace todoist {
+
+TEST(SpscRingTest, HoldsOneItemLessThanItsSize) {
+  SpscRing<int, 4> ring;
+  EXPECT_TRUE(ring.empty());
+  EXPECT_TRUE(ring.push(1));
+  EXPECT_TRUE(ring.push(2));
+  EXPECT_TRUE(ring.push(3));
+  EXPECT_FALSE(ring.push(4));
+
+  int item;
+  ASSERT_TRUE(ring.pop(item));
+  EXPECT_EQ(item, 1);
+  EXPECT_TRUE(ring.push(4));
+  for (int expected : {2, 3, 4}) {
+    ASSERT_TRUE(ring.pop(item));
+    EXPECT_EQ(item, expected);
+  }
+  EXPECT_FALSE(ring.pop(item));
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, WrapsAround) {
+  SpscRing<int, 3> ring;
+  int item;
+  for (int i = 0; i < 100; i++) {
+    ASSERT_TRUE(ring.push(i));
+    ASSERT_TRUE(ring.pop(item));
+    ASSERT_EQ(item, i);
+  }
+}
+
+// Producer en consumer op eigen threads, met een kleine ring zodat hij steeds vol en leeg raakt
+TEST(SpscRingTest, DeliversEveryItemInOrderAcrossThreads) {
+  static const int COUNT = 200000;
+  SpscRing<int, 4> ring;
+
+  std::thread producer([&ring] {
+    for (int i = 0; i < COUNT; i++) {
+      while (!ring.push(i))
+        std::this_thread::yield();
+    }
+  });
+
+  int expected = 0;
+  while (expected < COUNT) {
+    int item;
+    if (!ring.pop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(item, expected);
+    expected++;
+  }
+  producer.join();
+  EXPECT_TRUE(ring.empty());
+}
+
+// De payload moet volledig zichtbaar zijn voor de consumer zodra pop() hem geeft
+TEST(SpscRingTest, PublishesThePointedToData) {
+  struct Job {
+    int a;
+    int b;
+  };
+  static const int COUNT = 50000;
+  SpscRing<Job *, 8> ring;
+
+  std::thread producer([&ring] {
+    for (int i = 0; i < COUNT; i++) {
+      Job *job = new Job{i, -i};
+      while (!ring.push(job))
+        std::this_thread::yield();
+    }
+  });
+
+  for (int received = 0; received < COUNT;) {
+    Job *job;
+    if (!ring.pop(job)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(job->a, received);
+    ASSERT_EQ(job->b, -received);
+    delete job;
+    received++;
+  }
+  producer.join();
+}
+
+}  // namespace todoist
+}  // namespace esphome
@@ -0,0 +1,162 @@
+// Sync API: parse_sync_stream en het sync token
+#include "todoist_api.h"
+#include "host_http.h"
+#include "payloads.h"
+#include "string_stream.h"
+
+#include <gtest/gtest.h>
+
+namespace esphome {
+namespace todoist {
+
+class SyncApi : public TodoistApi {
+ public:
+  using TodoistApi::parse_sync_stream;
+  using TodoistApi::sync_token_;
+};
+
+class SyncParseTest : public ::testing::Test {
+ protected:
+  bool parse(const std::string &json, bool &full_sync) {
+    host::StringStream stream(json);
+    error_.clear();
+    return api_.parse_sync_stream(stream, changes_, full_sync, token_, error_);
+  }
+
+  SyncApi api_;
+  TaskStore changes_;
+  std::string token_;
+  std::string error_;
+};
+
+TEST_F(SyncParseTest, ReadsItemsAndTheToken) {
+  bool full_sync = true;
+  ASSERT_TRUE(parse(host::sync_items_json(3, true, "tok-1"), full_sync)) << error_;
+  EXPECT_TRUE(full_sync);
+  EXPECT_EQ(token_, "tok-1");
+  ASSERT_EQ(changes_.size(), 3u);
+  EXPECT_STREQ(changes_[0].id(), host::task_id(0).c_str());
+}
+
+TEST_F(SyncParseTest, TurnsCompletedAndDeletedItemsIntoTombstones) {
+  bool full_sync = false;
+  ASSERT_TRUE(parse(host::sync_items_json(5, false, "tok-2", 1, 1), full_sync)) << error_;
+  EXPECT_FALSE(full_sync);
+  ASSERT_EQ(changes_.size(), 5u);
+  EXPECT_TRUE(changes_[0].is_deleted());
+  EXPECT_TRUE(changes_[1].is_deleted());
+  EXPECT_FALSE(changes_[2].is_deleted());
+}
+
+TEST_F(SyncParseTest, LearnsAboutAFullSyncAfterTheItems) {
+  // Gevraagd als delta, maar de server antwoordt (na items) met full_sync: true
+  bool full_sync = false;
+  ASSERT_TRUE(parse(host::sync_items_json(3, true, "tok-3", 1), full_sync)) << error_;
+  EXPECT_TRUE(full_sync);
+  // De tombstone staat er nog in; apply_changes met replace laat hem vallen
+  TaskStore store;
+  ASSERT_TRUE(store.apply_changes(changes_, full_sync));
+  EXPECT_EQ(store.size(), 2u);
+}
+
+TEST_F(SyncParseTest, RejectsADeltaThatDoesNotFit) {
+  bool full_sync = false;
+  host::PayloadOptions options;
+  options.description_length = 0;
+  EXPECT_FALSE(parse(host::sync_items_json(TaskStore::MAX_TASKS + 1, false, "tok-4", 0, 0, options), full_sync));
+  EXPECT_EQ(error_, "Task store full");
+}
+
+TEST_F(SyncParseTest, RejectsAResponseWithoutToken) {
+  bool full_sync = false;
+  EXPECT_FALSE(parse("{\"items\": [], \"full_sync\": false}", full_sync));
+  EXPECT_EQ(error_, "Incomplete sync response");
+}
+
+TEST_F(SyncParseTest, SkipsUnknownKeys) {
+  bool full_sync = false;
+  ASSERT_TRUE(parse("{\"user\": {\"a\": [1, {\"b\": \"}\"}]}, \"items\": [], \"sync_token\": \"t\", "
+                    "\"day_orders\": {}, \"full_sync\": false}",
+                    full_sync))
+      << error_;
+  EXPECT_EQ(token_, "t");
+}
+
+TEST_F(SyncParseTest, ReadsHandWrittenItems) {
+  std::vector<host::SyncItem> items(2);
+  items[0].id = "a1";
+  items[0].content = "Met \"quotes\"";
+  items[0].due = "2024-03-11";
+  items[0].priority = 4;
+  items[1].id = "b2";
+  items[1].content = "Met tijd";
+  items[1].due = "2024-03-11T14:30:00Z";
+  bool full_sync = false;
+  ASSERT_TRUE(parse(host::sync_json(items, true, "tok-5"), full_sync)) << error_;
+  EXPECT_TRUE(full_sync);
+  ASSERT_EQ(changes_.size(), 2u);
+  EXPECT_STREQ(changes_[0].content(), "Met \"quotes\"");
+  EXPECT_EQ(changes_[0].priority(), PRIORITY_1);  // API 4 is p1
+  EXPECT_STREQ(changes_[1].id(), "b2");
+}
+
+class SyncTokenTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    host::FakeServer::instance().reset();
+    api_.set_api_key("test-token");
+  }
+
+  bool sync() {
+    bool ok = false;
+    api_.sync_tasks([&](TaskStore &&, bool) { ok = true; }, [&](std::string) { ok = false; });
+    return ok;
+  }
+
+  SyncApi api_;
+};
+
+TEST_F(SyncTokenTest, AdvancesOnlyAfterASuccessfulParse) {
+  std::string next_response = host::sync_items_json(2, true, "tok-a");
+  host::FakeServer::instance().set_handler(
+      [&](const host::FakeRequest &) { return host::FakeResponse::json(next_response); });
+  ASSERT_TRUE(sync());
+  EXPECT_EQ(api_.sync_token_, "tok-a");
+
+  // Afgekapte body: het token blijft staan
+  next_response = host::sync_items_json(2, false, "tok-b");
+  next_response.resize(next_response.size() / 2);
+  EXPECT_FALSE(sync());
+  EXPECT_EQ(api_.sync_token_, "tok-a");
+
+  auto requests = host::FakeServer::instance().requests();
+  ASSERT_EQ(requests.size(), 2u);
+  EXPECT_NE(requests[1].body.find("sync_token=tok-a"), std::string::npos) << requests[1].body;
+}
+
+TEST_F(SyncTokenTest, FallsBackToAFullSyncWhenTheDeltaDoesNotFit) {
+  std::string next_response = host::sync_items_json(2, true, "tok-a");
+  host::FakeServer::instance().set_handler(
+      [&](const host::FakeRequest &) { return host::FakeResponse::json(next_response); });
+  ASSERT_TRUE(sync());
+
+  host::PayloadOptions options;
+  options.description_length = 0;
+  next_response = host::sync_items_json(TaskStore::MAX_TASKS + 5, false, "tok-b", 0, 0, options);
+  EXPECT_FALSE(sync());
+  EXPECT_EQ(api_.sync_token_, "*");
+}
+
+TEST_F(SyncTokenTest, RequestFullSyncResetsTheToken) {
+  host::FakeServer::instance().set_handler(
+      [](const host::FakeRequest &) { return host::FakeResponse::json(host::sync_items_json(1, true, "tok-a")); });
+  ASSERT_TRUE(sync());
+  api_.request_full_sync();
+  ASSERT_TRUE(sync());
+  auto requests = host::FakeServer::instance().requests();
+  ASSERT_EQ(requests.size(), 2u);
+  EXPECT_NE(requests[1].body.find("sync_token=%2A"), std::string::npos) << requests[1].body;
+}
+
+}  // namespace todoist
+}  // namespace esphome
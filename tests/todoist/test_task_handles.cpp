@@ -0,0 +1,172 @@
+// TaskHandles: generaties, hergebruik van slots en rebind na een nieuwe store
+#include "todoist_task_handles.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace todoist {
+
+static TodoistTask make_task(size_t number) {
+  TodoistTask task;
+  task.id = std::to_string(7000000000ULL + number);
+  task.content = "Taak " + std::to_string(number);
+  task.project_id = "2300000000";
+  return task;
+}
+
+static void fill(TaskStore &store, const std::vector<size_t> &numbers) {
+  store.clear();
+  for (size_t number : numbers)
+    ASSERT_TRUE(store.add(make_task(number)));
+}
+
+TEST(TaskHandlesTest, ResolvesToTheAcquiredIndex) {
+  TaskStore store;
+  fill(store, {0, 1, 2});
+  TaskHandles handles;
+  TaskHandle a = handles.acquire(store, 0);
+  TaskHandle c = handles.acquire(store, 2);
+  EXPECT_NE(a, TASK_HANDLE_NONE);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(handles.resolve(a), 0);
+  EXPECT_EQ(handles.resolve(c), 2);
+  EXPECT_EQ(handles.live(), 2u);
+  EXPECT_EQ(handles.resolve(TASK_HANDLE_NONE), -1);
+}
+
+TEST(TaskHandlesTest, AReleasedHandleStaysDeadWhenTheSlotIsReused) {
+  TaskStore store;
+  fill(store, {0, 1});
+  TaskHandles handles;
+  TaskHandle old = handles.acquire(store, 0);
+  handles.release(old);
+  EXPECT_EQ(handles.resolve(old), -1);
+  EXPECT_EQ(handles.live(), 0u);
+
+  TaskHandle reused = handles.acquire(store, 1);
+  EXPECT_EQ(reused & 0xFFFF, old & 0xFFFF);
+  EXPECT_NE(reused, old);
+  EXPECT_EQ(handles.resolve(old), -1);
+  EXPECT_EQ(handles.resolve(reused), 1);
+
+  // Een verlopen handle nog eens vrijgeven raakt de nieuwe eigenaar niet
+  handles.release(old);
+  EXPECT_EQ(handles.resolve(reused), 1);
+  EXPECT_EQ(handles.live(), 1u);
+}
+
+TEST(TaskHandlesTest, IgnoresUnknownHandles) {
+  TaskHandles handles;
+  handles.release(TASK_HANDLE_NONE);
+  handles.release(0x00010005);
+  EXPECT_EQ(handles.resolve(0x00010005), -1);
+  EXPECT_EQ(handles.live(), 0u);
+}
+
+TEST(TaskHandlesTest, FollowsTasksToTheirNewIndexAfterRebind) {
+  TaskStore store;
+  fill(store, {0, 1, 2, 3});
+  TaskHandles handles;
+  TaskHandle first = handles.acquire(store, 0);
+  TaskHandle third = handles.acquire(store, 2);
+  TaskHandle last = handles.acquire(store, 3);
+
+  // Nieuwe volgorde van de server, taak 2 is voltooid
+  TaskStore replaced;
+  fill(replaced, {3, 4, 0, 1});
+  handles.rebind(replaced);
+  EXPECT_EQ(handles.resolve(first), 2);
+  EXPECT_EQ(handles.resolve(third), -1);
+  EXPECT_EQ(handles.resolve(last), 0);
+  // Het slot blijft bezet tot release, en de taak kan terugkomen
+  EXPECT_EQ(handles.live(), 3u);
+  handles.rebind(store);
+  EXPECT_EQ(handles.resolve(third), 2);
+}
+
+TEST(TaskHandlesTest, NeverHandsOutZero) {
+  TaskStore store;
+  fill(store, {0});
+  TaskHandles handles;
+  // Eén slot vaak genoeg hergebruiken om de generatie rond te laten gaan
+  for (uint32_t i = 0; i < 0x10002; i++) {
+    TaskHandle handle = handles.acquire(store, 0);
+    ASSERT_NE(handle, TASK_HANDLE_NONE) << i;
+    ASSERT_EQ(handles.resolve(handle), 0);
+    handles.release(handle);
+  }
+}
+
+// Willekeurige acquire/release/rebind tegen een eenvoudig model: elke levende handle hoort bij
+// een id en resolve geeft de index van dat id in de huidige store, elke vrijgegeven handle -1
+TEST(TaskHandlesTest, MatchesAModelUnderRandomOperations) {
+  std::mt19937 rng(20240301);
+  TaskStore store;
+  std::vector<size_t> numbers;
+  for (size_t i = 0; i < 40; i++)
+    numbers.push_back(i);
+  fill(store, numbers);
+  size_t next_number = numbers.size();
+
+  TaskHandles handles;
+  std::map<TaskHandle, std::string> live;
+  std::vector<TaskHandle> released;
+
+  for (int step = 0; step < 20000; step++) {
+    int op = rng() % 10;
+    if (op < 4 && !store.empty()) {
+      size_t index = rng() % store.size();
+      TaskHandle handle = handles.acquire(store, index);
+      ASSERT_NE(handle, TASK_HANDLE_NONE);
+      ASSERT_EQ(live.count(handle), 0u);
+      live[handle] = store[index].id();
+    } else if (op < 8 && !live.empty()) {
+      auto it = live.begin();
+      std::advance(it, rng() % live.size());
+      handles.release(it->first);
+      // Alleen de recente; een slot gaat pas na 65535 releases weer naar dezelfde generatie
+      if (released.size() == 256)
+        released.erase(released.begin());
+      released.push_back(it->first);
+      live.erase(it);
+    } else if (op == 8) {
+      // Nieuwe store: schudden, een paar taken weg, een paar nieuw
+      std::shuffle(numbers.begin(), numbers.end(), rng);
+      size_t drop = std::min<size_t>(numbers.size(), rng() % 4);
+      numbers.resize(numbers.size() - drop);
+      for (size_t add = rng() % 4; add > 0; add--)
+        numbers.push_back(next_number++);
+      TaskStore replaced;
+      fill(replaced, numbers);
+      store = std::move(replaced);
+      handles.rebind(store);
+    } else if (!released.empty()) {
+      // Een verlopen handle opnieuw vrijgeven mag niets doen
+      handles.release(released[rng() % released.size()]);
+    }
+
+    ASSERT_EQ(handles.live(), live.size());
+    if (step % 50 != 0)
+      continue;
+    for (const auto &entry : live) {
+      int index = handles.resolve(entry.first);
+      ASSERT_EQ(index, store.find(entry.second.c_str())) << "step " << step;
+      if (index >= 0) {
+        ASSERT_EQ(entry.second, store[index].id());
+      }
+    }
+    for (TaskHandle handle : released) {
+      if (live.count(handle) == 0) {
+        ASSERT_EQ(handles.resolve(handle), -1) << "step " << step;
+      }
+    }
+  }
+}
+
+}  // namespace todoist
+}  // namespace esphome
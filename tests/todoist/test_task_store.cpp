@@ -0,0 +1,370 @@
+// TaskStore: arena, records, caps en move semantiek
+#include "todoist_task_store.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace esphome {
+namespace todoist {
+
+static TodoistTask make_task(size_t index, const std::string &project = "2300000000") {
+  TodoistTask task;
+  task.id = std::to_string(7000000000ULL + index);
+  task.content = "Taak " + std::to_string(index);
+  task.description = index % 2 == 0 ? "" : "Korte beschrijving";
+  task.project_id = project;
+  task.due_date = "2024-03-01";
+  task.due_string = "1 mrt";
+  task.priority = static_cast<TaskPriority>(1 + index % 4);
+  return task;
+}
+
+// Geeft de store toegang tot de arena voor de tests die de layout controleren
+class InspectableStore : public TaskStore {
+ public:
+  using TaskStore::arena_size_;
+  using TaskStore::records_;
+};
+
+TEST(TaskStoreTest, KeepsAllFieldsOfATask) {
+  TaskStore store;
+  TodoistTask task = make_task(1);
+  task.is_completed = true;
+  ASSERT_TRUE(store.add(task));
+
+  ASSERT_EQ(store.size(), 1u);
+  TaskStore::TaskRef ref = store[0];
+  EXPECT_STREQ(ref.id(), "7000000001");
+  EXPECT_STREQ(ref.content(), "Taak 1");
+  EXPECT_STREQ(ref.description(), "Korte beschrijving");
+  EXPECT_STREQ(ref.project_id(), "2300000000");
+  EXPECT_STREQ(ref.due_string(), "1 mrt");
+  EXPECT_EQ(due_day(ref.due()), days_from_civil(2024, 3, 1));
+  EXPECT_EQ(ref.priority(), PRIORITY_2);
+  EXPECT_TRUE(ref.is_completed());
+  EXPECT_FALSE(ref.is_deleted());
+}
+
+TEST(TaskStoreTest, HoldsMoreThanFiveTasks) {
+  TaskStore store;
+  for (size_t i = 0; i < 100; i++)
+    ASSERT_TRUE(store.add(make_task(i)));
+  ASSERT_EQ(store.size(), 100u);
+  for (size_t i = 0; i < 100; i++)
+    EXPECT_EQ(std::string(store[i].content()), "Taak " + std::to_string(i));
+}
+
+TEST(TaskStoreTest, EmptyStringsTakeNoArenaSpace) {
+  InspectableStore store;
+  TodoistTask task;
+  task.id = "1";
+  ASSERT_TRUE(store.add(task));
+  // Alleen de gedeelde nul-byte en het id
+  EXPECT_EQ(store.arena_size_, 1u + 2u);
+  EXPECT_STREQ(store[0].content(), "");
+  EXPECT_FALSE(store[0].has_due_date());
+}
+
+TEST(TaskStoreTest, RejectsTasksBeyondMaxTasks) {
+  TaskStore store;
+  for (size_t i = 0; i < TaskStore::MAX_TASKS; i++)
+    ASSERT_TRUE(store.add(make_task(i)));
+  EXPECT_FALSE(store.add(make_task(TaskStore::MAX_TASKS)));
+  EXPECT_EQ(store.size(), (size_t) TaskStore::MAX_TASKS);
+}
+
+TEST(TaskStoreTest, RollsBackATaskThatDoesNotFitTheArena) {
+  InspectableStore store;
+  TodoistTask task = make_task(0);
+  task.content.assign(TaskStore::MAX_ARENA_SIZE / 3, 'x');
+  ASSERT_TRUE(store.add(task));
+  task.id = "2";
+  ASSERT_TRUE(store.add(task));
+  size_t used = store.arena_size_;
+
+  task.id = "3";
+  EXPECT_FALSE(store.add(task));
+  EXPECT_EQ(store.size(), 2u);
+  EXPECT_EQ(store.arena_size_, used);
+
+  // Een kleine taak past nog wel
+  EXPECT_TRUE(store.add(make_task(4)));
+  EXPECT_STREQ(store[2].content(), "Taak 4");
+}
+
+TEST(TaskStoreTest, MoveTransfersOwnership) {
+  TaskStore source;
+  for (size_t i = 0; i < 10; i++)
+    ASSERT_TRUE(source.add(make_task(i)));
+
+  TaskStore moved(std::move(source));
+  EXPECT_EQ(moved.size(), 10u);
+  EXPECT_STREQ(moved[9].content(), "Taak 9");
+  EXPECT_TRUE(source.empty());  // NOLINT(bugprone-use-after-move)
+
+  TaskStore assigned;
+  ASSERT_TRUE(assigned.add(make_task(99)));
+  assigned = std::move(moved);
+  EXPECT_EQ(assigned.size(), 10u);
+  EXPECT_STREQ(assigned[0].content(), "Taak 0");
+
+  // Een leeggemaakte store is weer bruikbaar
+  ASSERT_TRUE(source.add(make_task(1)));
+  EXPECT_EQ(source.size(), 1u);
+}
+
+TEST(TaskStoreTest, ClearKeepsTheArenaForTheNextFetch) {
+  TaskStore store;
+  for (size_t i = 0; i < 50; i++)
+    ASSERT_TRUE(store.add(make_task(i)));
+  size_t usage = store.memory_usage();
+  store.clear();
+  EXPECT_TRUE(store.empty());
+  for (size_t i = 0; i < 50; i++)
+    ASSERT_TRUE(store.add(make_task(i + 100)));
+  EXPECT_EQ(store.memory_usage(), usage);
+  EXPECT_STREQ(store[0].content(), "Taak 100");
+}
+
+TEST(TaskStoreTest, CopiesFromAnotherStore) {
+  TaskStore source;
+  ASSERT_TRUE(source.add(make_task(3)));
+  TaskStore copy;
+  ASSERT_TRUE(copy.add(source[0]));
+  source.clear();
+  ASSERT_TRUE(source.add(make_task(8)));
+  EXPECT_STREQ(copy[0].content(), "Taak 3");
+  EXPECT_EQ(copy[0].priority(), PRIORITY_4);
+}
+
+}  // namespace todoist
+}  // namespace esphome
+
+// ---- apply_changes (Sync API) ----
+
+namespace esphome {
+namespace todoist {
+
+static TodoistTask make_tombstone(size_t index) {
+  TodoistTask task;
+  task.id = std::to_string(7000000000ULL + index);
+  task.is_deleted = true;
+  return task;
+}
+
+TEST(TaskStoreApplyChangesTest, ReplacesInPlaceDropsTombstonesAndAppendsNewItems) {
+  TaskStore store;
+  for (size_t i = 0; i < 4; i++)
+    ASSERT_TRUE(store.add(make_task(i)));
+
+  TaskStore changes;
+  TodoistTask updated = make_task(2);
+  updated.content = "Gewijzigd";
+  ASSERT_TRUE(changes.add(updated));
+  ASSERT_TRUE(changes.add(make_tombstone(1)));
+  ASSERT_TRUE(changes.add(make_task(9)));
+
+  ASSERT_TRUE(store.apply_changes(changes, false));
+  ASSERT_EQ(store.size(), 4u);
+  EXPECT_STREQ(store[0].content(), "Taak 0");
+  EXPECT_STREQ(store[1].content(), "Gewijzigd");
+  EXPECT_STREQ(store[2].content(), "Taak 3");
+  EXPECT_STREQ(store[3].content(), "Taak 9");
+  EXPECT_EQ(store.find("7000000001"), -1);
+  EXPECT_EQ(store.find("7000000009"), 3);
+}
+
+TEST(TaskStoreApplyChangesTest, ReplaceDiscardsTheOldContents) {
+  TaskStore store;
+  for (size_t i = 0; i < 4; i++)
+    ASSERT_TRUE(store.add(make_task(i)));
+
+  TaskStore changes;
+  ASSERT_TRUE(changes.add(make_task(7)));
+  // Een full sync waarin toch een tombstone zit (full_sync kwam pas na items)
+  ASSERT_TRUE(changes.add(make_tombstone(8)));
+  ASSERT_TRUE(store.apply_changes(changes, true));
+  ASSERT_EQ(store.size(), 1u);
+  EXPECT_STREQ(store[0].content(), "Taak 7");
+}
+
+TEST(TaskStoreApplyChangesTest, LeavesTheStoreUnchangedWhenTheResultDoesNotFit) {
+  TaskStore store;
+  for (size_t i = 0; i < TaskStore::MAX_TASKS; i++)
+    ASSERT_TRUE(store.add(make_task(i)));
+
+  TaskStore changes;
+  ASSERT_TRUE(changes.add(make_tombstone(0)));
+  ASSERT_TRUE(changes.add(make_task(TaskStore::MAX_TASKS)));
+  ASSERT_TRUE(changes.add(make_task(TaskStore::MAX_TASKS + 1)));
+
+  EXPECT_FALSE(store.apply_changes(changes, false));
+  EXPECT_EQ(store.size(), (size_t) TaskStore::MAX_TASKS);
+  EXPECT_EQ(store.find("7000000000"), 0);
+}
+
+}  // namespace todoist
+}  // namespace esphome
+
+// ---- reclassify en next_due_minute (lokaal herindelen zonder fetch) ----
+
+namespace esphome {
+namespace todoist {
+
+static TodoistTask make_due_task(const std::string &id, const std::string &due_date) {
+  TodoistTask task;
+  task.id = id;
+  task.due_date = due_date;
+  return task;
+}
+
+TEST(TaskStoreReclassifyTest, ReclassifiesAtMidnight) {
+  TaskStore store;
+  store.reclassify(days_from_civil(2024, 3, 10), 23 * 60 + 59);
+  ASSERT_TRUE(store.add(make_due_task("a", "2024-03-10")));
+  ASSERT_TRUE(store.add(make_due_task("b", "2024-03-11")));
+  ASSERT_TRUE(store.add(make_due_task("c", "2024-03-12")));
+  EXPECT_TRUE(store[0].is_due_today());
+  EXPECT_TRUE(store[1].is_due_tomorrow());
+  EXPECT_EQ(store[2].due_class(), DUE_CLASS_LATER);
+
+  EXPECT_EQ(store.reclassify(days_from_civil(2024, 3, 11), 0), 3u);
+  EXPECT_TRUE(store[0].is_overdue());
+  EXPECT_TRUE(store[1].is_due_today());
+  EXPECT_TRUE(store[2].is_due_tomorrow());
+
+  // Nog een keer op hetzelfde moment verandert niets
+  EXPECT_EQ(store.reclassify(days_from_civil(2024, 3, 11), 0), 0u);
+}
+
+TEST(TaskStoreReclassifyTest, ATimedTaskBecomesOverdueAtItsMinute) {
+  TaskStore store;
+  int32_t today = days_from_civil(2024, 3, 10);
+  store.reclassify(today, 9 * 60);
+  ASSERT_TRUE(store.add(make_due_task("a", "2024-03-10T10:15")));
+  ASSERT_TRUE(store.add(make_due_task("b", "2024-03-10T09:30")));
+  ASSERT_TRUE(store.add(make_due_task("c", "2024-03-10")));
+  ASSERT_TRUE(store.add(make_due_task("d", "2024-03-11T08:00")));
+
+  // De eerstvolgende tijd vandaag, alleen van taken met een tijd
+  EXPECT_EQ(store.next_due_minute(), 9 * 60 + 30);
+  EXPECT_EQ(store.reclassify(today, 9 * 60 + 30), 1u);
+  EXPECT_TRUE(store[1].is_overdue());
+  EXPECT_EQ(store.next_due_minute(), 10 * 60 + 15);
+
+  EXPECT_EQ(store.reclassify(today, 10 * 60 + 15), 1u);
+  EXPECT_TRUE(store[0].is_overdue());
+  EXPECT_TRUE(store[2].is_due_today());
+  EXPECT_EQ(store.next_due_minute(), -1);
+}
+
+TEST(TaskStoreReclassifyTest, NewTasksUseTheStoreDay) {
+  TaskStore store;
+  store.reclassify(days_from_civil(2024, 3, 10), 0);
+  ASSERT_TRUE(store.add(make_due_task("a", "2024-03-10")));
+  EXPECT_TRUE(store[0].is_due_today());
+
+  // apply_changes houdt de dag van de store aan
+  TaskStore changes;
+  ASSERT_TRUE(changes.add(make_due_task("b", "2024-03-11")));
+  ASSERT_TRUE(store.apply_changes(changes, false));
+  EXPECT_EQ(store.today(), days_from_civil(2024, 3, 10));
+  EXPECT_TRUE(store[1].is_due_tomorrow());
+}
+
+}  // namespace todoist
+}  // namespace esphome
+
+// ---- id index en geïnterneerde project ids ----
+
+namespace esphome {
+namespace todoist {
+
+TEST(TaskStoreIndexTest, FindsEveryIdAndNothingElse) {
+  TaskStore store;
+  for (size_t i = 0; i < TaskStore::MAX_TASKS; i++)
+    ASSERT_TRUE(store.add(make_task(i * 7919)));
+  for (size_t i = 0; i < TaskStore::MAX_TASKS; i++)
+    ASSERT_EQ(store.find(std::to_string(7000000000ULL + i * 7919).c_str()), (int) i);
+  EXPECT_EQ(store.find("7000000001"), -1);
+  EXPECT_EQ(store.find(""), -1);
+  EXPECT_EQ(TaskStore().find("7000000000"), -1);
+}
+
+TEST(TaskStoreIndexTest, FollowsTheShiftAfterRemove) {
+  TaskStore store;
+  for (size_t i = 0; i < 20; i++)
+    ASSERT_TRUE(store.add(make_task(i)));
+  store.remove(5);
+  store.remove(0);
+  store.remove(100);  // Buiten bereik: niets
+  ASSERT_EQ(store.size(), 18u);
+  EXPECT_EQ(store.find("7000000000"), -1);
+  EXPECT_EQ(store.find("7000000005"), -1);
+  EXPECT_EQ(store.find("7000000001"), 0);
+  EXPECT_EQ(store.find("7000000006"), 4);
+  EXPECT_EQ(store.find("7000000019"), 17);
+}
+
+TEST(TaskStoreIndexTest, SharesOneCopyOfAProjectId) {
+  InspectableStore store;
+  ASSERT_TRUE(store.add(make_task(0, "2300000001")));
+  size_t used = store.arena_size_;
+  // Even index: zonder beschrijving
+  TodoistTask task = make_task(2, "2300000001");
+  ASSERT_TRUE(store.add(task));
+  // Alleen id, content en due string van de tweede taak
+  EXPECT_EQ(store.arena_size_ - used, task.id.size() + task.content.size() + task.due_string.size() + 3);
+  EXPECT_EQ(store.records_[0].project_id, store.records_[1].project_id);
+
+  ASSERT_TRUE(store.add(make_task(4, "2300000002")));
+  EXPECT_NE(store.records_[2].project_id, store.records_[0].project_id);
+  EXPECT_STREQ(store[2].project_id(), "2300000002");
+}
+
+TEST(TaskStoreIndexTest, InternsManyProjectsAcrossIndexGrowth) {
+  TaskStore store;
+  for (size_t i = 0; i < 300; i++)
+    ASSERT_TRUE(store.add(make_task(i, std::to_string(2300000000ULL + i % 150))));
+  for (size_t i = 0; i < 300; i++)
+    ASSERT_EQ(std::string(store[i].project_id()), std::to_string(2300000000ULL + i % 150));
+}
+
+// Regressie: rebuild_index_ na remove voegde elk project id opnieuw aan de arena toe, via een
+// pointer in de arena die bij het groeien ongeldig kon worden
+TEST(TaskStoreIndexTest, RemoveDoesNotGrowTheArena) {
+  InspectableStore store;
+  for (size_t i = 0; i < 100; i++)
+    ASSERT_TRUE(store.add(make_task(i, std::to_string(2300000000ULL + i % 7))));
+  size_t used = store.arena_size_;
+  for (size_t i = 0; i < 50; i++)
+    store.remove(store.size() - 1);
+  EXPECT_EQ(store.arena_size_, used);
+  for (size_t i = 0; i < 50; i++)
+    ASSERT_EQ(std::string(store[i].project_id()), std::to_string(2300000000ULL + i % 7));
+
+  // Een bestaand project wordt na remove nog steeds gedeeld
+  size_t before = store.arena_size_;
+  TodoistTask task = make_task(500, "2300000003");
+  ASSERT_TRUE(store.add(task));
+  EXPECT_EQ(store.arena_size_ - before, task.id.size() + task.content.size() + task.due_string.size() + 3);
+  EXPECT_STREQ(store[50].project_id(), "2300000003");
+  EXPECT_EQ(store.find(task.id.c_str()), 50);
+}
+
+TEST(TaskStoreIndexTest, KeepsTheIndexAcrossMoveAndClear) {
+  TaskStore source;
+  for (size_t i = 0; i < 40; i++)
+    ASSERT_TRUE(source.add(make_task(i)));
+  TaskStore moved(std::move(source));
+  EXPECT_EQ(moved.find("7000000039"), 39);
+  EXPECT_EQ(source.find("7000000039"), -1);  // NOLINT(bugprone-use-after-move)
+
+  moved.clear();
+  EXPECT_EQ(moved.find("7000000039"), -1);
+  ASSERT_TRUE(moved.add(make_task(39)));
+  EXPECT_EQ(moved.find("7000000039"), 0);
+}
+
+}  // namespace todoist
+}  // namespace esphome